@@ -1,115 +1,454 @@
 use std::{
-    collections::HashMap,
+    collections::{BTreeMap, HashMap},
     fmt::Write as _,
-    fs, io,
+    fs, io, mem,
     path::{Path, PathBuf},
-    sync::{Arc, Mutex, OnceLock},
+    sync::{Arc, Condvar, Mutex, OnceLock},
     time::{Duration, SystemTime},
 };
 
 use anyhow::{Context, Result};
-use geo::mesh::Mesh;
+use geo::mesh::{Dot, Lin, Mesh, Tri};
 use sha2::{Digest, Sha256};
 
 use crate::{
-    svg,
-    types::{BackendKind, LatexBackendConfig, RenderQuality, RenderedOutput},
+    mesh_file, svg,
+    types::{BackendKind, LatexBackendConfig, MemoryCacheStats, RenderQuality, RenderedOutput},
 };
 
 const SYSTEM_SVG_UNITS_AT_SCALE_1: f32 = 36.0;
+// curves are flattened to a tolerance in rendered units, so meshes are cached
+// per band of scales: every band is tessellated once at its top scale, which
+// is never coarser than a scale inside it, and scaled down to the requested one
+const SCALE_BUCKETS_PER_DOUBLING: f32 = 4.0;
 const LATEX_SVG_CACHE_VERSION: &[u8] = b"monocurl-latex-svg-cache-v1";
+const LATEX_MESH_CACHE_VERSION: &[u8] = b"monocurl-latex-mesh-cache-v1";
+const MEMORY_CACHE_SHARDS: usize = 16;
+const MEMORY_CACHE_MAX_BYTES: usize = 256 << 20;
 const LATEX_SVG_FILE_CACHE_MAX_AGE_DAYS: u64 = 30;
 const LATEX_SVG_FILE_CACHE_MAX_AGE: Duration =
     Duration::from_secs(60 * 60 * 24 * LATEX_SVG_FILE_CACHE_MAX_AGE_DAYS);
 
-#[derive(Clone, Debug, Eq, Hash, PartialEq)]
-struct CacheKey {
-    backend: BackendKind,
-    backend_config: LatexBackendConfig,
-    source: String,
-    scale_bits: u32,
-    quality: RenderQuality,
+// the first 128 bits of a sha-256 over everything that selects a render, so
+// entries don't keep every formula's source alive
+#[derive(Clone, Copy, Debug, Eq, Hash, Ord, PartialEq, PartialOrd)]
+struct CacheKey(u128);
+
+impl CacheKey {
+    fn new(
+        backend: BackendKind,
+        backend_config: &LatexBackendConfig,
+        source: &str,
+        scale_bucket: i32,
+        quality: RenderQuality,
+    ) -> Self {
+        let mut hasher = Sha256::new();
+        let backend: &[u8] = match backend {
+            BackendKind::Text => b"text",
+            BackendKind::Tex => b"tex",
+            BackendKind::Latex => b"latex",
+        };
+        hash_field(&mut hasher, b"kind", backend);
+        hash_backend_config(&mut hasher, backend_config);
+        hash_field(&mut hasher, b"source", source.as_bytes());
+        hash_field(&mut hasher, b"scale_bucket", &scale_bucket.to_le_bytes());
+        hash_field(&mut hasher, b"quality", quality_label(quality));
+        let digest = hasher.finalize();
+        Self(u128::from_le_bytes(digest[..16].try_into().unwrap()))
+    }
 }
 
 #[derive(Clone)]
 struct CacheEntry {
+    // the scale the meshes were tessellated at
+    scale: f32,
     meshes: Arc<Vec<Arc<Mesh>>>,
     span_mesh_indices: Arc<HashMap<String, Vec<usize>>>,
 }
 
-static CACHE: OnceLock<Mutex<HashMap<CacheKey, CacheEntry>>> = OnceLock::new();
+impl CacheEntry {
+    fn new(rendered: svg::RenderedSvg, scale: f32) -> Self {
+        Self {
+            scale,
+            meshes: Arc::new(rendered.meshes.into_iter().map(Arc::new).collect()),
+            span_mesh_indices: Arc::new(rendered.span_mesh_indices),
+        }
+    }
+
+    // what the entry keeps alive, counted by element capacity
+    fn bytes(&self) -> usize {
+        let meshes: usize = self
+            .meshes
+            .iter()
+            .map(|mesh| {
+                mem::size_of::<Mesh>()
+                    + mesh.dots.capacity() * mem::size_of::<Dot>()
+                    + mesh.lins.capacity() * mem::size_of::<Lin>()
+                    + mesh.tris.capacity() * mem::size_of::<Tri>()
+                    + mesh.tag.capacity() * mem::size_of::<isize>()
+            })
+            .sum();
+        let spans: usize = self
+            .span_mesh_indices
+            .iter()
+            .map(|(name, indices)| name.capacity() + indices.capacity() * mem::size_of::<usize>())
+            .sum();
+        mem::size_of::<Self>() + meshes + spans
+    }
+
+    fn output_at(&self, scale: f32) -> RenderedOutput {
+        let meshes = if scale.to_bits() == self.scale.to_bits() {
+            self.meshes.iter().cloned().collect()
+        } else {
+            let factor = scale / self.scale;
+            self.meshes
+                .iter()
+                .map(|mesh| Arc::new(scaled_mesh(mesh, factor)))
+                .collect()
+        };
+        RenderedOutput {
+            meshes,
+            span_mesh_indices: (*self.span_mesh_indices).clone(),
+        }
+    }
+}
+
+// an lru over rendered formulas, bounded by the bytes their meshes hold and
+// split into independently locked shards by key. a miss leaves a pending slot
+// behind, so concurrent requests for the same formula wait for one render
+// instead of starting their own
+struct MemoryCache {
+    shards: Vec<Mutex<Shard>>,
+    shard_max_bytes: usize,
+}
+
+#[derive(Default)]
+struct Shard {
+    slots: HashMap<CacheKey, Slot>,
+    // last use tick of every ready slot, oldest first
+    recency: BTreeMap<u64, CacheKey>,
+    tick: u64,
+    bytes: usize,
+    hits: u64,
+    misses: u64,
+    evictions: u64,
+}
+
+enum Slot {
+    Ready {
+        entry: CacheEntry,
+        bytes: usize,
+        last_used: u64,
+    },
+    Pending(Arc<Flight>),
+}
+
+enum Lookup {
+    Ready(CacheEntry),
+    Wait(Arc<Flight>),
+    Render(Arc<Flight>),
+}
+
+// the outcome of one in-flight render; None once it failed, in which case the
+// waiters look the key up again
+#[derive(Default)]
+struct Flight {
+    result: Mutex<Option<Option<CacheEntry>>>,
+    done: Condvar,
+}
+
+impl Flight {
+    fn complete(&self, entry: Option<CacheEntry>) {
+        *self.result.lock().unwrap() = Some(entry);
+        self.done.notify_all();
+    }
+
+    fn wait(&self) -> Option<CacheEntry> {
+        let mut result = self.result.lock().unwrap();
+        loop {
+            if let Some(entry) = &*result {
+                return entry.clone();
+            }
+            result = self.done.wait(result).unwrap();
+        }
+    }
+}
+
+// owned by the thread rendering a miss; dropping it without finishing, on an
+// error or a panic inside the render, releases the key for the waiters
+struct Leader<'a> {
+    shard: &'a Mutex<Shard>,
+    shard_max_bytes: usize,
+    key: CacheKey,
+    flight: Arc<Flight>,
+    finished: bool,
+}
+
+impl Leader<'_> {
+    fn finish(mut self, entry: CacheEntry) {
+        self.shard.lock().unwrap().store(
+            self.key,
+            &self.flight,
+            entry.clone(),
+            self.shard_max_bytes,
+        );
+        self.flight.complete(Some(entry));
+        self.finished = true;
+    }
+}
+
+impl Drop for Leader<'_> {
+    fn drop(&mut self) {
+        if self.finished {
+            return;
+        }
+        if let Ok(mut shard) = self.shard.lock() {
+            shard.abandon(self.key, &self.flight);
+        }
+        self.flight.complete(None);
+    }
+}
+
+impl MemoryCache {
+    fn new(max_bytes: usize) -> Self {
+        Self {
+            shards: (0..MEMORY_CACHE_SHARDS)
+                .map(|_| Mutex::new(Shard::default()))
+                .collect(),
+            shard_max_bytes: max_bytes / MEMORY_CACHE_SHARDS,
+        }
+    }
+
+    fn get_or_render<F>(&self, key: CacheKey, render: F) -> Result<CacheEntry>
+    where
+        F: FnOnce() -> Result<CacheEntry>,
+    {
+        let shard = &self.shards[key.0 as usize % self.shards.len()];
+        loop {
+            let lookup = shard.lock().unwrap().lookup(key);
+            match lookup {
+                Lookup::Ready(entry) => return Ok(entry),
+                Lookup::Wait(flight) => {
+                    if let Some(entry) = flight.wait() {
+                        return Ok(entry);
+                    }
+                }
+                Lookup::Render(flight) => {
+                    let leader = Leader {
+                        shard,
+                        shard_max_bytes: self.shard_max_bytes,
+                        key,
+                        flight,
+                        finished: false,
+                    };
+                    let entry = render()?;
+                    leader.finish(entry.clone());
+                    return Ok(entry);
+                }
+            }
+        }
+    }
+
+    fn clear(&self) {
+        for shard in &self.shards {
+            shard.lock().unwrap().clear();
+        }
+    }
+
+    fn stats(&self) -> MemoryCacheStats {
+        let mut stats = MemoryCacheStats::default();
+        for shard in &self.shards {
+            let shard = shard.lock().unwrap();
+            stats.hits += shard.hits;
+            stats.misses += shard.misses;
+            stats.evictions += shard.evictions;
+            stats.bytes += shard.bytes;
+            stats.entries += shard.recency.len();
+        }
+        stats
+    }
+}
+
+impl Shard {
+    fn lookup(&mut self, key: CacheKey) -> Lookup {
+        match self.slots.get_mut(&key) {
+            Some(Slot::Ready {
+                entry, last_used, ..
+            }) => {
+                self.recency.remove(last_used);
+                self.tick += 1;
+                *last_used = self.tick;
+                self.recency.insert(self.tick, key);
+                self.hits += 1;
+                Lookup::Ready(entry.clone())
+            }
+            // joining a render that is already running counts as a hit
+            Some(Slot::Pending(flight)) => {
+                self.hits += 1;
+                Lookup::Wait(flight.clone())
+            }
+            None => {
+                self.misses += 1;
+                let flight = Arc::new(Flight::default());
+                self.slots.insert(key, Slot::Pending(flight.clone()));
+                Lookup::Render(flight)
+            }
+        }
+    }
+
+    fn store(&mut self, key: CacheKey, flight: &Arc<Flight>, entry: CacheEntry, max_bytes: usize) {
+        // the slot is gone if the cache was cleared during the render
+        if !matches!(self.slots.get(&key), Some(Slot::Pending(pending)) if Arc::ptr_eq(pending, flight))
+        {
+            return;
+        }
+        let bytes = entry.bytes();
+        if bytes > max_bytes {
+            self.slots.remove(&key);
+            self.evictions += 1;
+            return;
+        }
+
+        self.tick += 1;
+        self.recency.insert(self.tick, key);
+        self.slots.insert(
+            key,
+            Slot::Ready {
+                entry,
+                bytes,
+                last_used: self.tick,
+            },
+        );
+        self.bytes += bytes;
+
+        while self.bytes > max_bytes {
+            let Some((_, oldest)) = self.recency.pop_first() else {
+                break;
+            };
+            if let Some(Slot::Ready { bytes, .. }) = self.slots.remove(&oldest) {
+                self.bytes -= bytes;
+                self.evictions += 1;
+            }
+        }
+    }
+
+    fn abandon(&mut self, key: CacheKey, flight: &Arc<Flight>) {
+        if matches!(self.slots.get(&key), Some(Slot::Pending(pending)) if Arc::ptr_eq(pending, flight))
+        {
+            self.slots.remove(&key);
+        }
+    }
+
+    // renders still running hand their result to the threads already waiting
+    // on them, but it is no longer stored
+    fn clear(&mut self) {
+        self.slots.clear();
+        self.recency.clear();
+        self.bytes = 0;
+    }
+}
+
+static CACHE: OnceLock<MemoryCache> = OnceLock::new();
 
 pub(crate) fn clear_memory_cache() {
-    cache().lock().unwrap().clear();
+    cache().clear();
+}
+
+pub fn memory_cache_stats() -> MemoryCacheStats {
+    cache().stats()
 }
 
 pub fn clean_stale_file_cache() -> Result<usize> {
     let cutoff = SystemTime::now()
         .checked_sub(LATEX_SVG_FILE_CACHE_MAX_AGE)
         .unwrap_or(SystemTime::UNIX_EPOCH);
-    clean_latex_svg_file_cache_before(&latex_svg_cache_root(), cutoff)
+    Ok(
+        clean_latex_file_cache_before(&latex_svg_cache_root(), cutoff)?
+            + clean_latex_file_cache_before(&latex_mesh_cache_root(), cutoff)?,
+    )
 }
 
 pub(crate) fn render_cached<F>(
     backend: BackendKind,
-    backend_config: LatexBackendConfig,
+    backend_config: &LatexBackendConfig,
     source: String,
     scale: f32,
     quality: RenderQuality,
     render: F,
 ) -> Result<RenderedOutput>
 where
-    F: FnOnce(String) -> Result<svg::RenderedSvg>,
+    F: FnOnce(String, i32) -> Result<svg::RenderedSvg>,
 {
-    let key = CacheKey {
-        backend,
-        backend_config,
-        source: source.clone(),
-        scale_bits: scale.to_bits(),
-        quality,
-    };
-
-    if let Some(entry) = cache().lock().unwrap().get(&key).cloned() {
-        return Ok(RenderedOutput {
-            meshes: entry.meshes.iter().cloned().collect(),
-            span_mesh_indices: (*entry.span_mesh_indices).clone(),
-        });
-    }
+    let scale_bucket = scale_bucket(scale);
+    let key = CacheKey::new(backend, backend_config, &source, scale_bucket, quality);
+    let entry = cache().get_or_render(key, || {
+        let rendered = render(source, scale_bucket)?;
+        Ok(CacheEntry::new(rendered, bucket_scale(scale_bucket)))
+    })?;
+    Ok(entry.output_at(scale))
+}
 
-    let rendered = render(source)?;
-    let entry = CacheEntry {
-        meshes: Arc::new(rendered.meshes.into_iter().map(Arc::new).collect()),
-        span_mesh_indices: Arc::new(rendered.span_mesh_indices),
-    };
+fn scale_bucket(scale: f32) -> i32 {
+    (scale.log2() * SCALE_BUCKETS_PER_DOUBLING).ceil() as i32
+}
 
-    cache().lock().unwrap().insert(key, entry.clone());
+fn bucket_scale(bucket: i32) -> f32 {
+    (bucket as f32 / SCALE_BUCKETS_PER_DOUBLING).exp2()
+}
 
-    Ok(RenderedOutput {
-        meshes: entry.meshes.iter().cloned().collect(),
-        span_mesh_indices: (*entry.span_mesh_indices).clone(),
-    })
+// glyph geometry is linear in the scale; stroke radii are in screen units and
+// the import gives every scale the same one, so uniforms carry over as they are
+fn scaled_mesh(mesh: &Mesh, factor: f32) -> Mesh {
+    let mut scaled = mesh.clone();
+    for dot in &mut scaled.dots {
+        dot.pos = dot.pos * factor;
+    }
+    for lin in &mut scaled.lins {
+        lin.a.pos = lin.a.pos * factor;
+        lin.b.pos = lin.b.pos * factor;
+    }
+    for tri in &mut scaled.tris {
+        tri.a.pos = tri.a.pos * factor;
+        tri.b.pos = tri.b.pos * factor;
+        tri.c.pos = tri.c.pos * factor;
+    }
+    scaled
 }
 
 pub(crate) fn render_svg_with_file_cache<F>(
     backend_config: &LatexBackendConfig,
     source: &str,
-    scale: f32,
+    scale_bucket: i32,
     quality: RenderQuality,
     render_svg: F,
 ) -> Result<svg::RenderedSvg>
 where
     F: FnOnce(&str) -> Result<String>,
 {
-    let cache_path = latex_svg_cache_path(backend_config, source);
-    if let Ok(svg_source) = fs::read_to_string(&cache_path) {
-        if let Ok(rendered) = import_latex_svg(&svg_source, scale, quality) {
-            return Ok(rendered);
-        }
+    let svg_hash = latex_svg_cache_hash(backend_config, source);
+    let mesh_path =
+        latex_mesh_cache_path_for_hash(&latex_mesh_cache_hash(&svg_hash, scale_bucket, quality));
+    if let Ok(bytes) = fs::read(&mesh_path)
+        && let Some(rendered) = mesh_file::decode(&bytes)
+    {
+        return Ok(rendered);
     }
 
-    let svg_source = render_svg(source)?;
-    let rendered = import_latex_svg(&svg_source, scale, quality)?;
-    write_latex_svg_file_cache(&cache_path, &svg_source);
+    let scale = bucket_scale(scale_bucket);
+    let svg_path = latex_svg_cache_path_for_hash(&svg_hash);
+    let cached_import = fs::read_to_string(&svg_path)
+        .ok()
+        .and_then(|svg_source| import_latex_svg(&svg_source, scale, quality).ok());
+    let rendered = match cached_import {
+        Some(rendered) => rendered,
+        None => {
+            let svg_source = render_svg(source)?;
+            let rendered = import_latex_svg(&svg_source, scale, quality)?;
+            write_latex_file_cache(&svg_path, svg_source.as_bytes());
+            rendered
+        }
+    };
+    write_latex_file_cache(&mesh_path, &mesh_file::encode(&rendered));
     Ok(rendered)
 }
 
@@ -125,10 +464,6 @@ fn import_latex_svg(
     )
 }
 
-fn latex_svg_cache_path(backend_config: &LatexBackendConfig, source: &str) -> PathBuf {
-    latex_svg_cache_path_for_hash(&latex_svg_cache_hash(backend_config, source))
-}
-
 fn latex_svg_cache_path_for_hash(hash: &str) -> PathBuf {
     let (dir, file) = hash.split_at(2);
     latex_svg_cache_root().join(dir).join(format!("{file}.svg"))
@@ -138,43 +473,47 @@ fn latex_svg_cache_root() -> PathBuf {
     std::env::temp_dir().join("monocurl").join("latex_svg")
 }
 
-fn clean_latex_svg_file_cache_before(root: &Path, cutoff: SystemTime) -> Result<usize> {
+fn latex_mesh_cache_path_for_hash(hash: &str) -> PathBuf {
+    let (dir, file) = hash.split_at(2);
+    latex_mesh_cache_root()
+        .join(dir)
+        .join(format!("{file}.mesh"))
+}
+
+fn latex_mesh_cache_root() -> PathBuf {
+    std::env::temp_dir().join("monocurl").join("latex_mesh")
+}
+
+fn clean_latex_file_cache_before(root: &Path, cutoff: SystemTime) -> Result<usize> {
     let entries = match fs::read_dir(root) {
         Ok(entries) => entries,
         Err(error) if error.kind() == io::ErrorKind::NotFound => return Ok(0),
         Err(error) => {
-            return Err(error).with_context(|| {
-                format!("failed to read LaTeX SVG cache root {}", root.display())
-            });
+            return Err(error)
+                .with_context(|| format!("failed to read LaTeX cache root {}", root.display()));
         }
     };
 
     let mut removed = 0;
     for entry in entries {
         let entry = entry.with_context(|| {
-            format!(
-                "failed to read LaTeX SVG cache entry under {}",
-                root.display()
-            )
+            format!("failed to read LaTeX cache entry under {}", root.display())
         })?;
         let path = entry.path();
-        let file_type = entry.file_type().with_context(|| {
-            format!("failed to inspect LaTeX SVG cache entry {}", path.display())
-        })?;
+        let file_type = entry
+            .file_type()
+            .with_context(|| format!("failed to inspect LaTeX cache entry {}", path.display()))?;
 
         if file_type.is_dir() {
-            removed += clean_latex_svg_file_cache_before(&path, cutoff)?;
+            removed += clean_latex_file_cache_before(&path, cutoff)?;
             remove_empty_cache_dir(&path);
-        } else if file_type.is_file() && is_latex_svg_cache_file(&path) {
+        } else if file_type.is_file() && is_latex_cache_file(&path) {
             let metadata = entry.metadata().with_context(|| {
-                format!("failed to inspect LaTeX SVG cache file {}", path.display())
+                format!("failed to inspect LaTeX cache file {}", path.display())
             })?;
             if metadata.modified().is_ok_and(|modified| modified < cutoff) {
                 fs::remove_file(&path).with_context(|| {
-                    format!(
-                        "failed to remove stale LaTeX SVG cache file {}",
-                        path.display()
-                    )
+                    format!("failed to remove stale LaTeX cache file {}", path.display())
                 })?;
                 removed += 1;
             }
@@ -184,8 +523,11 @@ fn clean_latex_svg_file_cache_before(root: &Path, cutoff: SystemTime) -> Result<
     Ok(removed)
 }
 
-fn is_latex_svg_cache_file(path: &Path) -> bool {
-    path.extension().and_then(|extension| extension.to_str()) == Some("svg")
+fn is_latex_cache_file(path: &Path) -> bool {
+    matches!(
+        path.extension().and_then(|extension| extension.to_str()),
+        Some("svg" | "mesh")
+    )
 }
 
 fn remove_empty_cache_dir(path: &Path) {
@@ -197,7 +539,29 @@ fn latex_svg_cache_hash(backend_config: &LatexBackendConfig, source: &str) -> St
     hash_field(&mut hasher, b"version", LATEX_SVG_CACHE_VERSION);
     hash_backend_config(&mut hasher, backend_config);
     hash_field(&mut hasher, b"source", source.as_bytes());
+    hex_digest(hasher)
+}
+
+// the tessellated meshes of one svg depend on the bucket it was imported at,
+// the curve sampling and whatever the importer and tessellator currently emit
+fn latex_mesh_cache_hash(svg_hash: &str, scale_bucket: i32, quality: RenderQuality) -> String {
+    let mut hasher = Sha256::new();
+    hash_field(&mut hasher, b"version", LATEX_MESH_CACHE_VERSION);
+    hash_field(&mut hasher, b"import", &svg::IMPORT_VERSION.to_le_bytes());
+    hash_field(&mut hasher, b"svg", svg_hash.as_bytes());
+    hash_field(&mut hasher, b"scale_bucket", &scale_bucket.to_le_bytes());
+    hash_field(&mut hasher, b"quality", quality_label(quality));
+    hex_digest(hasher)
+}
 
+fn quality_label(quality: RenderQuality) -> &'static [u8] {
+    match quality {
+        RenderQuality::Normal => b"normal",
+        RenderQuality::High => b"high",
+    }
+}
+
+fn hex_digest(hasher: Sha256) -> String {
     let digest = hasher.finalize();
     let mut out = String::with_capacity(digest.len() * 2);
     for byte in digest {
@@ -228,17 +592,17 @@ fn hash_field(hasher: &mut Sha256, label: &[u8], value: &[u8]) {
     hasher.update(value);
 }
 
-fn write_latex_svg_file_cache(path: &Path, svg_source: &str) {
+fn write_latex_file_cache(path: &Path, contents: &[u8]) {
     let Some(parent) = path.parent() else {
         return;
     };
     if fs::create_dir_all(parent).is_ok() {
-        let _ = fs::write(path, svg_source);
+        let _ = fs::write(path, contents);
     }
 }
 
-fn cache() -> &'static Mutex<HashMap<CacheKey, CacheEntry>> {
-    CACHE.get_or_init(|| Mutex::new(HashMap::new()))
+fn cache() -> &'static MemoryCache {
+    CACHE.get_or_init(|| MemoryCache::new(MEMORY_CACHE_MAX_BYTES))
 }
 
 fn svg_import_options(quality: RenderQuality, flip_y: bool) -> svg::ImportOptions {
@@ -254,10 +618,21 @@ fn svg_import_options(quality: RenderQuality, flip_y: bool) -> svg::ImportOption
 #[cfg(test)]
 mod tests {
     use std::{
+        cell::Cell,
         path::PathBuf,
+        sync::{
+            Barrier,
+            atomic::{AtomicUsize, Ordering},
+        },
+        thread,
         time::{Duration, SystemTime},
     };
 
+    use geo::{
+        mesh::{Dot, Uniforms},
+        simd::{Float3, Float4},
+    };
+
     use super::*;
 
     fn test_cache_root(name: &str) -> PathBuf {
@@ -315,6 +690,36 @@ mod tests {
         assert_eq!(root.and_then(|name| name.to_str()), Some("latex_svg"));
     }
 
+    #[test]
+    fn latex_mesh_cache_keys_follow_bucket_and_quality() {
+        let svg_hash = latex_svg_cache_hash(&LatexBackendConfig::Bundled, "x + y");
+        let hash = latex_mesh_cache_hash(&svg_hash, 2, RenderQuality::Normal);
+        assert_eq!(hash.len(), 64);
+        assert_eq!(
+            hash,
+            latex_mesh_cache_hash(&svg_hash, 2, RenderQuality::Normal)
+        );
+        assert_ne!(
+            hash,
+            latex_mesh_cache_hash(&svg_hash, 3, RenderQuality::Normal)
+        );
+        assert_ne!(
+            hash,
+            latex_mesh_cache_hash(&svg_hash, 2, RenderQuality::High)
+        );
+
+        let path = latex_mesh_cache_path_for_hash("abcdef");
+        assert_eq!(
+            path.file_name().and_then(|name| name.to_str()),
+            Some("cdef.mesh")
+        );
+        let root = path
+            .parent()
+            .and_then(|path| path.parent())
+            .and_then(|path| path.file_name());
+        assert_eq!(root.and_then(|name| name.to_str()), Some("latex_mesh"));
+    }
+
     #[test]
     fn clean_latex_svg_file_cache_removes_svg_files_before_cutoff() {
         let root = test_cache_root("remove");
@@ -324,15 +729,18 @@ mod tests {
         fs::create_dir_all(&mixed_dir).unwrap();
 
         let stale_svg = stale_dir.join("cdef.svg");
+        let stale_mesh = stale_dir.join("0123.mesh");
         let stale_text = mixed_dir.join("keep.txt");
         fs::write(&stale_svg, "<svg/>").unwrap();
+        fs::write(&stale_mesh, "MCLXMESH").unwrap();
         fs::write(&stale_text, "not cache").unwrap();
 
         let cutoff = SystemTime::now() + Duration::from_secs(60);
-        let removed = clean_latex_svg_file_cache_before(&root, cutoff).unwrap();
+        let removed = clean_latex_file_cache_before(&root, cutoff).unwrap();
 
-        assert_eq!(removed, 1);
+        assert_eq!(removed, 2);
         assert!(!stale_svg.exists());
+        assert!(!stale_mesh.exists());
         assert!(!stale_dir.exists());
         assert!(stale_text.exists());
 
@@ -348,7 +756,7 @@ mod tests {
         let fresh_svg = cache_dir.join("cdef.svg");
         fs::write(&fresh_svg, "<svg/>").unwrap();
 
-        let removed = clean_latex_svg_file_cache_before(&root, SystemTime::UNIX_EPOCH).unwrap();
+        let removed = clean_latex_file_cache_before(&root, SystemTime::UNIX_EPOCH).unwrap();
 
         assert_eq!(removed, 0);
         assert!(fresh_svg.exists());
@@ -356,12 +764,157 @@ mod tests {
         let _ = fs::remove_dir_all(root);
     }
 
+    fn dot_mesh(position: Float3) -> Mesh {
+        Mesh {
+            dots: vec![Dot {
+                pos: position,
+                norm: Float3::Z,
+                col: Float4::new(0.0, 0.0, 0.0, 1.0),
+                inv: -1,
+                is_dom_sib: false,
+            }],
+            lins: Vec::new(),
+            tris: Vec::new(),
+            uniform: Uniforms::default(),
+            tag: Vec::new(),
+            version: Mesh::fresh_version(),
+        }
+    }
+
+    #[test]
+    fn scales_in_one_bucket_share_a_tessellation() {
+        let renders = Cell::new(0);
+        let render_at = |scale: f32| {
+            render_cached(
+                BackendKind::Tex,
+                &LatexBackendConfig::Bundled,
+                "scales_in_one_bucket_share_a_tessellation".into(),
+                scale,
+                RenderQuality::Normal,
+                |_, scale_bucket| {
+                    let bucket_scale = bucket_scale(scale_bucket);
+                    renders.set(renders.get() + 1);
+                    Ok(svg::RenderedSvg {
+                        meshes: vec![dot_mesh(Float3::new(bucket_scale, 2.0 * bucket_scale, 0.0))],
+                        span_mesh_indices: HashMap::new(),
+                    })
+                },
+            )
+            .unwrap()
+        };
+
+        // 1.05 and 1.1 both round up to the 2^(1/4) bucket, 1.0 is its own
+        let first = render_at(1.05);
+        let second = render_at(1.1);
+        assert_eq!(renders.get(), 1);
+        let expected = [(&first, 1.05), (&second, 1.1)];
+        for (output, scale) in expected {
+            let position = output.meshes[0].dots[0].pos;
+            assert!((position.x - scale).abs() < 1e-5);
+            assert!((position.y - 2.0 * scale).abs() < 1e-5);
+        }
+
+        let exact = render_at(1.0);
+        assert_eq!(renders.get(), 2);
+        assert_eq!(exact.meshes[0].dots[0].pos, Float3::new(1.0, 2.0, 0.0));
+    }
+
+    fn entry_at(x: f32) -> CacheEntry {
+        CacheEntry::new(
+            svg::RenderedSvg {
+                meshes: vec![dot_mesh(Float3::new(x, 0.0, 0.0))],
+                span_mesh_indices: HashMap::new(),
+            },
+            1.0,
+        )
+    }
+
+    #[test]
+    fn memory_cache_evicts_least_recently_used_entries() {
+        let bytes = entry_at(0.0).bytes();
+        // room for two entries in every shard
+        let cache = MemoryCache::new(MEMORY_CACHE_SHARDS * (2 * bytes + bytes / 2));
+        let renders = Cell::new(0);
+        let get = |n: u128| {
+            // keys that land in the same shard
+            let key = CacheKey(n * MEMORY_CACHE_SHARDS as u128);
+            let entry = cache
+                .get_or_render(key, || {
+                    renders.set(renders.get() + 1);
+                    Ok(entry_at(n as f32))
+                })
+                .unwrap();
+            assert_eq!(entry.meshes[0].dots[0].pos.x, n as f32);
+        };
+
+        get(0);
+        get(1);
+        get(0);
+        get(2);
+        assert_eq!(renders.get(), 3);
+        get(0);
+        get(2);
+        assert_eq!(renders.get(), 3);
+        get(1);
+        assert_eq!(renders.get(), 4);
+
+        assert_eq!(
+            cache.stats(),
+            MemoryCacheStats {
+                hits: 3,
+                misses: 4,
+                evictions: 2,
+                bytes: 2 * bytes,
+                entries: 2,
+            }
+        );
+    }
+
+    #[test]
+    fn concurrent_misses_share_one_render() {
+        let cache = MemoryCache::new(MEMORY_CACHE_MAX_BYTES);
+        let renders = AtomicUsize::new(0);
+        let barrier = Barrier::new(8);
+        thread::scope(|scope| {
+            for _ in 0..8 {
+                scope.spawn(|| {
+                    barrier.wait();
+                    let entry = cache
+                        .get_or_render(CacheKey(7), || {
+                            renders.fetch_add(1, Ordering::Relaxed);
+                            thread::sleep(Duration::from_millis(50));
+                            Ok(entry_at(7.0))
+                        })
+                        .unwrap();
+                    assert_eq!(entry.meshes[0].dots[0].pos.x, 7.0);
+                });
+            }
+        });
+
+        assert_eq!(renders.load(Ordering::Relaxed), 1);
+        let stats = cache.stats();
+        assert_eq!((stats.hits, stats.misses, stats.entries), (7, 1, 1));
+    }
+
+    #[test]
+    fn failed_renders_are_not_cached() {
+        let cache = MemoryCache::new(MEMORY_CACHE_MAX_BYTES);
+        let failed = cache.get_or_render(CacheKey(3), || Err(anyhow::anyhow!("no backend")));
+        assert!(failed.is_err());
+
+        let entry = cache
+            .get_or_render(CacheKey(3), || Ok(entry_at(3.0)))
+            .unwrap();
+        assert_eq!(entry.meshes[0].dots[0].pos.x, 3.0);
+        assert_eq!(cache.stats().misses, 2);
+    }
+
     #[test]
     fn clean_latex_svg_file_cache_missing_root_is_noop() {
         let root = test_cache_root("missing");
         fs::remove_dir_all(&root).unwrap();
 
-        let removed = clean_latex_svg_file_cache_before(&root, SystemTime::now()).unwrap();
+        let removed = clean_latex_file_cache_before(&root, SystemTime::now()).unwrap();
 
         assert_eq!(removed, 0);
     }
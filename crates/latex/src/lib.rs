@@ -1,14 +1,17 @@
 mod cache;
 mod config;
 mod document;
+mod mesh_file;
 mod number;
 mod render;
+mod stroke;
 mod svg;
+mod svg_subset;
 mod system;
 mod tectonic;
 mod types;
 
-pub use cache::clean_stale_file_cache;
+pub use cache::{clean_stale_file_cache, memory_cache_stats};
 pub use config::{
     backend_config, discover_system_backend, set_backend_config, system_backend_status,
 };
@@ -21,6 +24,6 @@ pub use render::{
     render_tex_marked_with_quality, render_tex_with_quality, render_text, render_text_with_quality,
 };
 pub use types::{
-    LatexBackendConfig, RenderQuality, RenderedOutput, SystemBackendConfig, SystemBackendStatus,
-    SystemToolPaths,
+    LatexBackendConfig, MemoryCacheStats, RenderQuality, RenderedOutput, SystemBackendConfig,
+    SystemBackendStatus, SystemToolPaths,
 };
@@ -0,0 +1,542 @@
+use std::{collections::HashMap, path::PathBuf};
+
+use geo::{
+    mesh::{Dot, Lin, LinVertex, Mesh, Tri, TriVertex, Uniforms},
+    simd::{Float2, Float3, Float4},
+};
+
+use crate::svg::RenderedSvg;
+
+// little-endian, a fixed-size record per dot, lin and tri so the element
+// arrays can be read in place:
+//
+//   magic, format version, mesh count, then per mesh
+//     uniforms, tag count + tags, dot/lin/tri counts + records
+//   span count, then per span name length + name, index count + indices
+const MAGIC: &[u8; 8] = b"MCLXMESH";
+const FORMAT_VERSION: u32 = 1;
+
+pub(crate) fn encode(rendered: &RenderedSvg) -> Vec<u8> {
+    let mut out = Writer(Vec::with_capacity(encoded_len_hint(rendered)));
+    out.0.extend_from_slice(MAGIC);
+    out.u32(FORMAT_VERSION);
+
+    out.len(rendered.meshes.len());
+    for mesh in &rendered.meshes {
+        out.uniforms(&mesh.uniform);
+        out.len(mesh.tag.len());
+        for &tag in &mesh.tag {
+            out.i64(tag as i64);
+        }
+        out.len(mesh.dots.len());
+        for dot in &mesh.dots {
+            out.float3(dot.pos);
+            out.float3(dot.norm);
+            out.float4(dot.col);
+            out.i32(dot.inv);
+            out.bool(dot.is_dom_sib);
+        }
+        out.len(mesh.lins.len());
+        for lin in &mesh.lins {
+            out.lin_vertex(lin.a);
+            out.lin_vertex(lin.b);
+            out.float3(lin.norm);
+            out.i32(lin.prev);
+            out.i32(lin.next);
+            out.i32(lin.inv);
+            out.bool(lin.is_dom_sib);
+        }
+        out.len(mesh.tris.len());
+        for tri in &mesh.tris {
+            out.tri_vertex(tri.a);
+            out.tri_vertex(tri.b);
+            out.tri_vertex(tri.c);
+            out.i32(tri.ab);
+            out.i32(tri.bc);
+            out.i32(tri.ca);
+            out.bool(tri.is_dom_sib);
+        }
+    }
+
+    // sorted so equal renders write equal files
+    let mut spans: Vec<_> = rendered.span_mesh_indices.iter().collect();
+    spans.sort_by(|a, b| a.0.cmp(b.0));
+    out.len(spans.len());
+    for (name, indices) in spans {
+        out.bytes(name.as_bytes());
+        out.len(indices.len());
+        for &index in indices {
+            out.len(index);
+        }
+    }
+
+    out.0
+}
+
+// None for anything that isn't a complete file of the current format, so a
+// truncated or outdated entry is simply rendered again
+pub(crate) fn decode(bytes: &[u8]) -> Option<RenderedSvg> {
+    let mut input = Reader { bytes };
+    if input.take(MAGIC.len())? != MAGIC || input.u32()? != FORMAT_VERSION {
+        return None;
+    }
+
+    let mesh_count = input.len(1)?;
+    let mut meshes = Vec::with_capacity(mesh_count);
+    for _ in 0..mesh_count {
+        let uniform = input.uniforms()?;
+        let tag = (0..input.len(8)?)
+            .map(|_| input.i64().map(|tag| tag as isize))
+            .collect::<Option<_>>()?;
+        let dots = (0..input.len(DOT_SIZE)?)
+            .map(|_| {
+                Some(Dot {
+                    pos: input.float3()?,
+                    norm: input.float3()?,
+                    col: input.float4()?,
+                    inv: input.i32()?,
+                    is_dom_sib: input.bool()?,
+                })
+            })
+            .collect::<Option<_>>()?;
+        let lins = (0..input.len(LIN_SIZE)?)
+            .map(|_| {
+                Some(Lin {
+                    a: input.lin_vertex()?,
+                    b: input.lin_vertex()?,
+                    norm: input.float3()?,
+                    prev: input.i32()?,
+                    next: input.i32()?,
+                    inv: input.i32()?,
+                    is_dom_sib: input.bool()?,
+                })
+            })
+            .collect::<Option<_>>()?;
+        let tris = (0..input.len(TRI_SIZE)?)
+            .map(|_| {
+                Some(Tri {
+                    a: input.tri_vertex()?,
+                    b: input.tri_vertex()?,
+                    c: input.tri_vertex()?,
+                    ab: input.i32()?,
+                    bc: input.i32()?,
+                    ca: input.i32()?,
+                    is_dom_sib: input.bool()?,
+                })
+            })
+            .collect::<Option<_>>()?;
+        let mesh = Mesh {
+            dots,
+            lins,
+            tris,
+            uniform,
+            tag,
+            version: Mesh::fresh_version(),
+        };
+        if !links_in_range(&mesh) {
+            return None;
+        }
+        meshes.push(mesh);
+    }
+
+    let span_count = input.len(8)?;
+    let mut span_mesh_indices = HashMap::with_capacity(span_count);
+    for _ in 0..span_count {
+        let name = String::from_utf8(input.bytes()?.to_vec()).ok()?;
+        let indices = (0..input.len(4)?)
+            .map(|_| {
+                let index = input.u32()? as usize;
+                (index < meshes.len()).then_some(index)
+            })
+            .collect::<Option<_>>()?;
+        span_mesh_indices.insert(name, indices);
+    }
+
+    input.bytes.is_empty().then_some(RenderedSvg {
+        meshes,
+        span_mesh_indices,
+    })
+}
+
+// topology is walked without bounds checks later, so a link naming an element
+// the file doesn't have must not get that far
+fn links_in_range(mesh: &Mesh) -> bool {
+    let (dots, lins, tris) = (mesh.dots.len(), mesh.lins.len(), mesh.tris.len());
+    mesh.dots
+        .iter()
+        .all(|dot| link_in_range(dot.inv, dots, lins))
+        && mesh.lins.iter().all(|lin| {
+            link_in_range(lin.prev, lins, dots)
+                && link_in_range(lin.next, lins, dots)
+                && link_in_range(lin.inv, lins, tris)
+        })
+        && mesh.tris.iter().all(|tri| {
+            [tri.ab, tri.bc, tri.ca]
+                .into_iter()
+                .all(|link| link_in_range(link, tris, lins))
+        })
+}
+
+// -1 links nothing, other negative links are mesh refs into the other array
+fn link_in_range(link: i32, same: usize, other: usize) -> bool {
+    match link {
+        -1 => true,
+        0.. => (link as usize) < same,
+        _ => ((-(link as i64) - 2) as usize) < other,
+    }
+}
+
+const FLOAT3_SIZE: usize = 12;
+const FLOAT4_SIZE: usize = 16;
+const LIN_VERTEX_SIZE: usize = FLOAT3_SIZE + FLOAT4_SIZE;
+const TRI_VERTEX_SIZE: usize = FLOAT3_SIZE + FLOAT4_SIZE + 8;
+const DOT_SIZE: usize = 2 * FLOAT3_SIZE + FLOAT4_SIZE + 4 + 1;
+const LIN_SIZE: usize = 2 * LIN_VERTEX_SIZE + FLOAT3_SIZE + 3 * 4 + 1;
+const TRI_SIZE: usize = 3 * TRI_VERTEX_SIZE + 3 * 4 + 1;
+
+fn encoded_len_hint(rendered: &RenderedSvg) -> usize {
+    rendered
+        .meshes
+        .iter()
+        .map(|mesh| {
+            64 + 8 * mesh.tag.len()
+                + DOT_SIZE * mesh.dots.len()
+                + LIN_SIZE * mesh.lins.len()
+                + TRI_SIZE * mesh.tris.len()
+        })
+        .sum::<usize>()
+        + 16
+}
+
+struct Writer(Vec<u8>);
+
+impl Writer {
+    fn u32(&mut self, value: u32) {
+        self.0.extend_from_slice(&value.to_le_bytes());
+    }
+
+    fn len(&mut self, len: usize) {
+        self.u32(u32::try_from(len).expect("mesh cache counts fit in u32"));
+    }
+
+    fn i32(&mut self, value: i32) {
+        self.0.extend_from_slice(&value.to_le_bytes());
+    }
+
+    fn i64(&mut self, value: i64) {
+        self.0.extend_from_slice(&value.to_le_bytes());
+    }
+
+    fn f32(&mut self, value: f32) {
+        self.0.extend_from_slice(&value.to_le_bytes());
+    }
+
+    fn bool(&mut self, value: bool) {
+        self.0.push(value as u8);
+    }
+
+    fn bytes(&mut self, bytes: &[u8]) {
+        self.len(bytes.len());
+        self.0.extend_from_slice(bytes);
+    }
+
+    fn float2(&mut self, value: Float2) {
+        self.f32(value.x);
+        self.f32(value.y);
+    }
+
+    fn float3(&mut self, value: Float3) {
+        self.f32(value.x);
+        self.f32(value.y);
+        self.f32(value.z);
+    }
+
+    fn float4(&mut self, value: Float4) {
+        self.f32(value.x);
+        self.f32(value.y);
+        self.f32(value.z);
+        self.f32(value.w);
+    }
+
+    fn lin_vertex(&mut self, vertex: LinVertex) {
+        self.float3(vertex.pos);
+        self.float4(vertex.col);
+    }
+
+    fn tri_vertex(&mut self, vertex: TriVertex) {
+        self.float3(vertex.pos);
+        self.float4(vertex.col);
+        self.float2(vertex.uv);
+    }
+
+    fn uniforms(&mut self, uniform: &Uniforms) {
+        self.0.extend_from_slice(&uniform.alpha.to_le_bytes());
+        self.f32(uniform.stroke_miter_radius_scale);
+        self.f32(uniform.stroke_radius);
+        self.f32(uniform.dot_radius);
+        self.0
+            .extend_from_slice(&uniform.dot_vertex_count.to_le_bytes());
+        self.bool(uniform.smooth);
+        self.f32(uniform.gloss);
+        self.i32(uniform.z_index);
+        match &uniform.img {
+            Some(img) => {
+                self.bool(true);
+                self.bytes(img.to_string_lossy().as_bytes());
+            }
+            None => self.bool(false),
+        }
+    }
+}
+
+struct Reader<'a> {
+    bytes: &'a [u8],
+}
+
+impl<'a> Reader<'a> {
+    fn take(&mut self, len: usize) -> Option<&'a [u8]> {
+        if len > self.bytes.len() {
+            return None;
+        }
+        let (head, tail) = self.bytes.split_at(len);
+        self.bytes = tail;
+        Some(head)
+    }
+
+    fn array<const N: usize>(&mut self) -> Option<[u8; N]> {
+        self.take(N)?.try_into().ok()
+    }
+
+    fn u32(&mut self) -> Option<u32> {
+        self.array().map(u32::from_le_bytes)
+    }
+
+    // a count of records that are each at least `record_size` bytes; checked
+    // against what is left so a corrupt count can't request a huge allocation
+    fn len(&mut self, record_size: usize) -> Option<usize> {
+        let len = self.u32()? as usize;
+        (len.checked_mul(record_size)? <= self.bytes.len()).then_some(len)
+    }
+
+    fn i32(&mut self) -> Option<i32> {
+        self.array().map(i32::from_le_bytes)
+    }
+
+    fn i64(&mut self) -> Option<i64> {
+        self.array().map(i64::from_le_bytes)
+    }
+
+    fn f32(&mut self) -> Option<f32> {
+        self.array().map(f32::from_le_bytes)
+    }
+
+    fn bool(&mut self) -> Option<bool> {
+        match self.array::<1>()? {
+            [0] => Some(false),
+            [1] => Some(true),
+            _ => None,
+        }
+    }
+
+    fn bytes(&mut self) -> Option<&'a [u8]> {
+        let len = self.len(1)?;
+        self.take(len)
+    }
+
+    fn float2(&mut self) -> Option<Float2> {
+        Some(Float2 {
+            x: self.f32()?,
+            y: self.f32()?,
+        })
+    }
+
+    fn float3(&mut self) -> Option<Float3> {
+        Some(Float3 {
+            x: self.f32()?,
+            y: self.f32()?,
+            z: self.f32()?,
+        })
+    }
+
+    fn float4(&mut self) -> Option<Float4> {
+        Some(Float4 {
+            x: self.f32()?,
+            y: self.f32()?,
+            z: self.f32()?,
+            w: self.f32()?,
+        })
+    }
+
+    fn lin_vertex(&mut self) -> Option<LinVertex> {
+        Some(LinVertex {
+            pos: self.float3()?,
+            col: self.float4()?,
+        })
+    }
+
+    fn tri_vertex(&mut self) -> Option<TriVertex> {
+        Some(TriVertex {
+            pos: self.float3()?,
+            col: self.float4()?,
+            uv: self.float2()?,
+        })
+    }
+
+    fn uniforms(&mut self) -> Option<Uniforms> {
+        Some(Uniforms {
+            alpha: f64::from_le_bytes(self.array()?),
+            stroke_miter_radius_scale: self.f32()?,
+            stroke_radius: self.f32()?,
+            dot_radius: self.f32()?,
+            dot_vertex_count: u16::from_le_bytes(self.array()?),
+            smooth: self.bool()?,
+            gloss: self.f32()?,
+            z_index: self.i32()?,
+            img: match self.bool()? {
+                true => Some(PathBuf::from(
+                    String::from_utf8(self.bytes()?.to_vec()).ok()?,
+                )),
+                false => None,
+            },
+        })
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn sample() -> RenderedSvg {
+        let col = Float4::new(0.1, 0.2, 0.3, 1.0);
+        let lin_vertex = |x: f32| LinVertex {
+            pos: Float3::new(x, 1.0, 0.0),
+            col,
+        };
+        let tri_vertex = |x: f32, y: f32| TriVertex {
+            pos: Float3::new(x, y, 0.0),
+            col,
+            uv: Float2::new(x, y),
+        };
+        let mesh = Mesh {
+            dots: vec![Dot {
+                pos: Float3::new(0.5, -0.5, 0.0),
+                norm: Float3::Z,
+                col,
+                inv: -1,
+                is_dom_sib: true,
+            }],
+            lins: vec![
+                Lin {
+                    a: lin_vertex(0.0),
+                    b: lin_vertex(1.0),
+                    norm: Float3::Z,
+                    prev: 1,
+                    next: 1,
+                    inv: -1,
+                    is_dom_sib: false,
+                },
+                Lin {
+                    a: lin_vertex(1.0),
+                    b: lin_vertex(0.0),
+                    norm: Float3::Z,
+                    prev: 0,
+                    next: 0,
+                    inv: -1,
+                    is_dom_sib: false,
+                },
+            ],
+            tris: vec![Tri {
+                a: tri_vertex(0.0, 0.0),
+                b: tri_vertex(1.0, 0.0),
+                c: tri_vertex(0.0, 1.0),
+                ab: -1,
+                bc: -1,
+                ca: -1,
+                is_dom_sib: false,
+            }],
+            uniform: Uniforms {
+                stroke_radius: 0.55,
+                z_index: 3,
+                img: Some(PathBuf::from("glyph.png")),
+                ..Uniforms::default()
+            },
+            tag: vec![4, -2],
+            version: Mesh::fresh_version(),
+        };
+        let mut empty = mesh.clone();
+        empty.dots.clear();
+        empty.lins.clear();
+        empty.tris.clear();
+        empty.uniform = Uniforms::default();
+
+        RenderedSvg {
+            meshes: vec![mesh, empty],
+            span_mesh_indices: HashMap::from([
+                ("num".to_string(), vec![0]),
+                ("den".to_string(), vec![1, 0]),
+            ]),
+        }
+    }
+
+    #[test]
+    fn meshes_round_trip() {
+        let rendered = sample();
+        let decoded = decode(&encode(&rendered)).unwrap();
+
+        assert_eq!(decoded.meshes.len(), rendered.meshes.len());
+        for (decoded, mesh) in decoded.meshes.iter().zip(&rendered.meshes) {
+            assert_eq!(format!("{:?}", decoded.dots), format!("{:?}", mesh.dots));
+            assert_eq!(format!("{:?}", decoded.lins), format!("{:?}", mesh.lins));
+            assert_eq!(format!("{:?}", decoded.tris), format!("{:?}", mesh.tris));
+            assert_eq!(
+                format!("{:?}", decoded.uniform),
+                format!("{:?}", mesh.uniform)
+            );
+            assert_eq!(decoded.tag, mesh.tag);
+        }
+        assert_eq!(decoded.span_mesh_indices, rendered.span_mesh_indices);
+        assert_eq!(encode(&decoded), encode(&rendered));
+    }
+
+    #[test]
+    fn damaged_files_are_rejected() {
+        let bytes = encode(&sample());
+        for len in [0, 4, MAGIC.len() + 4, bytes.len() / 2, bytes.len() - 1] {
+            assert!(decode(&bytes[..len]).is_none());
+        }
+
+        let mut trailing = bytes.clone();
+        trailing.push(0);
+        assert!(decode(&trailing).is_none());
+
+        let mut outdated = bytes.clone();
+        outdated[MAGIC.len()..MAGIC.len() + 4].copy_from_slice(&(FORMAT_VERSION + 1).to_le_bytes());
+        assert!(decode(&outdated).is_none());
+
+        let mut huge_count = bytes.clone();
+        huge_count[MAGIC.len() + 4..MAGIC.len() + 8].copy_from_slice(&u32::MAX.to_le_bytes());
+        assert!(decode(&huge_count).is_none());
+    }
+
+    #[test]
+    fn links_past_the_arrays_are_rejected() {
+        let corruptions: [fn(&mut Mesh); 5] = [
+            |mesh| mesh.lins[0].next = 2,
+            |mesh| mesh.lins[1].prev = -3,
+            |mesh| mesh.lins[0].inv = i32::MIN,
+            |mesh| mesh.tris[0].bc = 1,
+            |mesh| mesh.dots[0].inv = -4,
+        ];
+        for corrupt in corruptions {
+            let mut rendered = sample();
+            corrupt(&mut rendered.meshes[0]);
+            assert!(decode(&encode(&rendered)).is_none());
+        }
+
+        // refs into the other array within its bounds are fine
+        let mut rendered = sample();
+        rendered.meshes[0].dots[0].inv = -3;
+        rendered.meshes[0].lins[0].inv = -2;
+        assert!(decode(&encode(&rendered)).is_some());
+    }
+}
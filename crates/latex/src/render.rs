@@ -111,19 +111,23 @@ fn render_document(
     let backend_config = backend_config();
     cache::render_cached(
         backend,
-        backend_config.clone(),
+        &backend_config,
         source,
         scale,
         quality,
-        |source| {
-            cache::render_svg_with_file_cache(&backend_config, &source, scale, quality, |source| {
-                match &backend_config {
+        |source, scale_bucket| {
+            cache::render_svg_with_file_cache(
+                &backend_config,
+                &source,
+                scale_bucket,
+                quality,
+                |source| match &backend_config {
                     LatexBackendConfig::Bundled => tectonic::render_svg_document(source),
                     LatexBackendConfig::System(config) => {
                         system::render_svg_document(source, config)
                     }
-                }
-            })
+                },
+            )
         },
     )
 }
@@ -0,0 +1,499 @@
+use std::f32::consts::PI;
+
+use geo::simd::Float2;
+
+// below this sine of the turn angle two segments are treated as one straight run
+const STRAIGHT_TURN_SIN: f32 = 1e-5;
+
+#[derive(Clone, Copy, Debug, Eq, PartialEq)]
+pub(crate) enum LineCap {
+    Butt,
+    Round,
+    Square,
+}
+
+#[derive(Clone, Copy, Debug, Eq, PartialEq)]
+pub(crate) enum LineJoin {
+    Miter,
+    Round,
+    Bevel,
+}
+
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub(crate) struct StrokeStyle {
+    pub width: f32,
+    pub cap: LineCap,
+    pub join: LineJoin,
+    pub miter_limit: f32,
+}
+
+// a stroke as indexed triangles, every face counter-clockwise. consecutive
+// segments share their ribs, so the faces of one subpath form a single strip
+// whose boundary is the stroke's outline
+#[derive(Debug, Default)]
+pub(crate) struct StrokeMesh {
+    pub vertices: Vec<Float2>,
+    pub faces: Vec<[usize; 3]>,
+}
+
+// the two corners across the centreline at one end of a segment, left being
+// the counter-clockwise side of its direction
+#[derive(Clone, Copy)]
+struct Rib {
+    left: usize,
+    right: usize,
+}
+
+// the rib a vertex's incoming segment ends on and the rib its outgoing one
+// starts from
+#[derive(Clone, Copy)]
+struct Corner {
+    incoming: Rib,
+    outgoing: Rib,
+}
+
+struct Segment {
+    dir: Float2,
+    normal: Float2,
+    len: f32,
+}
+
+impl StrokeMesh {
+    // strokes a flattened centreline straight into triangles. joins whose
+    // inner side fits inside both neighbouring segments meet at the inner
+    // offset lines' crossing; tighter ones pivot through the inner corner of
+    // the incoming segment, which overlaps but stays inside the stroke.
+    // round joins and caps step at most `round_step` radians
+    pub fn push_polyline(
+        &mut self,
+        points: &[Float2],
+        closed: bool,
+        style: StrokeStyle,
+        round_step: f32,
+    ) {
+        let half_width = 0.5 * style.width;
+        if !(half_width > 0.0) {
+            return;
+        }
+
+        let min_len = half_width * 1e-5;
+        let mut points: Vec<Float2> = points.iter().fold(Vec::new(), |mut kept, &point| {
+            if kept
+                .last()
+                .is_none_or(|&last: &Float2| (point - last).len() > min_len)
+            {
+                kept.push(point);
+            }
+            kept
+        });
+        if closed && points.len() >= 2 && (points[0] - points[points.len() - 1]).len() <= min_len {
+            points.pop();
+        }
+        let closed = closed && points.len() >= 3;
+        if points.len() < 2 {
+            return;
+        }
+
+        let segment_count = if closed {
+            points.len()
+        } else {
+            points.len() - 1
+        };
+        let segments: Vec<_> = (0..segment_count)
+            .map(|idx| {
+                let delta = points[(idx + 1) % points.len()] - points[idx];
+                let len = delta.len();
+                let dir = delta * (1.0 / len);
+                Segment {
+                    dir,
+                    normal: dir.perp(),
+                    len,
+                }
+            })
+            .collect();
+
+        let mut builder = StripBuilder {
+            mesh: self,
+            half_width,
+            style,
+            round_step,
+        };
+        let corners: Vec<_> = (0..points.len())
+            .map(|idx| {
+                let point = points[idx];
+                if !closed && idx == 0 {
+                    builder.start_cap(point, &segments[0])
+                } else if !closed && idx == points.len() - 1 {
+                    builder.end_cap(point, &segments[segment_count - 1])
+                } else {
+                    let before = (idx + segment_count - 1) % segment_count;
+                    let after = idx % segment_count;
+                    // a segment shares its length with the joins at both ends
+                    // unless one of them is a cap
+                    let room = |segment: usize| {
+                        let joins = if closed {
+                            2.0
+                        } else {
+                            1.0 + (segment != 0 && segment != segment_count - 1) as u8 as f32
+                        };
+                        segments[segment].len / joins
+                    };
+                    builder.join(
+                        point,
+                        &segments[before],
+                        &segments[after],
+                        room(before).min(room(after)),
+                    )
+                }
+            })
+            .collect();
+
+        for idx in 0..segment_count {
+            let start = corners[idx].outgoing;
+            let end = corners[(idx + 1) % corners.len()].incoming;
+            builder
+                .mesh
+                .faces
+                .push([start.left, start.right, end.right]);
+            builder.mesh.faces.push([start.left, end.right, end.left]);
+        }
+    }
+}
+
+struct StripBuilder<'a> {
+    mesh: &'a mut StrokeMesh,
+    half_width: f32,
+    style: StrokeStyle,
+    round_step: f32,
+}
+
+impl StripBuilder<'_> {
+    fn vertex(&mut self, pos: Float2) -> usize {
+        self.mesh.vertices.push(pos);
+        self.mesh.vertices.len() - 1
+    }
+
+    fn rib(&mut self, point: Float2, normal: Float2) -> Rib {
+        Rib {
+            left: self.vertex(point + normal * self.half_width),
+            right: self.vertex(point - normal * self.half_width),
+        }
+    }
+
+    // the points strictly between `from` and `to` on the arc around `center`,
+    // turning counter-clockwise by `angle`
+    fn arc(&mut self, center: Float2, from: Float2, angle: f32) -> Vec<usize> {
+        let steps = (angle.abs() / self.round_step).ceil().max(1.0) as usize;
+        let offset = from - center;
+        (1..steps)
+            .map(|step| {
+                let (sin, cos) = (angle * step as f32 / steps as f32).sin_cos();
+                let rotated = Float2::new(
+                    offset.x * cos - offset.y * sin,
+                    offset.x * sin + offset.y * cos,
+                );
+                self.vertex(center + rotated)
+            })
+            .collect()
+    }
+
+    fn start_cap(&mut self, point: Float2, segment: &Segment) -> Corner {
+        let back = if self.style.cap == LineCap::Square {
+            segment.dir * -self.half_width
+        } else {
+            Float2::ZERO
+        };
+        let rib = self.rib(point + back, segment.normal);
+        if self.style.cap == LineCap::Round {
+            // half a turn from the left corner round the back to the right
+            let left = self.mesh.vertices[rib.left];
+            let mut chain = vec![rib.left];
+            chain.extend(self.arc(point, left, PI));
+            for pair in chain.windows(2) {
+                self.mesh.faces.push([rib.right, pair[0], pair[1]]);
+            }
+        }
+        Corner {
+            incoming: rib,
+            outgoing: rib,
+        }
+    }
+
+    fn end_cap(&mut self, point: Float2, segment: &Segment) -> Corner {
+        let ahead = if self.style.cap == LineCap::Square {
+            segment.dir * self.half_width
+        } else {
+            Float2::ZERO
+        };
+        let rib = self.rib(point + ahead, segment.normal);
+        if self.style.cap == LineCap::Round {
+            let right = self.mesh.vertices[rib.right];
+            let mut chain = vec![rib.right];
+            chain.extend(self.arc(point, right, PI));
+            for pair in chain.windows(2) {
+                self.mesh.faces.push([rib.left, pair[0], pair[1]]);
+            }
+        }
+        Corner {
+            incoming: rib,
+            outgoing: rib,
+        }
+    }
+
+    fn join(&mut self, point: Float2, before: &Segment, after: &Segment, room: f32) -> Corner {
+        let sin = before.dir.x * after.dir.y - before.dir.y * after.dir.x;
+        let cos = before.dir.dot(after.dir);
+        if sin.abs() <= STRAIGHT_TURN_SIN && cos > 0.0 {
+            let rib = self.rib(point, before.normal);
+            return Corner {
+                incoming: rib,
+                outgoing: rib,
+            };
+        }
+
+        // a hairpin has no turn direction of its own (its sine may come out as
+        // either zero), so it is taken as a right turn: the outer side is then
+        // the left one and a round join sweeps clockwise through the direction
+        // ahead of the vertex
+        let turn = if sin == 0.0 && cos < 0.0 {
+            -PI
+        } else {
+            sin.atan2(cos)
+        };
+        // +1 when the inner side of the turn is the left one
+        let inner = if turn > 0.0 { 1.0 } else { -1.0 };
+        let outer_start = self.vertex(point - before.normal * (inner * self.half_width));
+        let outer_end = self.vertex(point - after.normal * (inner * self.half_width));
+
+        // the offset lines cross tan(turn / 2) half widths from the vertex
+        let reach = self.half_width * sin.abs() / (1.0 + cos);
+        let (inner_start, inner_end) = if 1.0 + cos > 1e-6 && reach <= room {
+            let bisector = (before.normal + after.normal) * (1.0 / (1.0 + cos));
+            let crossing = self.vertex(point + bisector * (inner * self.half_width));
+            (crossing, crossing)
+        } else {
+            (
+                self.vertex(point + before.normal * (inner * self.half_width)),
+                self.vertex(point + after.normal * (inner * self.half_width)),
+            )
+        };
+
+        let mut chain = vec![outer_start];
+        match self.style.join {
+            // the miter ratio is 1 / cos(turn / 2)
+            LineJoin::Miter if (1.0 + cos) * 0.5 * self.style.miter_limit.powi(2) >= 1.0 => {
+                let bisector = (before.normal + after.normal) * (1.0 / (1.0 + cos));
+                chain.push(self.vertex(point - bisector * (inner * self.half_width)));
+            }
+            LineJoin::Round => {
+                let from = self.mesh.vertices[outer_start];
+                chain.extend(self.arc(point, from, turn));
+            }
+            _ => {}
+        }
+        chain.push(outer_end);
+
+        // fan the outer side from the inner corner, then bridge to the
+        // outgoing inner corner when the inner side folds
+        for pair in chain.windows(2) {
+            self.mesh.faces.push(if inner > 0.0 {
+                [inner_start, pair[0], pair[1]]
+            } else {
+                [inner_start, pair[1], pair[0]]
+            });
+        }
+        if inner_start != inner_end {
+            self.mesh.faces.push(if inner > 0.0 {
+                [inner_start, outer_end, inner_end]
+            } else {
+                [inner_start, inner_end, outer_end]
+            });
+        }
+
+        let rib = |inner_vertex, outer_vertex| {
+            if inner > 0.0 {
+                Rib {
+                    left: inner_vertex,
+                    right: outer_vertex,
+                }
+            } else {
+                Rib {
+                    left: outer_vertex,
+                    right: inner_vertex,
+                }
+            }
+        };
+        Corner {
+            incoming: rib(inner_start, outer_start),
+            outgoing: rib(inner_end, outer_end),
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use std::collections::HashMap;
+
+    use super::*;
+
+    fn style(cap: LineCap, join: LineJoin) -> StrokeStyle {
+        StrokeStyle {
+            width: 2.0,
+            cap,
+            join,
+            miter_limit: 4.0,
+        }
+    }
+
+    fn area(mesh: &StrokeMesh) -> f32 {
+        mesh.faces
+            .iter()
+            .map(|&[a, b, c]| {
+                let (a, b, c) = (mesh.vertices[a], mesh.vertices[b], mesh.vertices[c]);
+                let (ab, ac) = (b - a, c - a);
+                0.5 * (ab.x * ac.y - ab.y * ac.x)
+            })
+            .sum()
+    }
+
+    // the loops formed by the edges no other face walks the other way
+    fn outline_loops(mesh: &StrokeMesh) -> usize {
+        let mut edges = HashMap::<(usize, usize), isize>::new();
+        for &[a, b, c] in &mesh.faces {
+            for (from, to) in [(a, b), (b, c), (c, a)] {
+                *edges.entry((from, to)).or_default() += 1;
+                *edges.entry((to, from)).or_default() -= 1;
+            }
+        }
+        let mut next: HashMap<_, _> = edges
+            .into_iter()
+            .filter(|&(_, count)| count > 0)
+            .map(|((from, to), _)| (from, to))
+            .collect();
+        let mut loops = 0;
+        while let Some(&start) = next.keys().next() {
+            let mut vertex = start;
+            while let Some(to) = next.remove(&vertex) {
+                vertex = to;
+            }
+            assert_eq!(vertex, start, "outline edges do not close");
+            loops += 1;
+        }
+        loops
+    }
+
+    #[test]
+    fn straight_strokes_cover_their_rectangle_and_caps() {
+        let line = [Float2::new(0.0, 0.0), Float2::new(10.0, 0.0)];
+        let expected = [
+            (LineCap::Butt, 20.0),
+            (LineCap::Square, 24.0),
+            (LineCap::Round, 20.0 + PI),
+        ];
+        for (cap, expected) in expected {
+            let mut mesh = StrokeMesh::default();
+            mesh.push_polyline(&line, false, style(cap, LineJoin::Miter), 0.01);
+            assert!((area(&mesh) - expected).abs() < 1e-3, "{cap:?}");
+            assert!(mesh.faces.iter().all(|&[a, b, c]| {
+                let (ab, ac) = (
+                    mesh.vertices[b] - mesh.vertices[a],
+                    mesh.vertices[c] - mesh.vertices[a],
+                );
+                ab.x * ac.y - ab.y * ac.x > 0.0
+            }));
+        }
+    }
+
+    #[test]
+    fn joins_share_ribs_and_add_their_corner() {
+        // a right angle, turning left at (10, 0)
+        let corner = [
+            Float2::new(0.0, 0.0),
+            Float2::new(10.0, 0.0),
+            Float2::new(10.0, 10.0),
+        ];
+        let arms = 2.0 * 10.0 * 2.0 - 1.0;
+        let expected = [
+            (LineJoin::Miter, arms + 1.0),
+            (LineJoin::Bevel, arms + 0.5),
+            (LineJoin::Round, arms + PI / 4.0),
+        ];
+        for (join, expected) in expected {
+            let mut mesh = StrokeMesh::default();
+            mesh.push_polyline(&corner, false, style(LineCap::Butt, join), 0.01);
+            assert!((area(&mesh) - expected).abs() < 1e-3, "{join:?}");
+        }
+
+        // a closed square strokes to a ring with an outer and an inner loop
+        let square = [
+            Float2::new(0.0, 0.0),
+            Float2::new(10.0, 0.0),
+            Float2::new(10.0, 10.0),
+            Float2::new(0.0, 10.0),
+        ];
+        let mut mesh = StrokeMesh::default();
+        mesh.push_polyline(&square, true, style(LineCap::Butt, LineJoin::Miter), 0.01);
+        assert!((area(&mesh) - (144.0 - 64.0)).abs() < 1e-3);
+        assert_eq!(outline_loops(&mesh), 2);
+    }
+
+    #[test]
+    fn tight_turns_fold_without_leaving_the_stroke() {
+        // a hairpin: the inner sides of both joins cross well past the arms
+        let hairpin = [
+            Float2::new(0.0, 0.0),
+            Float2::new(1.0, 0.0),
+            Float2::new(1.0, 0.5),
+            Float2::new(0.0, 0.5),
+        ];
+        let mut mesh = StrokeMesh::default();
+        mesh.push_polyline(&hairpin, false, style(LineCap::Butt, LineJoin::Round), 0.05);
+        // every vertex stays within a half width of the centreline
+        let distance = |point: Float2| {
+            hairpin
+                .windows(2)
+                .map(|pair| {
+                    let ab = pair[1] - pair[0];
+                    let t = ((point - pair[0]).dot(ab) / ab.dot(ab)).clamp(0.0, 1.0);
+                    (point - (pair[0] + ab * t)).len()
+                })
+                .fold(f32::INFINITY, f32::min)
+        };
+        assert!(
+            mesh.vertices
+                .iter()
+                .all(|&vertex| distance(vertex) <= 1.0 + 1e-4)
+        );
+        // and the faces still chain into one strip with a single outline
+        assert_eq!(outline_loops(&mesh), 1);
+    }
+
+    #[test]
+    fn round_hairpins_cap_the_turning_point() {
+        // the turn's sine comes out as +0.0 along x and as -0.0 along y
+        for dir in [Float2::new(1.0, 0.0), Float2::new(0.0, 1.0)] {
+            let hairpin = [Float2::ZERO, dir, Float2::ZERO];
+            let mut mesh = StrokeMesh::default();
+            mesh.push_polyline(&hairpin, false, style(LineCap::Butt, LineJoin::Round), 0.05);
+
+            let reach = mesh
+                .vertices
+                .iter()
+                .map(|vertex| vertex.dot(dir))
+                .fold(f32::NEG_INFINITY, f32::max);
+            assert!((reach - 2.0).abs() < 1e-3, "{dir:?}: tip reaches {reach}");
+            assert!(mesh.vertices.iter().all(|&vertex| {
+                let along = vertex.dot(dir).clamp(0.0, 1.0);
+                (vertex - dir * along).len() <= 1.0 + 1e-4
+            }));
+            assert!(mesh.faces.iter().all(|&[a, b, c]| {
+                let (ab, ac) = (
+                    mesh.vertices[b] - mesh.vertices[a],
+                    mesh.vertices[c] - mesh.vertices[a],
+                );
+                ab.x * ac.y - ab.y * ac.x >= -1e-5
+            }));
+            assert_eq!(outline_loops(&mesh), 1);
+        }
+    }
+}
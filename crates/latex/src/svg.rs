@@ -1,21 +1,44 @@
-use std::collections::HashMap;
+use std::{
+    borrow::Cow,
+    collections::{HashMap, hash_map::Entry},
+    num::NonZeroUsize,
+    thread,
+};
 
 use anyhow::{Result, anyhow};
 use geo::{
     mesh::{Lin, Mesh, Tri, Uniforms},
     mesh_build,
-    simd::{Float2, Float3, Float4},
+    simd::{Float2, Float3, Float4, Mat2},
 };
-use libtess2::{TessellationOptions, WindingRule};
-use tiny_skia_path::{Path, PathSegment, Point};
+use libtess2::{Precision, TessellationOptions, WindingRule};
+use tiny_skia_path::{Path, PathSegment, Point, Transform};
 use usvg::{FillRule, Node, Paint, Path as SvgPath, Tree};
 
+use crate::{
+    stroke::{LineCap, LineJoin, StrokeMesh, StrokeStyle},
+    svg_subset,
+};
+
 pub(crate) const DEFAULT_TEXT_STROKE_RADIUS: f32 = 0.55;
-const NORMAL_CURVE_SAMPLE_SPACING: f32 = 24.0;
-const HIGH_QUALITY_CURVE_SAMPLE_SPACING: f32 = 14.0;
-const MIN_CURVE_SAMPLES: usize = 4;
-const NORMAL_MAX_CURVE_SAMPLES: usize = 96;
-const HIGH_QUALITY_MAX_CURVE_SAMPLES: usize = 160;
+// part of the on-disk mesh cache key; bump it whenever a change here or in the
+// tessellator alters the meshes an svg imports to
+pub(crate) const IMPORT_VERSION: u32 = 3;
+// how far a flattened curve may stray from the true one, in scene units. at the
+// default camera a full-width reference frame shows about 74 pixels per unit,
+// so these are roughly an eighth and a twentieth of a pixel there
+const NORMAL_FLATTENING_TOLERANCE: f32 = 1.8e-3;
+const HIGH_QUALITY_FLATTENING_TOLERANCE: f32 = 6.0e-4;
+// a curve is cut into at most this many pieces per level of refinement
+const MAX_FLATTENING_PIECES: usize = 32;
+const MAX_FLATTENING_DEPTH: u32 = 3;
+const MAX_GLYPH_TESSELLATION_BYTES: usize = 1 << 28;
+// glyphs are rendered at a known resolution, so snapping their outlines to a
+// fine grid is invisible and makes every sweep predicate exact
+const GLYPH_GRID_CELLS: u32 = 1 << 14;
+// below this many path segments in distinct outlines, spawning workers costs
+// more than the tessellation they would share
+const PARALLEL_IMPORT_MIN_SEGMENTS: usize = 512;
 
 #[derive(Clone, Copy, Debug, Eq, PartialEq)]
 pub(crate) enum CurveSampling {
@@ -36,112 +59,516 @@ pub(crate) struct RenderedSvg {
     pub span_mesh_indices: HashMap<String, Vec<usize>>,
 }
 
-pub(crate) fn import(svg: &str, unit_scale: f32, options: ImportOptions) -> Result<RenderedSvg> {
-    let tree = Tree::from_str(svg, &usvg::Options::default())?;
-    let mut rendered = RenderedSvg {
-        meshes: Vec::new(),
-        span_mesh_indices: HashMap::new(),
+// how many outlines an import drew and how many of them it had to tessellate
+#[derive(Clone, Copy, Debug, Default, Eq, PartialEq)]
+pub(crate) struct OutlineReuse {
+    pub outlines: usize,
+    pub tessellated: usize,
+}
+
+impl OutlineReuse {
+    pub fn ratio(self) -> f32 {
+        if self.tessellated == 0 {
+            1.0
+        } else {
+            self.outlines as f32 / self.tessellated as f32
+        }
+    }
+}
+
+// dvisvgm draws every occurrence of a glyph as a `use` of one path definition,
+// so most outlines in a document repeat an earlier one at another position.
+// an import first walks the tree into one job per drawn outline, keeping each
+// distinct outline once, then tessellates the distinct outlines without their
+// translation, in parallel, and finally places an offset copy per job in
+// document order
+struct ImportJobs<'a> {
+    unit_scale: f32,
+    options: ImportOptions,
+    outlines: Vec<Outline<'a>>,
+    outline_indices: HashMap<OutlineKey, usize>,
+    jobs: Vec<OutlineJob>,
+}
+
+struct Outline<'a> {
+    path: Cow<'a, Path>,
+    // the transform without its translation
+    linear: Transform,
+    style: OutlineStyle,
+}
+
+#[derive(Clone, Copy, Debug, PartialEq)]
+enum OutlineStyle {
+    Fill { even_odd: bool },
+    // an outline tiny-skia stroked, which overlaps itself at every joint and
+    // dash and so goes through the sweep like a fill
+    StrokeOutline,
+    // a centreline, stroked straight into a triangle strip
+    Stroke(StrokeStyle),
+}
+
+struct OutlineJob {
+    outline: usize,
+    transform: Transform,
+    color: Float4,
+    tag: Vec<isize>,
+}
+
+// the style, the local path data and the linear part of its transform, which
+// together fix the sampled contours up to a translation
+#[derive(Eq, Hash, PartialEq)]
+struct OutlineKey {
+    words: Vec<u32>,
+}
+
+impl OutlineKey {
+    fn new(path: &Path, transform: Transform, style: OutlineStyle) -> Self {
+        let mut words = match style {
+            OutlineStyle::Fill { even_odd } => vec![0, even_odd as u32],
+            OutlineStyle::StrokeOutline => vec![1],
+            OutlineStyle::Stroke(stroke) => vec![
+                2,
+                stroke.width.to_bits(),
+                stroke.cap as u32,
+                stroke.join as u32,
+                stroke.miter_limit.to_bits(),
+            ],
+        };
+        words.extend([
+            transform.sx.to_bits(),
+            transform.kx.to_bits(),
+            transform.ky.to_bits(),
+            transform.sy.to_bits(),
+        ]);
+        fn push_point(words: &mut Vec<u32>, point: Point) {
+            words.push(point.x.to_bits());
+            words.push(point.y.to_bits());
+        }
+        for segment in path.segments() {
+            match segment {
+                PathSegment::MoveTo(point) => {
+                    words.push(0);
+                    push_point(&mut words, point);
+                }
+                PathSegment::LineTo(point) => {
+                    words.push(1);
+                    push_point(&mut words, point);
+                }
+                PathSegment::QuadTo(ctrl, point) => {
+                    words.push(2);
+                    push_point(&mut words, ctrl);
+                    push_point(&mut words, point);
+                }
+                PathSegment::CubicTo(ctrl_a, ctrl_b, point) => {
+                    words.push(3);
+                    push_point(&mut words, ctrl_a);
+                    push_point(&mut words, ctrl_b);
+                    push_point(&mut words, point);
+                }
+                PathSegment::Close => words.push(4),
+            }
+        }
+        Self { words }
+    }
+}
+
+impl<'a> ImportJobs<'a> {
+    fn new(unit_scale: f32, options: ImportOptions) -> Self {
+        Self {
+            unit_scale,
+            options,
+            outlines: Vec::new(),
+            outline_indices: HashMap::new(),
+            jobs: Vec::new(),
+        }
+    }
+
+    fn push(
+        &mut self,
+        path: Cow<'a, Path>,
+        transform: Transform,
+        color: Float4,
+        tag: Vec<isize>,
+        style: OutlineStyle,
+    ) {
+        let outline = match self
+            .outline_indices
+            .entry(OutlineKey::new(&path, transform, style))
+        {
+            Entry::Occupied(entry) => *entry.get(),
+            Entry::Vacant(entry) => {
+                self.outlines.push(Outline {
+                    path,
+                    linear: Transform::from_row(
+                        transform.sx,
+                        transform.ky,
+                        transform.kx,
+                        transform.sy,
+                        0.0,
+                        0.0,
+                    ),
+                    style,
+                });
+                *entry.insert(self.outlines.len() - 1)
+            }
+        };
+        self.jobs.push(OutlineJob {
+            outline,
+            transform,
+            color,
+            tag,
+        });
+    }
+
+    fn finish(self, workers: usize) -> Result<(Vec<Mesh>, OutlineReuse)> {
+        let reuse = OutlineReuse {
+            outlines: self.jobs.len(),
+            tessellated: self.outlines.len(),
+        };
+        let tessellated =
+            tessellate_outlines(&self.outlines, self.unit_scale, self.options, workers)?;
+
+        let mut meshes = Vec::with_capacity(self.jobs.len());
+        for job in self.jobs {
+            let Some((lins, tris)) = &tessellated[job.outline] else {
+                continue;
+            };
+            let offset = map_point(
+                Point::from_xy(0.0, 0.0),
+                job.transform,
+                self.unit_scale,
+                self.options.flip_y,
+            );
+            let mut lins = lins.clone();
+            for lin in &mut lins {
+                for vertex in [&mut lin.a, &mut lin.b] {
+                    vertex.pos += offset;
+                    vertex.col = job.color;
+                }
+            }
+            let mut tris = tris.clone();
+            for tri in &mut tris {
+                for vertex in [&mut tri.a, &mut tri.b, &mut tri.c] {
+                    vertex.pos += offset;
+                    vertex.col = job.color;
+                }
+            }
+            meshes.push(filled_mesh(lins, tris, job.tag));
+        }
+        Ok((meshes, reuse))
+    }
+}
+
+type LocalSurface = Option<(Vec<Lin>, Vec<Tri>)>;
+
+// outlines are dealt out largest-first like libtess components; with several
+// workers each outline's own components stay on its worker
+fn tessellate_outlines(
+    outlines: &[Outline],
+    unit_scale: f32,
+    options: ImportOptions,
+    workers: usize,
+) -> Result<Vec<LocalSurface>> {
+    let tessellate = |outline: &Outline, parallel_components: bool| -> Result<LocalSurface> {
+        if let OutlineStyle::Stroke(style) = outline.style {
+            return Ok(stroke_centrelines(
+                &outline.path,
+                outline.linear,
+                unit_scale,
+                options,
+                style,
+            ));
+        }
+        let contours = extract_contours(
+            &outline.path,
+            outline.linear,
+            unit_scale,
+            options,
+            options.flip_y,
+        );
+        if contours.is_empty() {
+            return Ok(None);
+        }
+        tessellate_planar_loops(
+            &contours,
+            Float3::Z,
+            outline.style == OutlineStyle::Fill { even_odd: true },
+            outline.style == OutlineStyle::StrokeOutline,
+            parallel_components,
+        )
+        .map(Some)
     };
-    collect_group(tree.root(), 1.0, unit_scale, options, &mut rendered)?;
+
+    let outline_size = |outline: &Outline| outline.path.len();
+    let total_size: usize = outlines.iter().map(outline_size).sum();
+    let workers = workers.min(outlines.len());
+    if workers <= 1 || total_size < PARALLEL_IMPORT_MIN_SEGMENTS {
+        return outlines
+            .iter()
+            .map(|outline| tessellate(outline, true))
+            .collect();
+    }
+
+    let mut by_size: Vec<_> = (0..outlines.len()).collect();
+    by_size.sort_by_key(|&idx| std::cmp::Reverse(outline_size(&outlines[idx])));
+    let mut assignments = vec![Vec::new(); workers];
+    let mut loads = vec![0usize; workers];
+    for idx in by_size {
+        let worker = (0..workers)
+            .min_by_key(|&worker| loads[worker])
+            .unwrap_or(0);
+        loads[worker] += outline_size(&outlines[idx]);
+        assignments[worker].push(idx);
+    }
+
+    let mut results: Vec<Option<Result<LocalSurface>>> =
+        (0..outlines.len()).map(|_| None).collect();
+    thread::scope(|scope| {
+        let handles: Vec<_> = assignments
+            .iter()
+            .map(|assigned| {
+                let tessellate = &tessellate;
+                scope.spawn(move || {
+                    assigned
+                        .iter()
+                        .map(|&idx| (idx, tessellate(&outlines[idx], false)))
+                        .collect::<Vec<_>>()
+                })
+            })
+            .collect();
+        for handle in handles {
+            for (idx, result) in handle.join().expect("svg import worker panicked") {
+                results[idx] = Some(result);
+            }
+        }
+    });
+
+    results
+        .into_iter()
+        .map(|result| result.expect("every outline is assigned to a worker"))
+        .collect()
+}
+
+pub(crate) fn import(svg: &str, unit_scale: f32, options: ImportOptions) -> Result<RenderedSvg> {
+    let (rendered, reuse) = import_counted(svg, unit_scale, options)?;
+    log::debug!(
+        "svg import tessellated {} of {} outlines ({:.1}x reuse)",
+        reuse.tessellated,
+        reuse.outlines,
+        reuse.ratio()
+    );
     Ok(rendered)
 }
 
-fn collect_group(
-    group: &usvg::Group,
-    inherited_opacity: f32,
+fn import_counted(
+    svg: &str,
     unit_scale: f32,
     options: ImportOptions,
-    rendered: &mut RenderedSvg,
-) -> Result<()> {
+) -> Result<(RenderedSvg, OutlineReuse)> {
+    let subset;
+    let tree;
+    let mut jobs = ImportJobs::new(unit_scale, options);
+    if let Some(document) = svg_subset::parse(svg) {
+        subset = document;
+        for draw in &subset.draws {
+            let (tag, color) = decode_tag_and_color(draw.color, draw.opacity);
+            jobs.push(
+                Cow::Borrowed(&subset.paths[draw.path]),
+                draw.transform,
+                color,
+                tag,
+                OutlineStyle::Fill {
+                    even_odd: draw.even_odd,
+                },
+            );
+        }
+    } else {
+        tree = Tree::from_str(svg, &usvg::Options::default())?;
+        collect_group(tree.root(), 1.0, &mut jobs);
+    }
+    let workers = thread::available_parallelism().map_or(1, NonZeroUsize::get);
+    let (meshes, reuse) = jobs.finish(workers)?;
+    Ok((
+        RenderedSvg {
+            meshes,
+            span_mesh_indices: HashMap::new(),
+        },
+        reuse,
+    ))
+}
+
+fn collect_group<'a>(group: &'a usvg::Group, inherited_opacity: f32, jobs: &mut ImportJobs<'a>) {
     let opacity = inherited_opacity * group.opacity().get();
 
     for child in group.children() {
         match child {
-            Node::Group(group) => collect_group(group, opacity, unit_scale, options, rendered)?,
-            Node::Path(path) => collect_path(path, opacity, unit_scale, options, rendered)?,
+            Node::Group(group) => collect_group(group, opacity, jobs),
+            Node::Path(path) => collect_path(path, opacity, jobs),
             _ => {}
         }
     }
-
-    Ok(())
 }
 
-fn collect_path(
-    path: &SvgPath,
-    inherited_opacity: f32,
-    unit_scale: f32,
-    options: ImportOptions,
-    rendered: &mut RenderedSvg,
-) -> Result<()> {
+fn collect_path<'a>(path: &'a SvgPath, inherited_opacity: f32, jobs: &mut ImportJobs<'a>) {
     if !path.is_visible() {
-        return Ok(());
+        return;
     }
 
     if let Some(fill) = path.fill() {
         if let Paint::Color(color) = fill.paint() {
-            let (tag, color) =
-                decode_tag_and_color(*color, fill.opacity().get() * inherited_opacity);
+            let (tag, color) = decode_tag_and_color(
+                [color.red, color.green, color.blue],
+                fill.opacity().get() * inherited_opacity,
+            );
             let even_odd = matches!(fill.rule(), FillRule::EvenOdd);
-            let contours = extract_contours(
-                path.data(),
+            jobs.push(
+                Cow::Borrowed(path.data()),
                 path.abs_transform(),
-                unit_scale,
-                options,
-                options.flip_y,
+                color,
+                tag,
+                OutlineStyle::Fill { even_odd },
             );
-            if !contours.is_empty() {
-                rendered
-                    .meshes
-                    .push(filled_contours(&contours, color, tag, even_odd)?);
-            }
         }
     }
 
     if let Some(stroke) = path.stroke() {
         if let Paint::Color(color) = stroke.paint() {
-            if let Some(stroked_path) = path.data().stroke(&stroke.to_tiny_skia(), 1.0) {
-                let (tag, color) =
-                    decode_tag_and_color(*color, stroke.opacity().get() * inherited_opacity);
-                let contours = extract_contours(
-                    &stroked_path,
+            let (tag, color) = decode_tag_and_color(
+                [color.red, color.green, color.blue],
+                stroke.opacity().get() * inherited_opacity,
+            );
+            // a strip overlaps itself inside tight joins, which only shows
+            // through a translucent stroke; dashes are left to tiny-skia too
+            if color.w >= 1.0 && stroke.dasharray().is_none() {
+                jobs.push(
+                    Cow::Borrowed(path.data()),
                     path.abs_transform(),
-                    unit_scale,
-                    options,
-                    options.flip_y,
+                    color,
+                    tag,
+                    OutlineStyle::Stroke(StrokeStyle {
+                        width: stroke.width().get(),
+                        cap: match stroke.linecap() {
+                            usvg::LineCap::Butt => LineCap::Butt,
+                            usvg::LineCap::Round => LineCap::Round,
+                            usvg::LineCap::Square => LineCap::Square,
+                        },
+                        join: match stroke.linejoin() {
+                            usvg::LineJoin::Miter | usvg::LineJoin::MiterClip => LineJoin::Miter,
+                            usvg::LineJoin::Round => LineJoin::Round,
+                            usvg::LineJoin::Bevel => LineJoin::Bevel,
+                        },
+                        miter_limit: stroke.miterlimit().get(),
+                    }),
+                );
+            } else if let Some(stroked_path) = path.data().stroke(&stroke.to_tiny_skia(), 1.0) {
+                jobs.push(
+                    Cow::Owned(stroked_path),
+                    path.abs_transform(),
+                    color,
+                    tag,
+                    OutlineStyle::StrokeOutline,
                 );
-                if !contours.is_empty() {
-                    rendered
-                        .meshes
-                        .push(filled_contours(&contours, color, tag, false)?);
-                }
             }
         }
     }
+}
 
-    Ok(())
+// strokes are offset in the path's own space, where their width is uniform,
+// and mapped to the scene afterwards, so a skewed or squashed transform bends
+// them the way it bends the path
+fn stroke_centrelines(
+    path: &Path,
+    linear: Transform,
+    unit_scale: f32,
+    options: ImportOptions,
+    style: StrokeStyle,
+) -> LocalSurface {
+    let flip = if options.flip_y { -1.0 } else { 1.0 };
+    let to_scene = Mat2::from_cols(
+        Float2::new(linear.sx, flip * linear.ky) * unit_scale,
+        Float2::new(linear.kx, flip * linear.sy) * unit_scale,
+    );
+    let det = to_scene.det();
+    if !det.is_normal() {
+        return None;
+    }
+    let to_local = to_scene.inverse();
+
+    // round parts step so their chords stay within the flattening tolerance
+    // at the radius they reach in the scene
+    let tolerance = flattening_tolerance(options);
+    let radius = 0.5 * style.width * to_scene.cols[0].len().max(to_scene.cols[1].len());
+    let round_step = if radius > tolerance {
+        2.0 * (1.0 - tolerance / radius).acos()
+    } else {
+        std::f32::consts::PI
+    };
+
+    let mut mesh = StrokeMesh::default();
+    for (points, closed) in extract_subpaths(path, linear, unit_scale, options, options.flip_y) {
+        let points: Vec<_> = points
+            .into_iter()
+            .map(|point| to_local.mul_vec(point.truncate()))
+            .collect();
+        mesh.push_polyline(&points, closed, style, round_step);
+    }
+    if mesh.faces.is_empty() {
+        return None;
+    }
+
+    let positions: Vec<_> = mesh
+        .vertices
+        .iter()
+        .map(|&vertex| to_scene.mul_vec(vertex).extend(0.0))
+        .collect();
+    let mut faces = mesh.faces;
+    // a mirroring transform turns the strip clockwise
+    if det < 0.0 {
+        for face in &mut faces {
+            face.swap(1, 2);
+        }
+    }
+    Some(indexed_surface(&positions, &faces, Float3::Z))
 }
 
 fn extract_contours(
     path: &Path,
-    transform: tiny_skia_path::Transform,
+    transform: Transform,
     unit_scale: f32,
     options: ImportOptions,
     flip_y: bool,
 ) -> Vec<Vec<Float3>> {
-    let mut contours = Vec::new();
+    extract_subpaths(path, transform, unit_scale, options, flip_y)
+        .into_iter()
+        .filter_map(|(mut contour, _)| {
+            if contour.len() >= 2 && contour.last() == contour.first() {
+                contour.pop();
+            }
+            (contour.len() >= 3).then_some(contour)
+        })
+        .collect()
+}
+
+// every subpath flattened, with whether it was closed
+fn extract_subpaths(
+    path: &Path,
+    transform: Transform,
+    unit_scale: f32,
+    options: ImportOptions,
+    flip_y: bool,
+) -> Vec<(Vec<Float3>, bool)> {
+    let mut subpaths = Vec::new();
     let mut current = Vec::new();
     let mut cursor = Float3::ZERO;
-    let mut start = Float3::ZERO;
     let mut has_cursor = false;
 
     for segment in path.segments() {
         match segment {
             PathSegment::MoveTo(point) => {
-                flush_current_contour(&mut contours, &mut current, start);
+                flush_subpath(&mut subpaths, &mut current, false);
                 let mapped = map_point(point, transform, unit_scale, flip_y);
                 current.push(mapped);
                 cursor = mapped;
-                start = mapped;
                 has_cursor = true;
             }
             PathSegment::LineTo(point) => {
@@ -158,14 +585,16 @@ fn extract_contours(
                 }
                 let control = map_point(ctrl, transform, unit_scale, flip_y);
                 let end = map_point(point, transform, unit_scale, flip_y);
-                let approx_length = (control - cursor).len() + (end - control).len();
-                let samples = curve_samples(approx_length, options);
-                for i in 1..=samples {
-                    let t = i as f32 / samples as f32;
-                    let mt = 1.0 - t;
-                    let sample = cursor * (mt * mt) + control * (2.0 * mt * t) + end * (t * t);
-                    push_unique_point(&mut current, sample);
-                }
+                // a quadratic is the cubic with its control points two thirds
+                // of the way to the quadratic's one
+                let control_a = cursor + (control - cursor) * (2.0 / 3.0);
+                let control_b = end + (control - end) * (2.0 / 3.0);
+                flatten_cubic(
+                    &mut current,
+                    [cursor, control_a, control_b, end],
+                    flattening_tolerance(options),
+                    MAX_FLATTENING_DEPTH,
+                );
                 cursor = end;
             }
             PathSegment::CubicTo(ctrl_a, ctrl_b, point) => {
@@ -175,56 +604,79 @@ fn extract_contours(
                 let control_a = map_point(ctrl_a, transform, unit_scale, flip_y);
                 let control_b = map_point(ctrl_b, transform, unit_scale, flip_y);
                 let end = map_point(point, transform, unit_scale, flip_y);
-                let approx_length = (control_a - cursor).len()
-                    + (control_b - control_a).len()
-                    + (end - control_b).len();
-                let samples = curve_samples(approx_length, options);
-                for i in 1..=samples {
-                    let t = i as f32 / samples as f32;
-                    let mt = 1.0 - t;
-                    let sample = cursor * (mt * mt * mt)
-                        + control_a * (3.0 * mt * mt * t)
-                        + control_b * (3.0 * mt * t * t)
-                        + end * (t * t * t);
-                    push_unique_point(&mut current, sample);
-                }
+                flatten_cubic(
+                    &mut current,
+                    [cursor, control_a, control_b, end],
+                    flattening_tolerance(options),
+                    MAX_FLATTENING_DEPTH,
+                );
                 cursor = end;
             }
             PathSegment::Close => {
-                flush_current_contour(&mut contours, &mut current, start);
+                flush_subpath(&mut subpaths, &mut current, true);
                 has_cursor = false;
             }
         }
     }
 
-    flush_current_contour(&mut contours, &mut current, start);
-    contours
+    flush_subpath(&mut subpaths, &mut current, false);
+    subpaths
 }
 
-fn map_point(
-    point: Point,
-    transform: tiny_skia_path::Transform,
-    unit_scale: f32,
-    flip_y: bool,
-) -> Float3 {
+fn map_point(point: Point, transform: Transform, unit_scale: f32, flip_y: bool) -> Float3 {
     let mut point = point;
     transform.map_point(&mut point);
     let y = if flip_y { -point.y } else { point.y };
     Float3::new(point.x * unit_scale, y * unit_scale, 0.0)
 }
 
-fn curve_samples(approx_length: f32, options: ImportOptions) -> usize {
-    let (spacing, max_samples) = match options.curve_sampling {
-        CurveSampling::Normal => (NORMAL_CURVE_SAMPLE_SPACING, NORMAL_MAX_CURVE_SAMPLES),
-        CurveSampling::High => (
-            HIGH_QUALITY_CURVE_SAMPLE_SPACING,
-            HIGH_QUALITY_MAX_CURVE_SAMPLES,
-        ),
-    };
+fn flattening_tolerance(options: ImportOptions) -> f32 {
+    match options.curve_sampling {
+        CurveSampling::Normal => NORMAL_FLATTENING_TOLERANCE,
+        CurveSampling::High => HIGH_QUALITY_FLATTENING_TOLERANCE,
+    }
+}
 
-    (approx_length / spacing)
-        .ceil()
-        .clamp(MIN_CURVE_SAMPLES as f32, max_samples as f32) as usize
+// cuts the curve until each piece is within tolerance of its chord, so straight
+// runs take one segment and tight turns as many as they need. a piece lies in
+// the hull of its control points and the middle two are weighted at most 3/4
+// in total, which bounds its distance from the chord
+fn flatten_cubic(points: &mut Vec<Float3>, curve: [Float3; 4], tolerance: f32, depth: u32) {
+    let [p0, p1, p2, p3] = curve;
+    let deviation = 0.75 * distance_to_segment(p1, p0, p3).max(distance_to_segment(p2, p0, p3));
+    if depth == 0 || deviation <= tolerance {
+        push_unique_point(points, p3);
+        return;
+    }
+
+    // the chord error of n equal pieces falls off as 1/n^2
+    let pieces = ((deviation / tolerance).sqrt().ceil() as usize).clamp(2, MAX_FLATTENING_PIECES);
+    let mut rest = curve;
+    for piece in 0..pieces - 1 {
+        let (head, tail) = split_cubic(rest, 1.0 / (pieces - piece) as f32);
+        flatten_cubic(points, head, tolerance, depth - 1);
+        rest = tail;
+    }
+    flatten_cubic(points, rest, tolerance, depth - 1);
+}
+
+fn split_cubic([p0, p1, p2, p3]: [Float3; 4], t: f32) -> ([Float3; 4], [Float3; 4]) {
+    let lerp = |a: Float3, b: Float3| a + (b - a) * t;
+    let (p01, p12, p23) = (lerp(p0, p1), lerp(p1, p2), lerp(p2, p3));
+    let (p012, p123) = (lerp(p01, p12), lerp(p12, p23));
+    let mid = lerp(p012, p123);
+    ([p0, p01, p012, mid], [mid, p123, p23, p3])
+}
+
+fn distance_to_segment(point: Float3, a: Float3, b: Float3) -> f32 {
+    let ab = b - a;
+    let length_sq = ab.dot(ab);
+    let t = if length_sq > 0.0 {
+        ((point - a).dot(ab) / length_sq).clamp(0.0, 1.0)
+    } else {
+        0.0
+    };
+    (point - (a + ab * t)).len()
 }
 
 fn push_unique_point(points: &mut Vec<Float3>, point: Float3) {
@@ -233,28 +685,21 @@ fn push_unique_point(points: &mut Vec<Float3>, point: Float3) {
     }
 }
 
-fn flush_current_contour(
-    contours: &mut Vec<Vec<Float3>>,
-    current: &mut Vec<Float3>,
-    start: Float3,
-) {
-    if current.len() >= 2 && current.last() == Some(&start) {
-        current.pop();
-    }
-    if current.len() >= 3 {
-        contours.push(std::mem::take(current));
+fn flush_subpath(subpaths: &mut Vec<(Vec<Float3>, bool)>, current: &mut Vec<Float3>, closed: bool) {
+    if current.len() >= 2 {
+        subpaths.push((std::mem::take(current), closed));
     } else {
         current.clear();
     }
 }
 
-fn decode_tag_and_color(color: usvg::Color, alpha: f32) -> (Vec<isize>, Float4) {
-    if color.green == u8::MAX && color.blue == u8::MAX {
-        return (vec![color.red as isize], Float4::new(0.0, 0.0, 0.0, alpha));
+fn decode_tag_and_color([red, green, blue]: [u8; 3], alpha: f32) -> (Vec<isize>, Float4) {
+    if green == u8::MAX && blue == u8::MAX {
+        return (vec![red as isize], Float4::new(0.0, 0.0, 0.0, alpha));
     }
-    if color.red == u8::MAX {
+    if red == u8::MAX {
         return (
-            vec![color.green as isize, color.blue as isize],
+            vec![green as isize, blue as isize],
             Float4::new(0.0, 0.0, 0.0, alpha),
         );
     }
@@ -262,21 +707,15 @@ fn decode_tag_and_color(color: usvg::Color, alpha: f32) -> (Vec<isize>, Float4)
     (
         Vec::new(),
         Float4::new(
-            color.red as f32 / 255.0,
-            color.green as f32 / 255.0,
-            color.blue as f32 / 255.0,
+            red as f32 / 255.0,
+            green as f32 / 255.0,
+            blue as f32 / 255.0,
             alpha,
         ),
     )
 }
 
-fn filled_contours(
-    contours: &[Vec<Float3>],
-    color: Float4,
-    tag: Vec<isize>,
-    even_odd: bool,
-) -> Result<Mesh> {
-    let (lins, tris) = tessellate_planar_loops(contours, Float3::Z, color, even_odd)?;
+fn filled_mesh(lins: Vec<Lin>, tris: Vec<Tri>, tag: Vec<isize>) -> Mesh {
     let mesh = Mesh {
         dots: Vec::new(),
         lins,
@@ -289,14 +728,16 @@ fn filled_contours(
         version: Mesh::fresh_version(),
     };
     mesh.debug_assert_consistent_topology();
-    Ok(mesh)
+    mesh
 }
 
 fn tessellate_planar_loops(
     contours: &[Vec<Float3>],
     normal: Float3,
-    color: Float4,
     even_odd: bool,
+    // stroke outlines overlap themselves at every joint and dash
+    stroked: bool,
+    parallel_components: bool,
 ) -> Result<(Vec<Lin>, Vec<Tri>)> {
     let contours: Vec<_> = contours
         .iter()
@@ -319,25 +760,400 @@ fn tessellate_planar_loops(
             constrained_delaunay: true,
             reverse_contours: false,
             normalize_input: false,
+            split_components: true,
+            parallel_components,
+            memory_limit: Some(MAX_GLYPH_TESSELLATION_BYTES),
+            precision: Precision::Grid {
+                cells: GLYPH_GRID_CELLS,
+            },
+            reorder_output: true,
+            intersection_heavy: stroked,
+            simple_input: !stroked,
         },
     )
     .map_err(|error| anyhow!("failed to tessellate glyph outline: {error}"))?;
 
-    let vertices: Vec<_> = tess
-        .vertices
+    Ok(indexed_surface(&tess.vertices, &tess.triangles, normal))
+}
+
+fn indexed_surface(
+    positions: &[Float3],
+    faces: &[[usize; 3]],
+    normal: Float3,
+) -> (Vec<Lin>, Vec<Tri>) {
+    let vertices: Vec<_> = positions
         .iter()
         .copied()
         .map(|pos| mesh_build::SurfaceVertex {
             pos,
-            col: color,
+            // set per occurrence when the outline is placed
+            col: Float4::ZERO,
             uv: Float2::ZERO,
         })
         .collect();
-    let (mut lins, tris) =
-        mesh_build::build_indexed_surface(&vertices, &tess.triangles, &HashMap::new());
+    let (mut lins, tris) = mesh_build::build_indexed_surface(&vertices, faces, &HashMap::new());
     for line in &mut lins {
         line.norm = normal;
     }
 
-    Ok((lins, tris))
+    (lins, tris)
+}
+
+#[cfg(test)]
+mod tests {
+    use tiny_skia_path::PathBuilder;
+
+    use super::*;
+
+    fn glyph() -> Path {
+        let mut builder = PathBuilder::new();
+        builder.move_to(0.0, 0.0);
+        builder.line_to(4.0, 0.0);
+        builder.quad_to(6.0, 3.0, 4.0, 6.0);
+        builder.line_to(0.0, 6.0);
+        builder.close();
+        builder.finish().unwrap()
+    }
+
+    fn options() -> ImportOptions {
+        ImportOptions {
+            curve_sampling: CurveSampling::Normal,
+            flip_y: true,
+        }
+    }
+
+    #[test]
+    fn repeated_outlines_are_tessellated_once() {
+        let glyph = glyph();
+        let color = Float4::new(0.0, 0.0, 0.0, 1.0);
+        let mut jobs = ImportJobs::new(0.5, options());
+        for transform in [
+            Transform::from_translate(10.0, 20.0),
+            Transform::from_translate(-3.0, 5.0),
+            Transform::from_row(2.0, 0.0, 0.0, 2.0, 10.0, 20.0),
+        ] {
+            jobs.push(
+                Cow::Borrowed(&glyph),
+                transform,
+                color,
+                Vec::new(),
+                OutlineStyle::Fill { even_odd: false },
+            );
+        }
+        let (meshes, reuse) = jobs.finish(1).unwrap();
+        assert_eq!(
+            reuse,
+            OutlineReuse {
+                outlines: 3,
+                tessellated: 2,
+            }
+        );
+        let [first, second, scaled] = &meshes[..] else {
+            panic!("expected a mesh per outline");
+        };
+
+        // y is flipped and everything is in half units
+        let offset = Float3::new(-6.5, 7.5, 0.0);
+        assert_eq!(first.tris.len(), second.tris.len());
+        for (a, b) in first.tris.iter().zip(&second.tris) {
+            for (a, b) in [(a.a, b.a), (a.b, b.b), (a.c, b.c)] {
+                assert!((a.pos + offset - b.pos).len() < 1e-4);
+                assert_eq!(b.col, color);
+            }
+        }
+        assert_eq!(first.lins.len(), second.lins.len());
+        assert!(scaled.tris.len() >= first.tris.len());
+        let min_x = scaled
+            .tris
+            .iter()
+            .map(|tri| tri.a.pos.x.min(tri.b.pos.x).min(tri.c.pos.x))
+            .fold(f32::INFINITY, f32::min);
+        assert!((min_x - 5.0).abs() < 1e-4);
+    }
+
+    #[test]
+    fn centrelines_are_stroked_in_path_space() {
+        let mut builder = PathBuilder::new();
+        builder.move_to(0.0, 0.0);
+        builder.line_to(10.0, 0.0);
+        builder.line_to(10.0, 10.0);
+        let corner = builder.finish().unwrap();
+        let style = StrokeStyle {
+            width: 2.0,
+            cap: LineCap::Butt,
+            join: LineJoin::Miter,
+            miter_limit: 4.0,
+        };
+
+        let mut jobs = ImportJobs::new(0.5, options());
+        jobs.push(
+            Cow::Borrowed(&corner),
+            // stretched along x and flipped by the y-down import
+            Transform::from_row(2.0, 0.0, 0.0, 1.0, 3.0, 4.0),
+            Float4::new(0.0, 0.0, 0.0, 1.0),
+            Vec::new(),
+            OutlineStyle::Stroke(style),
+        );
+        let (meshes, _) = jobs.finish(1).unwrap();
+        let [mesh] = &meshes[..] else {
+            panic!("expected one stroke mesh");
+        };
+
+        // two overlapping arms and a square miter in path space, scaled by
+        // the transform's determinant and the unit scale squared
+        let areas: Vec<_> = mesh
+            .tris
+            .iter()
+            .map(|tri| 0.5 * (tri.b.pos - tri.a.pos).cross(tri.c.pos - tri.a.pos).z)
+            .collect();
+        assert!(areas.iter().all(|&area| area > 0.0));
+        let area: f32 = areas.iter().sum();
+        assert!((area - 40.0 * 2.0 * 0.25).abs() < 1e-3);
+        assert_eq!(
+            mesh.lins.iter().filter(|lin| lin.prev < 0).count(),
+            0,
+            "the outline should be one closed loop"
+        );
+    }
+
+    #[test]
+    fn parallel_import_keeps_document_order() {
+        // distinct outlines, each drawn twice, interleaved with their repeats
+        let glyphs: Vec<_> = (0..96)
+            .map(|idx| {
+                let width = 2.0 + idx as f32 * 0.125;
+                let mut builder = PathBuilder::new();
+                builder.move_to(0.0, 0.0);
+                builder.line_to(width, 0.0);
+                builder.cubic_to(width + 2.0, 1.0, width + 2.0, 5.0, width, 6.0);
+                builder.line_to(0.0, 6.0);
+                builder.quad_to(-2.0, 3.0, 0.0, 0.0);
+                builder.close();
+                builder.finish().unwrap()
+            })
+            .collect();
+        let import = |workers: usize| {
+            let mut jobs = ImportJobs::new(1.0, options());
+            for (idx, glyph) in glyphs.iter().chain(&glyphs).enumerate() {
+                jobs.push(
+                    Cow::Borrowed(glyph),
+                    Transform::from_translate(idx as f32 * 10.0, 0.0),
+                    Float4::new(0.0, 0.0, 0.0, 1.0),
+                    vec![idx as isize],
+                    OutlineStyle::Fill { even_odd: false },
+                );
+            }
+            jobs.finish(workers).unwrap()
+        };
+
+        let (serial, serial_reuse) = import(1);
+        let (parallel, parallel_reuse) = import(4);
+        assert_eq!(serial_reuse, parallel_reuse);
+        assert_eq!(serial_reuse.tessellated, glyphs.len());
+        assert_eq!(serial.len(), parallel.len());
+        for (idx, (a, b)) in serial.iter().zip(&parallel).enumerate() {
+            assert_eq!(b.tag, vec![idx as isize]);
+            assert_eq!(format!("{:?}", a.tris), format!("{:?}", b.tris));
+            assert_eq!(format!("{:?}", a.lins), format!("{:?}", b.lins));
+        }
+    }
+
+    // outlines shaped like computer modern glyphs, in the points dvisvgm
+    // writes: a round letter, a parenthesis, an integral sign, a digit and a
+    // nearly straight slanted stroke
+    fn glyph_corpus() -> Vec<Path> {
+        const K: f32 = 0.552_284_8;
+        let mut glyphs = Vec::new();
+
+        let mut o = PathBuilder::new();
+        for (rx, ry, inner) in [(2.5, 2.2, false), (1.6, 1.9, true)] {
+            let quarter = |i: usize| {
+                let (sin, cos) = (i as f32 * std::f32::consts::FRAC_PI_2).sin_cos();
+                (cos * rx, sin * ry, -sin * rx * K, cos * ry * K)
+            };
+            let order: Vec<usize> = if inner {
+                vec![0, 3, 2, 1, 0]
+            } else {
+                vec![0, 1, 2, 3, 0]
+            };
+            let sign = if inner { -1.0 } else { 1.0 };
+            let (x, y, ..) = quarter(order[0]);
+            o.move_to(x, y);
+            for pair in order.windows(2) {
+                let (x0, y0, tx0, ty0) = quarter(pair[0]);
+                let (x1, y1, tx1, ty1) = quarter(pair[1]);
+                o.cubic_to(
+                    x0 + sign * tx0,
+                    y0 + sign * ty0,
+                    x1 - sign * tx1,
+                    y1 - sign * ty1,
+                    x1,
+                    y1,
+                );
+            }
+            o.close();
+        }
+        glyphs.push(o.finish().unwrap());
+
+        let mut paren = PathBuilder::new();
+        paren.move_to(3.0, -7.5);
+        paren.cubic_to(1.0, -5.5, 0.4, -2.5, 0.4, 0.0);
+        paren.cubic_to(0.4, 2.5, 1.0, 5.5, 3.0, 7.5);
+        paren.line_to(3.3, 7.3);
+        paren.cubic_to(1.6, 5.2, 1.1, 2.5, 1.1, 0.0);
+        paren.cubic_to(1.1, -2.5, 1.6, -5.2, 3.3, -7.3);
+        paren.close();
+        glyphs.push(paren.finish().unwrap());
+
+        let mut integral = PathBuilder::new();
+        integral.move_to(1.0, -9.0);
+        integral.cubic_to(0.2, -9.0, 0.0, -8.2, 0.6, -8.0);
+        integral.cubic_to(1.4, -7.8, 1.6, -8.6, 2.0, -6.0);
+        integral.line_to(3.2, 7.0);
+        integral.cubic_to(3.6, 9.0, 4.6, 9.4, 5.4, 8.8);
+        integral.cubic_to(5.0, 8.4, 4.4, 8.8, 4.0, 7.0);
+        integral.line_to(2.8, -6.0);
+        integral.cubic_to(2.4, -8.8, 1.8, -9.0, 1.0, -9.0);
+        integral.close();
+        glyphs.push(integral.finish().unwrap());
+
+        let mut two = PathBuilder::new();
+        two.move_to(0.5, 5.0);
+        two.quad_to(0.8, 7.0, 2.6, 7.0);
+        two.quad_to(4.6, 7.0, 4.6, 5.0);
+        two.quad_to(4.6, 3.6, 2.8, 2.2);
+        two.line_to(1.4, 1.0);
+        two.line_to(4.7, 1.0);
+        two.line_to(4.9, 0.0);
+        two.line_to(0.4, 0.0);
+        two.line_to(0.4, 0.4);
+        two.quad_to(2.6, 2.4, 3.2, 3.4);
+        two.quad_to(3.7, 4.2, 3.7, 5.0);
+        two.quad_to(3.7, 6.5, 2.5, 6.5);
+        two.quad_to(1.4, 6.5, 1.1, 5.4);
+        two.close();
+        glyphs.push(two.finish().unwrap());
+
+        let mut slash = PathBuilder::new();
+        slash.move_to(0.0, 0.0);
+        slash.cubic_to(1.0, 2.5, 2.0, 5.0, 3.0, 7.5);
+        slash.line_to(3.6, 7.5);
+        slash.cubic_to(2.6, 5.0, 1.6, 2.5, 0.6, 0.0);
+        slash.close();
+        glyphs.push(slash.finish().unwrap());
+
+        glyphs
+    }
+
+    // every curve of a glyph as a cubic, in scene units
+    fn glyph_curves(glyph: &Path, unit_scale: f32) -> Vec<[Float3; 4]> {
+        let map = |point: Point| Float3::new(point.x, point.y, 0.0) * unit_scale;
+        let mut start = Float3::ZERO;
+        let mut curves = Vec::new();
+        for segment in glyph.segments() {
+            let curve = match segment {
+                PathSegment::MoveTo(point) | PathSegment::LineTo(point) => {
+                    start = map(point);
+                    continue;
+                }
+                PathSegment::QuadTo(control, end) => {
+                    let (control, end) = (map(control), map(end));
+                    [
+                        start,
+                        start + (control - start) * (2.0 / 3.0),
+                        end + (control - end) * (2.0 / 3.0),
+                        end,
+                    ]
+                }
+                PathSegment::CubicTo(a, b, end) => [start, map(a), map(b), map(end)],
+                PathSegment::Close => continue,
+            };
+            curves.push(curve);
+            start = curve[3];
+        }
+        curves
+    }
+
+    fn cubic_at(curve: [Float3; 4], t: f32) -> Float3 {
+        let mt = 1.0 - t;
+        curve[0] * (mt * mt * mt)
+            + curve[1] * (3.0 * mt * mt * t)
+            + curve[2] * (3.0 * mt * t * t)
+            + curve[3] * (t * t * t)
+    }
+
+    // both directions of the hausdorff distance between a curve and its
+    // flattening, measured on dense samples of each
+    fn hausdorff(curve: [Float3; 4], polyline: &[Float3]) -> f32 {
+        let samples: Vec<_> = (0..=512)
+            .map(|i| cubic_at(curve, i as f32 / 512.0))
+            .collect();
+        let distance = |point: Float3, line: &[Float3]| {
+            line.windows(2)
+                .map(|pair| distance_to_segment(point, pair[0], pair[1]))
+                .fold(f32::INFINITY, f32::min)
+        };
+        let to_polyline = samples
+            .iter()
+            .map(|&point| distance(point, polyline))
+            .fold(0.0, f32::max);
+        let to_curve = polyline
+            .windows(2)
+            .flat_map(|pair| (0..=8).map(move |i| pair[0] + (pair[1] - pair[0]) * (i as f32 / 8.0)))
+            .map(|point| distance(point, &samples))
+            .fold(0.0, f32::max);
+        to_polyline.max(to_curve)
+    }
+
+    #[test]
+    fn flattening_is_error_bounded_and_sparser_than_uniform_sampling() {
+        // scale 1 text, where the sampling this replaced put four points on
+        // every curve, uniformly in t
+        let unit_scale = 1.0 / 36.0;
+        let glyphs = glyph_corpus();
+        let options = ImportOptions {
+            curve_sampling: CurveSampling::Normal,
+            flip_y: false,
+        };
+        let (mut adaptive, mut uniform, mut uniform_error) = (0, 0, 0.0f32);
+        for glyph in &glyphs {
+            let contours =
+                extract_contours(glyph, Transform::identity(), unit_scale, options, false);
+            adaptive += contours.iter().map(Vec::len).sum::<usize>();
+            for segment in glyph.segments() {
+                uniform += match segment {
+                    PathSegment::QuadTo(..) | PathSegment::CubicTo(..) => 4,
+                    PathSegment::Close => 0,
+                    _ => 1,
+                };
+            }
+            for curve in glyph_curves(glyph, unit_scale) {
+                let polyline: Vec<_> = (0..=4).map(|i| cubic_at(curve, i as f32 / 4.0)).collect();
+                uniform_error = uniform_error.max(hausdorff(curve, &polyline));
+            }
+        }
+        assert!(
+            adaptive * 10 <= uniform * 9,
+            "{adaptive} vertices against {uniform}"
+        );
+        assert!(uniform_error >= NORMAL_FLATTENING_TOLERANCE);
+
+        // and the bound holds however large the text is drawn
+        for tolerance in [
+            NORMAL_FLATTENING_TOLERANCE,
+            HIGH_QUALITY_FLATTENING_TOLERANCE,
+        ] {
+            for scale in [1.0, 16.0] {
+                for curve in glyphs
+                    .iter()
+                    .flat_map(|glyph| glyph_curves(glyph, unit_scale * scale))
+                {
+                    let mut polyline = vec![curve[0]];
+                    flatten_cubic(&mut polyline, curve, tolerance, MAX_FLATTENING_DEPTH);
+                    let error = hausdorff(curve, &polyline);
+                    assert!(error <= tolerance * 1.01, "{error} > {tolerance}");
+                }
+            }
+        }
+    }
 }
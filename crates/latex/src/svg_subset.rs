@@ -0,0 +1,923 @@
+use std::collections::HashMap;
+
+use tiny_skia_path::{Path, PathBuilder, Transform};
+
+const SVG_NAMESPACE: &str = "http://www.w3.org/2000/svg";
+const XLINK_NAMESPACE: &str = "http://www.w3.org/1999/xlink";
+// css pixels per unit, as usvg resolves the root size at its default 96 dpi
+const LENGTH_UNITS: [(&str, f32); 7] = [
+    ("", 1.0),
+    ("px", 1.0),
+    ("pt", 4.0 / 3.0),
+    ("pc", 16.0),
+    ("mm", 96.0 / 25.4),
+    ("cm", 96.0 / 2.54),
+    ("in", 96.0),
+];
+
+// dvisvgm (with --no-fonts) and hayro-svg write glyphs as filled paths, either
+// in place or as `use`s of paths in <defs>, inside plain groups, with rules as
+// rects. for documents built from only those, this reads the outlines straight
+// off the markup in one pass instead of going through a full usvg tree.
+//
+// anything else, or any attribute it doesn't know, makes parse return None so
+// the caller falls back to usvg; whatever it does accept resolves the way usvg
+// would, down to the root viewBox transform at usvg's default dpi
+
+pub(crate) struct Document {
+    pub paths: Vec<Path>,
+    pub draws: Vec<Draw>,
+}
+
+pub(crate) struct Draw {
+    pub path: usize,
+    pub transform: Transform,
+    pub color: [u8; 3],
+    pub opacity: f32,
+    pub even_odd: bool,
+}
+
+pub(crate) fn parse(svg: &str) -> Option<Document> {
+    let mut parser = Parser {
+        document: Document {
+            paths: Vec::new(),
+            draws: Vec::new(),
+        },
+        stack: Vec::new(),
+        defs: HashMap::new(),
+        root_closed: false,
+    };
+    let mut tokens = Tokenizer { rest: svg };
+    while let Some(token) = tokens.next()? {
+        match token {
+            Token::Open {
+                name,
+                attributes,
+                closed,
+            } => {
+                parser.open(name, &attributes)?;
+                if closed {
+                    parser.close(name)?;
+                }
+            }
+            Token::Close(name) => parser.close(name)?,
+        }
+    }
+    parser.finish()
+}
+
+#[derive(Clone, Copy)]
+struct Style {
+    transform: Transform,
+    color: Option<[u8; 3]>,
+    fill_opacity: f32,
+    opacity: f32,
+    even_odd: bool,
+    in_defs: bool,
+}
+
+enum Fill {
+    Inherit,
+    None,
+    Color([u8; 3]),
+}
+
+struct Parser<'a> {
+    document: Document,
+    stack: Vec<(&'a str, Style)>,
+    // ids of paths under <defs>, which only draw through a `use`. both tools
+    // write their defs first, so a use of an id not seen yet falls back
+    defs: HashMap<&'a str, usize>,
+    root_closed: bool,
+}
+
+impl<'a> Parser<'a> {
+    fn open(&mut self, name: &'a str, attributes: &[(&'a str, &'a str)]) -> Option<()> {
+        let Some(&(_, parent)) = self.stack.last() else {
+            if self.root_closed || name != "svg" {
+                return None;
+            }
+            let root = root_style(attributes)?;
+            self.stack.push((name, root));
+            return Some(());
+        };
+
+        let mut style = parent;
+        let mut fill = Fill::Inherit;
+        let mut own_transform = Transform::identity();
+        let (mut d, mut href) = (None, None);
+        let [mut x, mut y, mut width, mut height] = [None; 4];
+        for &(key, value) in attributes {
+            match key {
+                "id" => {}
+                "transform" => own_transform = parse_transform(value)?,
+                "fill" => fill = parse_fill(value)?,
+                "fill-rule" => {
+                    style.even_odd = match value.trim() {
+                        "nonzero" => false,
+                        "evenodd" => true,
+                        _ => return None,
+                    }
+                }
+                "fill-opacity" => style.fill_opacity = parse_opacity(value)?,
+                // usvg applies an element's own opacity as a group around it
+                "opacity" => style.opacity *= parse_opacity(value)?,
+                "stroke" if value.trim() == "none" => {}
+                "d" if name == "path" => d = Some(value),
+                "href" | "xlink:href" if name == "use" => href = Some(value),
+                "x" if matches!(name, "use" | "rect") => x = Some(parse_number(value)?),
+                "y" if matches!(name, "use" | "rect") => y = Some(parse_number(value)?),
+                "width" if name == "rect" => width = Some(parse_number(value)?),
+                "height" if name == "rect" => height = Some(parse_number(value)?),
+                _ => return None,
+            }
+        }
+        match fill {
+            Fill::Inherit => {}
+            Fill::None => style.color = None,
+            Fill::Color(color) => style.color = Some(color),
+        }
+        style.transform = concat(parent.transform, own_transform);
+
+        match name {
+            "g" => {}
+            "defs" => style.in_defs = true,
+            "path" => {
+                let path = parse_path_data(d?)?;
+                if style.in_defs {
+                    // a used element keeps its own presentation attributes,
+                    // which this doesn't track
+                    if attributes
+                        .iter()
+                        .any(|&(key, _)| !matches!(key, "id" | "d"))
+                    {
+                        return None;
+                    }
+                    if let (Some(path), Some(id)) = (path, attribute(attributes, "id")) {
+                        self.document.paths.push(path);
+                        self.defs.insert(id, self.document.paths.len() - 1);
+                    }
+                } else if let Some(path) = path {
+                    self.document.paths.push(path);
+                    self.draw(self.document.paths.len() - 1, style, Transform::identity());
+                }
+            }
+            // usvg applies a use's own transform twice (see tectonic.rs), and
+            // matching that is not worth it
+            "use" if !style.in_defs && attribute(attributes, "transform").is_none() => {
+                let path = *self.defs.get(href?.trim().strip_prefix('#')?)?;
+                let translate =
+                    Transform::from_translate(x.unwrap_or(0.0) as f32, y.unwrap_or(0.0) as f32);
+                self.draw(path, style, translate);
+            }
+            "rect" if !style.in_defs => {
+                let (x, y) = (x.unwrap_or(0.0) as f32, y.unwrap_or(0.0) as f32);
+                let (width, height) = (width? as f32, height? as f32);
+                if width > 0.0 && height > 0.0 {
+                    let mut builder = PathBuilder::new();
+                    builder.move_to(x, y);
+                    builder.line_to(x + width, y);
+                    builder.line_to(x + width, y + height);
+                    builder.line_to(x, y + height);
+                    builder.close();
+                    self.document.paths.push(builder.finish()?);
+                    self.draw(self.document.paths.len() - 1, style, Transform::identity());
+                }
+            }
+            _ => return None,
+        }
+
+        self.stack.push((name, style));
+        Some(())
+    }
+
+    fn draw(&mut self, path: usize, style: Style, transform: Transform) {
+        if let Some(color) = style.color {
+            self.document.draws.push(Draw {
+                path,
+                transform: concat(style.transform, transform),
+                color,
+                opacity: style.opacity * style.fill_opacity,
+                even_odd: style.even_odd,
+            });
+        }
+    }
+
+    fn close(&mut self, name: &str) -> Option<()> {
+        let (open, _) = self.stack.pop()?;
+        if open != name {
+            return None;
+        }
+        self.root_closed = self.stack.is_empty();
+        Some(())
+    }
+
+    fn finish(self) -> Option<Document> {
+        self.root_closed.then_some(self.document)
+    }
+}
+
+fn attribute<'a>(attributes: &[(&'a str, &'a str)], key: &str) -> Option<&'a str> {
+    attributes
+        .iter()
+        .find(|(name, _)| *name == key)
+        .map(|&(_, value)| value)
+}
+
+// the viewBox maps onto the width and height with the default xMidYMid meet
+fn root_style(attributes: &[(&str, &str)]) -> Option<Style> {
+    let (mut view_box, mut width, mut height) = (None, None, None);
+    for &(key, value) in attributes {
+        match key {
+            "xmlns" if value == SVG_NAMESPACE => {}
+            "xmlns:xlink" if value == XLINK_NAMESPACE => {}
+            "version" | "id" => {}
+            "width" => width = Some(parse_length(value)?),
+            "height" => height = Some(parse_length(value)?),
+            "viewBox" => {
+                let numbers = parse_numbers(value)?;
+                let [x, y, w, h] = numbers[..] else {
+                    return None;
+                };
+                if w <= 0.0 || h <= 0.0 {
+                    return None;
+                }
+                view_box = Some([x as f32, y as f32, w as f32, h as f32]);
+            }
+            _ => return None,
+        }
+    }
+
+    let transform = match (view_box, width, height) {
+        (None, Some(_), Some(_)) => Transform::identity(),
+        (Some([x, y, w, h]), Some(width), Some(height)) => {
+            let scale = (width / w).min(height / h);
+            Transform::from_row(
+                scale,
+                0.0,
+                0.0,
+                scale,
+                -x * scale + (width - w * scale) / 2.0,
+                -y * scale + (height - h * scale) / 2.0,
+            )
+        }
+        _ => return None,
+    };
+    Some(Style {
+        transform,
+        color: Some([0, 0, 0]),
+        fill_opacity: 1.0,
+        opacity: 1.0,
+        even_odd: false,
+        in_defs: false,
+    })
+}
+
+fn concat(parent: Transform, child: Transform) -> Transform {
+    let (a, b) = (parent, child);
+    let mul_add =
+        |p: f32, q: f32, r: f32, s: f32| (p as f64 * q as f64 + r as f64 * s as f64) as f32;
+    Transform::from_row(
+        mul_add(a.sx, b.sx, a.kx, b.ky),
+        mul_add(a.ky, b.sx, a.sy, b.ky),
+        mul_add(a.sx, b.kx, a.kx, b.sy),
+        mul_add(a.ky, b.kx, a.sy, b.sy),
+        mul_add(a.sx, b.tx, a.kx, b.ty) + a.tx,
+        mul_add(a.ky, b.tx, a.sy, b.ty) + a.ty,
+    )
+}
+
+fn parse_length(value: &str) -> Option<f32> {
+    let value = value.trim();
+    let split = value
+        .find(|ch: char| ch.is_ascii_alphabetic() || ch == '%')
+        .unwrap_or(value.len());
+    let (number, unit) = value.split_at(split);
+    let (_, scale) = LENGTH_UNITS.iter().find(|(name, _)| *name == unit)?;
+    Some(parse_number(number)? as f32 * scale)
+}
+
+fn parse_opacity(value: &str) -> Option<f32> {
+    Some(parse_number(value)?.clamp(0.0, 1.0) as f32)
+}
+
+fn parse_fill(value: &str) -> Option<Fill> {
+    let value = value.trim();
+    if value == "none" {
+        return Some(Fill::None);
+    }
+    if let Some(hex) = value.strip_prefix('#') {
+        let digits: Vec<_> = hex
+            .chars()
+            .map(|ch| ch.to_digit(16).map(|digit| digit as u8))
+            .collect::<Option<_>>()?;
+        return match digits[..] {
+            [r, g, b] => Some(Fill::Color([r * 17, g * 17, b * 17])),
+            [r1, r0, g1, g0, b1, b0] => {
+                Some(Fill::Color([r1 * 16 + r0, g1 * 16 + g0, b1 * 16 + b0]))
+            }
+            _ => None,
+        };
+    }
+    if let Some(channels) = value
+        .strip_prefix("rgb(")
+        .and_then(|value| value.strip_suffix(')'))
+    {
+        let channels: Vec<_> = channels
+            .split(',')
+            .map(|channel| {
+                let channel = channel.trim();
+                let value = match channel.strip_suffix('%') {
+                    Some(percent) => parse_number(percent)? * 2.55,
+                    None => parse_number(channel)?,
+                };
+                Some(value.round().clamp(0.0, 255.0) as u8)
+            })
+            .collect::<Option<_>>()?;
+        return match channels[..] {
+            [r, g, b] => Some(Fill::Color([r, g, b])),
+            _ => None,
+        };
+    }
+    match value {
+        "black" => Some(Fill::Color([0, 0, 0])),
+        "white" => Some(Fill::Color([255, 255, 255])),
+        _ => None,
+    }
+}
+
+fn parse_number(value: &str) -> Option<f64> {
+    let mut cursor = Cursor::new(value);
+    let number = cursor.number()?;
+    cursor.skip_separators();
+    cursor.at_end().then_some(number)
+}
+
+fn parse_numbers(value: &str) -> Option<Vec<f64>> {
+    let mut cursor = Cursor::new(value);
+    let mut numbers = Vec::new();
+    cursor.skip_separators();
+    while !cursor.at_end() {
+        numbers.push(cursor.number()?);
+        cursor.skip_separators();
+    }
+    Some(numbers)
+}
+
+fn parse_transform(value: &str) -> Option<Transform> {
+    // composed in f64 and rounded once, as svgtypes does
+    let mut ts = [1.0, 0.0, 0.0, 1.0, 0.0, 0.0f64];
+    let mut rest = value.trim_start();
+    while !rest.is_empty() {
+        let open = rest.find('(')?;
+        let close = rest.find(')')?;
+        let name = rest[..open].trim();
+        let args = parse_numbers(&rest[open + 1..close])?;
+        let [a, b, c, d, e, f] = match (name, &args[..]) {
+            ("matrix", &[a, b, c, d, e, f]) => [a, b, c, d, e, f],
+            ("translate", &[x]) => [1.0, 0.0, 0.0, 1.0, x, 0.0],
+            ("translate", &[x, y]) => [1.0, 0.0, 0.0, 1.0, x, y],
+            ("scale", &[s]) => [s, 0.0, 0.0, s, 0.0, 0.0],
+            ("scale", &[x, y]) => [x, 0.0, 0.0, y, 0.0, 0.0],
+            ("rotate", &[angle]) => rotation(angle, 0.0, 0.0),
+            ("rotate", &[angle, cx, cy]) => rotation(angle, cx, cy),
+            ("skewX", &[angle]) => [1.0, 0.0, angle.to_radians().tan(), 1.0, 0.0, 0.0],
+            ("skewY", &[angle]) => [1.0, angle.to_radians().tan(), 0.0, 1.0, 0.0, 0.0],
+            _ => return None,
+        };
+        ts = [
+            ts[0] * a + ts[2] * b,
+            ts[1] * a + ts[3] * b,
+            ts[0] * c + ts[2] * d,
+            ts[1] * c + ts[3] * d,
+            ts[0] * e + ts[2] * f + ts[4],
+            ts[1] * e + ts[3] * f + ts[5],
+        ];
+        rest =
+            rest[close + 1..].trim_start_matches(|ch: char| ch.is_ascii_whitespace() || ch == ',');
+    }
+    let [sx, ky, kx, sy, tx, ty] = ts.map(|value| value as f32);
+    Some(Transform::from_row(sx, ky, kx, sy, tx, ty))
+}
+
+fn rotation(angle: f64, cx: f64, cy: f64) -> [f64; 6] {
+    let (sin, cos) = angle.to_radians().sin_cos();
+    [
+        cos,
+        sin,
+        -sin,
+        cos,
+        cx - cos * cx + sin * cy,
+        cy - sin * cx - cos * cy,
+    ]
+}
+
+// the same builder calls usvg makes for path data, after converting relative,
+// shorthand and smooth commands to absolute ones. None for data usvg would
+// read differently (arcs, or an error it would stop at); Some(None) when the
+// data draws nothing
+fn parse_path_data(data: &str) -> Option<Option<Path>> {
+    let mut builder = PathBuilder::new();
+    let mut cursor = Cursor::new(data);
+    let (mut x, mut y) = (0.0f64, 0.0f64);
+    let (mut start_x, mut start_y) = (0.0f64, 0.0f64);
+    // the control point a following smooth curve reflects, if it may
+    let mut last_cubic: Option<(f64, f64)> = None;
+    let mut last_quad: Option<(f64, f64)> = None;
+    let mut command = None;
+
+    cursor.skip_separators();
+    while !cursor.at_end() {
+        let next = match cursor.command() {
+            Some(next) => next,
+            // repeated arguments repeat the command, a moveto as a lineto
+            None => match command? {
+                'M' => 'L',
+                'm' => 'l',
+                'Z' | 'z' => return None,
+                previous => previous,
+            },
+        };
+        command = Some(next);
+        let relative = next.is_ascii_lowercase();
+        let (ox, oy) = if relative { (x, y) } else { (0.0, 0.0) };
+        let point = |cursor: &mut Cursor| -> Option<(f64, f64)> {
+            let px = cursor.number()?;
+            cursor.skip_separators();
+            let py = cursor.number()?;
+            cursor.skip_separators();
+            Some((px + ox, py + oy))
+        };
+
+        let (mut cubic, mut quad) = (None, None);
+        match next.to_ascii_uppercase() {
+            'M' => {
+                (x, y) = point(&mut cursor)?;
+                (start_x, start_y) = (x, y);
+                builder.move_to(x as f32, y as f32);
+            }
+            'L' => {
+                (x, y) = point(&mut cursor)?;
+                builder.line_to(x as f32, y as f32);
+            }
+            'H' => {
+                x = cursor.number()? + ox;
+                cursor.skip_separators();
+                builder.line_to(x as f32, y as f32);
+            }
+            'V' => {
+                y = cursor.number()? + oy;
+                cursor.skip_separators();
+                builder.line_to(x as f32, y as f32);
+            }
+            'C' | 'S' => {
+                let first = if next.eq_ignore_ascii_case(&'C') {
+                    point(&mut cursor)?
+                } else {
+                    last_cubic.map_or((x, y), |(cx, cy)| (2.0 * x - cx, 2.0 * y - cy))
+                };
+                let second = point(&mut cursor)?;
+                (x, y) = point(&mut cursor)?;
+                builder.cubic_to(
+                    first.0 as f32,
+                    first.1 as f32,
+                    second.0 as f32,
+                    second.1 as f32,
+                    x as f32,
+                    y as f32,
+                );
+                cubic = Some(second);
+            }
+            'Q' | 'T' => {
+                let control = if next.eq_ignore_ascii_case(&'Q') {
+                    point(&mut cursor)?
+                } else {
+                    last_quad.map_or((x, y), |(cx, cy)| (2.0 * x - cx, 2.0 * y - cy))
+                };
+                (x, y) = point(&mut cursor)?;
+                builder.quad_to(control.0 as f32, control.1 as f32, x as f32, y as f32);
+                quad = Some(control);
+            }
+            'Z' => {
+                builder.close();
+                (x, y) = (start_x, start_y);
+                cursor.skip_separators();
+            }
+            _ => return None,
+        }
+        (last_cubic, last_quad) = (cubic, quad);
+    }
+
+    Some(builder.finish().filter(|path| path.len() >= 2))
+}
+
+struct Cursor<'a> {
+    bytes: &'a [u8],
+    position: usize,
+}
+
+impl<'a> Cursor<'a> {
+    fn new(text: &'a str) -> Self {
+        Self {
+            bytes: text.as_bytes(),
+            position: 0,
+        }
+    }
+
+    fn at_end(&self) -> bool {
+        self.position >= self.bytes.len()
+    }
+
+    fn peek(&self) -> Option<u8> {
+        self.bytes.get(self.position).copied()
+    }
+
+    fn skip_separators(&mut self) {
+        while let Some(byte) = self.peek() {
+            if !byte.is_ascii_whitespace() && byte != b',' {
+                break;
+            }
+            self.position += 1;
+        }
+    }
+
+    fn command(&mut self) -> Option<char> {
+        let byte = self.peek()?;
+        if byte.is_ascii_alphabetic() {
+            self.position += 1;
+            self.skip_separators();
+            Some(byte as char)
+        } else {
+            None
+        }
+    }
+
+    // an svg number: sign, digits with an optional fraction, optional exponent
+    fn number(&mut self) -> Option<f64> {
+        let start = self.position;
+        if matches!(self.peek(), Some(b'+' | b'-')) {
+            self.position += 1;
+        }
+        let mut digits = self.digits();
+        if self.peek() == Some(b'.') {
+            self.position += 1;
+            digits += self.digits();
+        }
+        if digits == 0 {
+            self.position = start;
+            return None;
+        }
+        if matches!(self.peek(), Some(b'e' | b'E')) {
+            let mantissa_end = self.position;
+            self.position += 1;
+            if matches!(self.peek(), Some(b'+' | b'-')) {
+                self.position += 1;
+            }
+            if self.digits() == 0 {
+                self.position = mantissa_end;
+            }
+        }
+        std::str::from_utf8(&self.bytes[start..self.position])
+            .ok()?
+            .parse()
+            .ok()
+    }
+
+    fn digits(&mut self) -> usize {
+        let start = self.position;
+        while self.peek().is_some_and(|byte| byte.is_ascii_digit()) {
+            self.position += 1;
+        }
+        self.position - start
+    }
+}
+
+enum Token<'a> {
+    Open {
+        name: &'a str,
+        attributes: Vec<(&'a str, &'a str)>,
+        closed: bool,
+    },
+    Close(&'a str),
+}
+
+// just enough xml for the markup these tools write: no entities, no cdata and
+// no doctype, all of which make the caller fall back
+struct Tokenizer<'a> {
+    rest: &'a str,
+}
+
+impl<'a> Tokenizer<'a> {
+    // Some(None) at the end of the input, None on anything unsupported
+    fn next(&mut self) -> Option<Option<Token<'a>>> {
+        loop {
+            let Some(open) = self.rest.find('<') else {
+                return self.rest.trim().is_empty().then_some(None);
+            };
+            if self.rest[..open].contains('&') {
+                return None;
+            }
+            self.rest = &self.rest[open..];
+            if let Some(rest) = self.rest.strip_prefix("<?") {
+                self.rest = &rest[rest.find("?>")? + 2..];
+            } else if let Some(rest) = self.rest.strip_prefix("<!--") {
+                self.rest = &rest[rest.find("-->")? + 3..];
+            } else if self.rest.starts_with("<!") {
+                return None;
+            } else if let Some(rest) = self.rest.strip_prefix("</") {
+                let end = rest.find('>')?;
+                self.rest = &rest[end + 1..];
+                return Some(Some(Token::Close(rest[..end].trim())));
+            } else {
+                return self.open_tag().map(Some);
+            }
+        }
+    }
+
+    fn open_tag(&mut self) -> Option<Token<'a>> {
+        let rest = &self.rest[1..];
+        let name_end = rest.find(|ch: char| ch.is_ascii_whitespace() || ch == '/' || ch == '>')?;
+        let name = &rest[..name_end];
+        if name.is_empty() || name.contains(':') {
+            return None;
+        }
+        let mut rest = &rest[name_end..];
+        let mut attributes = Vec::new();
+        loop {
+            rest = rest.trim_start();
+            if let Some(after) = rest.strip_prefix("/>") {
+                self.rest = after;
+                return Some(Token::Open {
+                    name,
+                    attributes,
+                    closed: true,
+                });
+            }
+            if let Some(after) = rest.strip_prefix('>') {
+                self.rest = after;
+                return Some(Token::Open {
+                    name,
+                    attributes,
+                    closed: false,
+                });
+            }
+
+            let equals = rest.find('=')?;
+            let key = rest[..equals].trim();
+            let value = rest[equals + 1..].trim_start();
+            let quote = value.chars().next().filter(|ch| matches!(ch, '"' | '\''))?;
+            let value = &value[1..];
+            let end = value.find(quote)?;
+            if key.is_empty() || value[..end].contains(['&', '<']) {
+                return None;
+            }
+            attributes.push((key, &value[..end]));
+            rest = &value[end + 1..];
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use tiny_skia_path::{PathSegment, Point};
+
+    use super::*;
+
+    const DVISVGM: &str = "<?xml version='1.0' encoding='UTF-8'?>
+<!-- This file was generated by dvisvgm 3.2.2 -->
+<svg version='1.1' xmlns='http://www.w3.org/2000/svg' xmlns:xlink='http://www.w3.org/1999/xlink' width='12pt' height='6pt' viewBox='50 -10 12 6'>
+<defs>
+<path id='g0-49' d='M1 0h2v-4l-1 .5V-5L3.5-6H4V0h2v1H1z'/>
+<path id='g1-120' d='M0 0Q1 1 2 0T4 0C5 1 6 1 7 0S9-1 10 0L10 2H0Z'/>
+</defs>
+<g id='page1'>
+<use x='50' y='-5' xlink:href='#g0-49'/>
+<g fill='#ff0102' fill-rule='evenodd'>
+<use x='57' y='-5' xlink:href='#g1-120'/>
+<rect x='50' y='-7' height='.5' width='12'/>
+</g>
+<use x='60' y='-5' xlink:href='#g0-49' opacity='0.5'/>
+</g>
+</svg>
+";
+
+    // a hayro-svg page as tectonic hands it to the importer: glyph outlines in
+    // font units, each inlined from <defs> by expand_glyph_uses with the
+    // placing matrix, and a fraction rule drawn in page space
+    const HAYRO: &str = r##"<svg xmlns="http://www.w3.org/2000/svg" xmlns:xlink="http://www.w3.org/1999/xlink" width="21.932" height="19.347" viewBox="0 0 21.932 19.347">
+<g>
+<path d="M 394 0 L 394 31 C 311 31 269 41 269 62 L 269 665 C 234 648 189 640 133 640 L 133 671 C 219 671 283 694 325 739 L 349 739 C 353 739 356 737 359 734 C 362 731 364 728 364 725 L 364 62 C 364 41 322 31 239 31 L 239 0 Z" transform="matrix(0.00996264 0 0 -0.00996264 7.473 7.385)" fill="#000000" fill-rule="nonzero"/>
+<path d="M 326 272 C 344 301 376 330 422 359 Q 435 367 435 375 Q 435 386 423 386 L 380 384 L 334 386 Q 317 386 317 369 Q 317 356 332 347 L 244 206 L 163 372 Q 170 386 190 386 L 190 417 L 46 417 L 46 386 Q 100 386 114 357 L 214 151 L 100 -21 Z" transform="matrix(0.00996264 0 0 -0.00996264 2.989 17.458)" fill="rgb(204, 0, 0)" fill-rule="evenodd"/>
+<path d="M 1.993 9.873 L 19.94 9.873 L 19.94 10.271 L 1.993 10.271 Z" fill="#000000"/>
+<path d="M 394 0 L 394 31 C 311 31 269 41 269 62 L 269 665 C 234 648 189 640 133 640 L 133 671 C 219 671 283 694 325 739 L 349 739 L 364 725 L 364 62 C 364 41 322 31 239 31 L 239 0 Z" transform="matrix(0.00996264 0 0 -0.00996264 12.455 17.458)" fill="#000000" fill-opacity="0.5"/>
+</g>
+</svg>
+"##;
+
+    fn point(x: f32, y: f32) -> Point {
+        Point::from_xy(x, y)
+    }
+
+    #[test]
+    fn dvisvgm_output_is_read_directly() {
+        let document = parse(DVISVGM).unwrap();
+        assert_eq!(document.draws.len(), 4);
+        let colors: Vec<_> = document.draws.iter().map(|draw| draw.color).collect();
+        assert_eq!(colors, [[0, 0, 0], [255, 1, 2], [255, 1, 2], [0, 0, 0]]);
+        let opacities: Vec<_> = document.draws.iter().map(|draw| draw.opacity).collect();
+        assert_eq!(opacities, [1.0, 1.0, 1.0, 0.5]);
+        assert!(!document.draws[0].even_odd && document.draws[1].even_odd);
+        assert_eq!(document.draws[0].path, document.draws[3].path);
+
+        // 12pt is 16px across a 12 unit viewBox
+        let scale = 4.0 / 3.0;
+        let mut origin = point(0.0, 0.0);
+        document.draws[1].transform.map_point(&mut origin);
+        assert!((origin.x - 7.0 * scale).abs() < 1e-5);
+        assert!((origin.y - 5.0 * scale).abs() < 1e-5);
+
+        let digit: Vec<_> = document.paths[document.draws[0].path].segments().collect();
+        assert_eq!(digit[0], PathSegment::MoveTo(point(1.0, 0.0)));
+        assert_eq!(digit[1], PathSegment::LineTo(point(3.0, 0.0)));
+        assert_eq!(digit[2], PathSegment::LineTo(point(3.0, -4.0)));
+        assert_eq!(digit[3], PathSegment::LineTo(point(2.0, -3.5)));
+        assert_eq!(digit[4], PathSegment::LineTo(point(2.0, -5.0)));
+        assert_eq!(digit[5], PathSegment::LineTo(point(3.5, -6.0)));
+        assert_eq!(digit.last(), Some(&PathSegment::Close));
+
+        let curves: Vec<_> = document.paths[document.draws[1].path].segments().collect();
+        assert_eq!(
+            curves[2],
+            PathSegment::QuadTo(point(3.0, -1.0), point(4.0, 0.0))
+        );
+        assert_eq!(
+            curves[4],
+            PathSegment::CubicTo(point(8.0, -1.0), point(9.0, -1.0), point(10.0, 0.0))
+        );
+    }
+
+    // what an importer hands the tessellator for one draw
+    #[derive(Debug)]
+    struct Imported {
+        segments: Vec<PathSegment>,
+        transform: Transform,
+        color: [u8; 3],
+        opacity: f32,
+        even_odd: bool,
+    }
+
+    fn through_subset(svg: &str) -> Vec<Imported> {
+        let document = parse(svg).expect("the subset should read this document");
+        document
+            .draws
+            .iter()
+            .map(|draw| Imported {
+                segments: document.paths[draw.path].segments().collect(),
+                transform: draw.transform,
+                color: draw.color,
+                opacity: draw.opacity,
+                even_odd: draw.even_odd,
+            })
+            .collect()
+    }
+
+    // walks the tree the way svg.rs does for fills
+    fn through_usvg(svg: &str) -> Vec<Imported> {
+        fn collect(group: &usvg::Group, inherited_opacity: f32, out: &mut Vec<Imported>) {
+            let opacity = inherited_opacity * group.opacity().get();
+            for child in group.children() {
+                match child {
+                    usvg::Node::Group(group) => collect(group, opacity, out),
+                    usvg::Node::Path(path) => {
+                        let Some(fill) = path.fill().filter(|_| path.is_visible()) else {
+                            continue;
+                        };
+                        let usvg::Paint::Color(color) = fill.paint() else {
+                            continue;
+                        };
+                        out.push(Imported {
+                            segments: path.data().segments().collect(),
+                            transform: path.abs_transform(),
+                            color: [color.red, color.green, color.blue],
+                            opacity: fill.opacity().get() * opacity,
+                            even_odd: matches!(fill.rule(), usvg::FillRule::EvenOdd),
+                        });
+                    }
+                    _ => {}
+                }
+            }
+        }
+        let tree = usvg::Tree::from_str(svg, &usvg::Options::default()).unwrap();
+        let mut out = Vec::new();
+        collect(tree.root(), 1.0, &mut out);
+        out
+    }
+
+    fn segment_points(segment: PathSegment) -> Vec<Point> {
+        match segment {
+            PathSegment::MoveTo(p) | PathSegment::LineTo(p) => vec![p],
+            PathSegment::QuadTo(p0, p1) => vec![p0, p1],
+            PathSegment::CubicTo(p0, p1, p2) => vec![p0, p1, p2],
+            PathSegment::Close => vec![],
+        }
+    }
+
+    fn close(lhs: f32, rhs: f32) -> bool {
+        (lhs - rhs).abs() <= 1e-4 * (1.0 + lhs.abs().max(rhs.abs()))
+    }
+
+    #[test]
+    fn draws_match_usvg() {
+        for svg in [DVISVGM, HAYRO] {
+            let (subset, tree) = (through_subset(svg), through_usvg(svg));
+            assert_eq!(subset.len(), tree.len());
+            for (ours, theirs) in subset.iter().zip(&tree) {
+                assert_eq!(ours.color, theirs.color);
+                assert_eq!(ours.even_odd, theirs.even_odd);
+                assert!(close(ours.opacity, theirs.opacity));
+                let components = |transform: Transform| {
+                    let Transform {
+                        sx,
+                        ky,
+                        kx,
+                        sy,
+                        tx,
+                        ty,
+                    } = transform;
+                    [sx, ky, kx, sy, tx, ty]
+                };
+                let (lhs, rhs) = (components(ours.transform), components(theirs.transform));
+                assert!(
+                    lhs.iter().zip(&rhs).all(|(&lhs, &rhs)| close(lhs, rhs)),
+                    "{ours:?} vs {theirs:?}"
+                );
+
+                assert_eq!(ours.segments.len(), theirs.segments.len());
+                for (&lhs, &rhs) in ours.segments.iter().zip(&theirs.segments) {
+                    assert_eq!(
+                        std::mem::discriminant(&lhs),
+                        std::mem::discriminant(&rhs),
+                        "{lhs:?} vs {rhs:?}"
+                    );
+                    let (lhs, rhs) = (segment_points(lhs), segment_points(rhs));
+                    assert!(
+                        lhs.iter()
+                            .zip(&rhs)
+                            .all(|(lhs, rhs)| close(lhs.x, rhs.x) && close(lhs.y, rhs.y))
+                    );
+                }
+            }
+        }
+    }
+
+    #[test]
+    fn rules_are_rect_paths() {
+        let document = parse(DVISVGM).unwrap();
+        let rect: Vec<_> = document.paths[document.draws[2].path].segments().collect();
+        assert_eq!(
+            rect,
+            [
+                PathSegment::MoveTo(point(50.0, -7.0)),
+                PathSegment::LineTo(point(62.0, -7.0)),
+                PathSegment::LineTo(point(62.0, -6.5)),
+                PathSegment::LineTo(point(50.0, -6.5)),
+                PathSegment::Close,
+            ]
+        );
+    }
+
+    #[test]
+    fn transforms_compose_like_svg() {
+        let transform = parse_transform("translate(10 20) scale(2), rotate(90)").unwrap();
+        let mut p = point(1.0, 0.0);
+        transform.map_point(&mut p);
+        assert!((p.x - 10.0).abs() < 1e-5 && (p.y - 22.0).abs() < 1e-5);
+
+        let matrix = parse_transform("matrix(1,0,0,-1,5,5)").unwrap();
+        assert_eq!(matrix, Transform::from_row(1.0, 0.0, 0.0, -1.0, 5.0, 5.0));
+    }
+
+    #[test]
+    fn unsupported_markup_falls_back() {
+        let wrap = |body: &str| {
+            format!("<svg xmlns='http://www.w3.org/2000/svg' width='10' height='10'>{body}</svg>")
+        };
+        assert!(parse(&wrap("<path d='M0 0L1 0L1 1Z'/>")).is_some());
+        for body in [
+            "<path d='M0 0A1 1 0 0 1 2 2Z'/>",
+            "<path d='M0 0L1 0L1 1Z' stroke='#000'/>",
+            "<path d='M0 0L1 0L1 1Z' style='fill:red'/>",
+            "<path d='M0 0L1 0L1 1Z' fill='url(#g)'/>",
+            "<text>x</text>",
+            "<g clip-path='url(#c)'><path d='M0 0L1 1L0 1Z'/></g>",
+            "<use xlink:href='#missing'/>",
+            "<defs><path id='p' d='M0 0L1 0L1 1Z' fill='#f00'/></defs><use xlink:href='#p'/>",
+            "<defs><path id='p' d='M0 0L1 0L1 1Z'/></defs><use xlink:href='#p' transform='scale(2)'/>",
+            "<use xlink:href='#later'/><defs><path id='later' d='M0 0L1 0L1 1Z'/></defs>",
+            "<path d='M0 0L1 0L1 1Z'>",
+            "<![CDATA[x]]>",
+        ] {
+            assert!(parse(&wrap(body)).is_none(), "{body}");
+        }
+    }
+}
@@ -47,6 +47,16 @@ pub enum RenderQuality {
     High,
 }
 
+#[derive(Clone, Copy, Debug, Default, Eq, PartialEq)]
+pub struct MemoryCacheStats {
+    pub hits: u64,
+    pub misses: u64,
+    pub evictions: u64,
+    // estimated size of the cached meshes
+    pub bytes: usize,
+    pub entries: usize,
+}
+
 #[derive(Clone, Debug)]
 pub struct RenderedOutput {
     pub meshes: Vec<Arc<Mesh>>,
@@ -1,25 +1,133 @@
 use std::{env, path::PathBuf};
 
+// (library, symbol prefix, defines) for each kernel the wrapper can dispatch
+// to; all kernels link into the same binary, so every external symbol is
+// renamed per kernel
+const KERNELS: &[(&str, &str, &[(&str, &str)])] = &[
+    (
+        "tess2_upstream_f32",
+        "tess2_f32_",
+        &[("TESS_REAL", "float")],
+    ),
+    (
+        "tess2_upstream_f64",
+        "tess2_f64_",
+        &[("TESS_REAL", "double")],
+    ),
+    (
+        "tess2_upstream_grid",
+        "tess2_grid_",
+        &[("TESS_REAL", "float"), ("TESS_INTEGER_GRID", "1")],
+    ),
+];
+
+const EXTERNAL_SYMBOLS: &[&str] = &[
+    "IsValidCoord",
+    "OutputContours",
+    "OutputPolymesh",
+    "bucketAlloc",
+    "bucketFree",
+    "createBucketAlloc",
+    "deleteBucketAlloc",
+    "dictDelete",
+    "dictDeleteDict",
+    "dictInsertBefore",
+    "dictNewDict",
+    "dictSearch",
+    "heapAlloc",
+    "heapFree",
+    "heapRealloc",
+    "inCircle",
+    "pqDelete",
+    "pqDeletePriorityQ",
+    "pqExtractMin",
+    "pqHeapDelete",
+    "pqHeapDeletePriorityQ",
+    "pqHeapExtractMin",
+    "pqHeapInit",
+    "pqHeapInsert",
+    "pqHeapNewPriorityQ",
+    "pqInit",
+    "pqInsert",
+    "pqIsEmpty",
+    "pqMinimum",
+    "pqNewPriorityQ",
+    "stackDelete",
+    "stackEmpty",
+    "stackInit",
+    "stackPop",
+    "stackPush",
+    "tesedgeEval",
+    "tesedgeEvalGeq",
+    "tesedgeIntersect",
+    "tesedgeIsLocallyDelaunay",
+    "tesedgeSign",
+    "tessAddContour",
+    "tessComputeInterior",
+    "tessDeleteTess",
+    "tessGetElementCount",
+    "tessGetElements",
+    "tessGetIntersectionCount",
+    "tessGetStatus",
+    "tessGetVertexCount",
+    "tessGetVertexIndices",
+    "tessGetVertices",
+    "tessMeshAddEdgeVertex",
+    "tessMeshCheckMesh",
+    "tessMeshConnect",
+    "tessMeshDelete",
+    "tessMeshDeleteMesh",
+    "tessMeshDiscardExterior",
+    "tessMeshFlipEdge",
+    "tessMeshMakeEdge",
+    "tessMeshMergeConvexFaces",
+    "tessMeshNewMesh",
+    "tessMeshRefineDelaunay",
+    "tessMeshSetWindingNumber",
+    "tessMeshSplice",
+    "tessMeshSplitEdge",
+    "tessMeshTessellateInterior",
+    "tessMeshTessellateMonoRegion",
+    "tessMeshUnion",
+    "tessMeshZapFace",
+    "tessNewTess",
+    "tessProjectPolygon",
+    "tessSetOption",
+    "tessTesselate",
+    "testransEval",
+    "testransSign",
+    "tesvertCCW",
+    "tesvertLeq",
+];
+
 fn main() {
     let manifest_dir = PathBuf::from(env::var("CARGO_MANIFEST_DIR").unwrap());
     let upstream_dir = manifest_dir.join("upstream");
     let source_dir = upstream_dir.join("Source");
     let include_dir = upstream_dir.join("Include");
 
-    let mut build = cc::Build::new();
-    build
-        .include(&source_dir)
-        .include(&include_dir)
-        .warnings(false)
-        .file(source_dir.join("bucketalloc.c"))
-        .file(source_dir.join("dict.c"))
-        .file(source_dir.join("geom.c"))
-        .file(source_dir.join("mesh.c"))
-        .file(source_dir.join("priorityq.c"))
-        .file(source_dir.join("sweep.c"))
-        .file(source_dir.join("tess.c"));
+    for &(library, prefix, defines) in KERNELS {
+        let mut build = cc::Build::new();
+        build
+            .include(&source_dir)
+            .include(&include_dir)
+            .warnings(false)
+            .file(source_dir.join("bucketalloc.c"))
+            .file(source_dir.join("dict.c"))
+            .file(source_dir.join("geom.c"))
+            .file(source_dir.join("mesh.c"))
+            .file(source_dir.join("priorityq.c"))
+            .file(source_dir.join("sweep.c"))
+            .file(source_dir.join("tess.c"));
+        for &(name, value) in defines {
+            build.define(name, value);
+        }
+        for symbol in EXTERNAL_SYMBOLS {
+            build.define(symbol, format!("{prefix}{symbol}").as_str());
+        }
 
-    build.compile("tess2_upstream");
+        build.compile(library);
+    }
 
     println!("cargo:rerun-if-changed={}", source_dir.display());
     println!("cargo:rerun-if-changed={}", include_dir.display());
@@ -0,0 +1,397 @@
+use crate::{
+    Float3, Precision, Tessellation, TessellationOptions, TessellationStats, contour_area_normal,
+    monotone::refine_delaunay, polygon_basis,
+};
+
+type Point = [f64; 2];
+
+// a batch of two strictly convex loops, one strictly inside the other and wound
+// the opposite way, is a ring whose triangulation is a single strip between
+// them. both loops are walked counter-clockwise in order of angle about the
+// inner loop's centroid, emitting one triangle per vertex, and with
+// constrained_delaunay the strip is then flipped like the monotone path's.
+// vertices come back in input order with their source indices, as the sweep
+// would report them.
+// returns None whenever the batch is not such a ring (or the winding rule does
+// not fill exactly the band), leaving it to the sweep
+pub(crate) fn triangulate_annulus(
+    contours: &[(usize, Vec<Float3>)],
+    source_offsets: &[usize],
+    options: TessellationOptions,
+) -> Option<Tessellation> {
+    let [(first_idx, first), (second_idx, second)] = contours else {
+        return None;
+    };
+    // snapping to a grid and reversing are left to the sweep so their
+    // results stay bit-identical
+    if options.reverse_contours || matches!(options.precision, Precision::Grid { .. }) {
+        return None;
+    }
+    if first.len() < 3 || second.len() < 3 {
+        return None;
+    }
+    let first_normal = contour_area_normal(first)?;
+    let second_normal = contour_area_normal(second)?;
+    if first_normal.dot(second_normal) >= 0.0 {
+        return None;
+    }
+
+    let normal = options
+        .normal
+        .filter(|normal| normal.len_sq() > 0.0)
+        .map(Float3::normalize);
+    let (basis_x, basis_y, _) = polygon_basis(normal.unwrap_or(first_normal));
+    let project = |contour: &[Float3]| -> Vec<Point> {
+        contour
+            .iter()
+            .map(|&point| [point.dot(basis_x) as f64, point.dot(basis_y) as f64])
+            .collect()
+    };
+    let (first_points, second_points) = (project(first), project(second));
+    let (first_area, second_area) = (signed_area(&first_points), signed_area(&second_points));
+    let first_is_outer = first_area.abs() > second_area.abs();
+    let (outer, inner, outer_area) = if first_is_outer {
+        (&first_points, &second_points, first_area)
+    } else {
+        (&second_points, &first_points, second_area)
+    };
+    if first_area * second_area >= 0.0 {
+        return None;
+    }
+    // without a normal, libtess2 orients the plane so the outer loop is
+    // counter-clockwise, and so are the triangles
+    let (winding, flip) = match normal {
+        Some(_) => (outer_area.signum() as i32, false),
+        None => (1, outer_area < 0.0),
+    };
+    if !options.winding_rule.is_inside(winding) || options.winding_rule.is_inside(0) {
+        return None;
+    }
+
+    let extent = outer
+        .iter()
+        .chain(inner.iter())
+        .flatten()
+        .fold(0.0f64, |max, value| max.max(value.abs()));
+    let tolerance = extent * extent * f32::EPSILON as f64;
+    let center = inner
+        .iter()
+        .fold([0.0, 0.0], |sum, point| {
+            [sum[0] + point[0], sum[1] + point[1]]
+        })
+        .map(|sum| sum / inner.len() as f64);
+
+    // counter-clockwise loops as indices into the projected points, starting
+    // at the smallest angle about the center
+    let outer_loop = angular_loop(outer, outer_area < 0.0, center)?;
+    let inner_loop = angular_loop(inner, outer_area > 0.0, center)?;
+
+    let (outer_offset, inner_offset) = if first_is_outer {
+        (0, first.len())
+    } else {
+        (first.len(), 0)
+    };
+    let mut triangles = Vec::with_capacity(outer.len() + inner.len());
+    let (mut o, mut i) = (0, 0);
+    while o < outer_loop.len() || i < inner_loop.len() {
+        let (outer_at, outer_next) = (outer_loop.at(o), outer_loop.at(o + 1));
+        let (inner_at, inner_next) = (inner_loop.at(i), inner_loop.at(i + 1));
+        let advance_outer = i == inner_loop.len()
+            || (o < outer_loop.len() && outer_loop.angle(o + 1) <= inner_loop.angle(i + 1));
+        let triangle = if advance_outer {
+            // with every triangle counter-clockwise, each point is covered as
+            // often as the outer loop winds around it minus the inner loop, so
+            // none may go negative: the inner loop lies inside and nothing
+            // overlaps
+            if cross(outer[outer_at], outer[outer_next], inner[inner_at]) <= tolerance {
+                return None;
+            }
+            o += 1;
+            [
+                outer_offset + outer_at,
+                outer_offset + outer_next,
+                inner_offset + inner_at,
+            ]
+        } else {
+            if cross(outer[outer_at], inner[inner_next], inner[inner_at]) <= tolerance {
+                return None;
+            }
+            i += 1;
+            [
+                outer_offset + outer_at,
+                inner_offset + inner_next,
+                inner_offset + inner_at,
+            ]
+        };
+        triangles.push(triangle);
+    }
+    if options.constrained_delaunay {
+        let points: Vec<Point> = first_points
+            .iter()
+            .chain(second_points.iter())
+            .copied()
+            .collect();
+        // the loops are the constraints: consecutive vertices of either one
+        let loop_edge = |a: usize, b: usize| {
+            let (start, len) = if a < first.len() {
+                (0, first.len())
+            } else {
+                (first.len(), second.len())
+            };
+            let range = start..start + len;
+            range.contains(&b)
+                && ((a + 1 - start) % len == b - start || (b + 1 - start) % len == a - start)
+        };
+        refine_delaunay(&points, &mut triangles, loop_edge);
+    }
+    if flip {
+        for triangle in &mut triangles {
+            triangle.swap(1, 2);
+        }
+    }
+
+    let vertices: Vec<_> = first.iter().chain(second.iter()).copied().collect();
+    let source_vertex_indices = (0..first.len())
+        .map(|vertex| Some(source_offsets[*first_idx] + vertex))
+        .chain((0..second.len()).map(|vertex| Some(source_offsets[*second_idx] + vertex)))
+        .collect();
+    Some(Tessellation {
+        vertices,
+        source_vertex_indices,
+        triangles,
+        stats: TessellationStats {
+            strip_batches: 1,
+            ..TessellationStats::default()
+        },
+    })
+}
+
+struct AngularLoop {
+    order: Vec<usize>,
+    angles: Vec<f64>,
+}
+
+impl AngularLoop {
+    fn len(&self) -> usize {
+        self.order.len()
+    }
+
+    fn at(&self, step: usize) -> usize {
+        self.order[step % self.order.len()]
+    }
+
+    // angles keep increasing past a full turn so the two walks compare
+    fn angle(&self, step: usize) -> f64 {
+        let turns = (step / self.order.len()) as f64;
+        self.angles[step % self.order.len()] + turns * std::f64::consts::TAU
+    }
+}
+
+// None unless the loop is strictly convex and sweeps once around the center.
+// finely sampled curves turn very little per vertex, so any left turn counts
+fn angular_loop(points: &[Point], reversed: bool, center: Point) -> Option<AngularLoop> {
+    let count = points.len();
+    let mut order: Vec<usize> = (0..count).collect();
+    if reversed {
+        order.reverse();
+    }
+    for step in 0..count {
+        let [a, b, c] = [step, step + 1, step + 2].map(|at| points[order[at % count]]);
+        if cross(a, b, c) <= 0.0 {
+            return None;
+        }
+    }
+
+    let angle = |idx: usize| (points[idx][1] - center[1]).atan2(points[idx][0] - center[0]);
+    let start = (0..count).min_by(|&lhs, &rhs| angle(order[lhs]).total_cmp(&angle(order[rhs])))?;
+    order.rotate_left(start);
+    let angles: Vec<_> = order.iter().map(|&idx| angle(idx)).collect();
+    if angles.windows(2).any(|pair| pair[1] <= pair[0]) {
+        return None;
+    }
+    Some(AngularLoop { order, angles })
+}
+
+fn signed_area(points: &[Point]) -> f64 {
+    (0..points.len())
+        .map(|idx| {
+            let (a, b) = (points[idx], points[(idx + 1) % points.len()]);
+            a[0] * b[1] - a[1] * b[0]
+        })
+        .sum::<f64>()
+        / 2.0
+}
+
+fn cross(o: Point, a: Point, b: Point) -> f64 {
+    (a[0] - o[0]) * (b[1] - o[1]) - (a[1] - o[1]) * (b[0] - o[0])
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::test_support::circle;
+    use crate::{WindingRule, contour_source_offsets, prepare_batch};
+
+    // a circle with its radius nudged per sample, still strictly convex, so
+    // no four points are cocircular and the delaunay triangulation is unique
+    fn wobbly_circle(center: (f32, f32), radius: f32, samples: usize) -> Vec<Float3> {
+        circle((0.0, 0.0), radius, samples)
+            .into_iter()
+            .enumerate()
+            .map(|(idx, point)| {
+                let scale = 1.0 + (idx * 37 % 11) as f32 * 1e-4;
+                Float3::new(center.0 + point.x * scale, center.1 + point.y * scale, 0.0)
+            })
+            .collect()
+    }
+
+    fn ring(outer: Vec<Float3>, mut inner: Vec<Float3>) -> Vec<(usize, Vec<Float3>)> {
+        inner.reverse();
+        vec![(0, outer), (1, inner)]
+    }
+
+    fn sweep(contours: &[(usize, Vec<Float3>)], options: TessellationOptions) -> Tessellation {
+        let plain: Vec<_> = contours
+            .iter()
+            .map(|(_, contour)| contour.clone())
+            .collect();
+        let offsets = contour_source_offsets(&plain);
+        let (tessellator, sources) = prepare_batch(contours, &offsets, options, None).unwrap();
+        let mut tessellation = tessellator.tessellate(options).unwrap();
+        sources.restore(
+            &mut tessellation.vertices,
+            &mut tessellation.source_vertex_indices,
+        );
+        tessellation
+    }
+
+    fn strip(
+        contours: &[(usize, Vec<Float3>)],
+        options: TessellationOptions,
+    ) -> Option<Tessellation> {
+        let plain: Vec<_> = contours
+            .iter()
+            .map(|(_, contour)| contour.clone())
+            .collect();
+        triangulate_annulus(contours, &contour_source_offsets(&plain), options)
+    }
+
+    // signed triangle areas about +z
+    fn areas(tessellation: &Tessellation) -> Vec<f32> {
+        tessellation
+            .triangles
+            .iter()
+            .map(|face| {
+                let [a, b, c] = face.map(|vertex| tessellation.vertices[vertex]);
+                (b - a).cross(c - a).z / 2.0
+            })
+            .collect()
+    }
+
+    // triangles as sorted source indices, for comparing triangulations that
+    // number their vertices differently
+    fn source_triangles(tessellation: &Tessellation) -> Vec<[usize; 3]> {
+        let mut triangles: Vec<_> = tessellation
+            .triangles
+            .iter()
+            .map(|face| {
+                let mut face =
+                    face.map(|vertex| tessellation.source_vertex_indices[vertex].unwrap());
+                face.sort_unstable();
+                face
+            })
+            .collect();
+        triangles.sort_unstable();
+        triangles
+    }
+
+    fn sorted_sources(tessellation: &Tessellation) -> Vec<Option<usize>> {
+        let mut sources = tessellation.source_vertex_indices.clone();
+        sources.sort_unstable();
+        sources
+    }
+
+    #[test]
+    fn rings_match_the_sweep_for_equal_and_unequal_sample_counts() {
+        for (outer_samples, inner_samples, inner_center) in [
+            (64, 64, (0.0, 0.0)),
+            (97, 13, (0.3, -0.2)),
+            (5, 40, (0.1, 0.0)),
+        ] {
+            for normal in [None, Some(Float3::Z), Some(-Float3::Z)] {
+                let contours = ring(
+                    wobbly_circle((0.0, 0.0), 2.0, outer_samples),
+                    wobbly_circle(inner_center, 0.5, inner_samples),
+                );
+                let options = TessellationOptions {
+                    winding_rule: WindingRule::NonZero,
+                    normal,
+                    constrained_delaunay: true,
+                    ..TessellationOptions::default()
+                };
+                let fast = strip(&contours, options).unwrap();
+                let swept = sweep(&contours, options);
+
+                assert_eq!(fast.triangles.len(), outer_samples + inner_samples);
+                assert_eq!(fast.triangles.len(), swept.triangles.len());
+                assert_eq!(sorted_sources(&fast), sorted_sources(&swept));
+                let (fast_areas, swept_areas) = (areas(&fast), areas(&swept));
+                // same facing as the sweep, and the same area covered once
+                let sign = swept_areas[0].signum();
+                assert!(fast_areas.iter().all(|area| area.signum() == sign));
+                let (fast_total, swept_total) = (
+                    fast_areas.iter().sum::<f32>(),
+                    swept_areas.iter().sum::<f32>(),
+                );
+                assert!((fast_total - swept_total).abs() < 1e-4 * swept_total.abs());
+                assert_eq!(source_triangles(&fast), source_triangles(&swept));
+            }
+        }
+    }
+
+    #[test]
+    fn clockwise_rings_face_the_inferred_normal() {
+        let mut contours = ring(circle((0.0, 0.0), 2.0, 32), circle((0.0, 0.0), 1.0, 20));
+        for (_, contour) in &mut contours {
+            contour.reverse();
+        }
+        let fast = strip(&contours, TessellationOptions::default()).unwrap();
+        assert!(areas(&fast).iter().all(|&area| area < 0.0));
+
+        // with +z given the band winds -1, which Positive leaves empty
+        let positive = TessellationOptions {
+            winding_rule: WindingRule::Positive,
+            normal: Some(Float3::Z),
+            ..TessellationOptions::default()
+        };
+        assert!(strip(&contours, positive).is_none());
+        assert!(sweep(&contours, positive).triangles.is_empty());
+    }
+
+    #[test]
+    fn other_loop_pairs_are_left_to_the_sweep() {
+        let options = TessellationOptions::default();
+        // crossing, wound the same way, and not convex
+        let crossing = ring(circle((0.0, 0.0), 1.0, 16), circle((0.8, 0.0), 0.5, 16));
+        let same_way = vec![
+            (0, circle((0.0, 0.0), 2.0, 16)),
+            (1, circle((0.0, 0.0), 1.0, 16)),
+        ];
+        let mut notched = circle((0.0, 0.0), 2.0, 16);
+        notched[3] = Float3::new(0.2, 0.2, 0.0);
+        let concave = ring(notched, circle((-1.0, -0.5), 0.3, 8));
+        for contours in [crossing, same_way, concave] {
+            assert!(strip(&contours, options).is_none());
+        }
+
+        let mut three = ring(circle((0.0, 0.0), 2.0, 16), circle((0.0, 0.0), 1.0, 16));
+        three.push((2, circle((5.0, 0.0), 1.0, 8)));
+        assert!(strip(&three, options).is_none());
+        let grid = TessellationOptions {
+            precision: Precision::Grid { cells: 4096 },
+            ..options
+        };
+        let contours = ring(circle((0.0, 0.0), 2.0, 16), circle((0.0, 0.0), 1.0, 16));
+        assert!(strip(&contours, grid).is_none());
+    }
+}
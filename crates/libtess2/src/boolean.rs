@@ -0,0 +1,225 @@
+use std::ffi::c_int;
+
+use crate::{
+    BatchSources, Float3, Outlines, TessError, Tessellation, TessellationOptions, Tessellator,
+    contour_source_offsets, prepare_batch, raw, reorder,
+};
+
+// how the fills of the two operands combine; each operand is first resolved
+// with the options' winding rule on its own
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum BooleanOp {
+    Union,
+    Intersection,
+    Difference,
+    Xor,
+}
+
+impl BooleanOp {
+    fn as_raw(self) -> c_int {
+        match self {
+            Self::Union => raw::TESS_BOOLEAN_UNION,
+            Self::Intersection => raw::TESS_BOOLEAN_INTERSECTION,
+            Self::Difference => raw::TESS_BOOLEAN_DIFFERENCE,
+            Self::Xor => raw::TESS_BOOLEAN_XOR,
+        }
+    }
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub enum Operand {
+    #[default]
+    First,
+    Second,
+}
+
+impl Tessellator {
+    pub fn set_boolean_operation(&mut self, operation: Option<BooleanOp>) {
+        let value = operation.map_or(raw::TESS_BOOLEAN_NONE, BooleanOp::as_raw);
+        unsafe {
+            (self.kernel.set_option)(self.raw.as_ptr(), raw::TESS_BOOLEAN_OPERATION, value);
+        }
+    }
+
+    // applies to contours added after the call
+    pub fn set_contour_operand(&mut self, operand: Operand) {
+        unsafe {
+            (self.kernel.set_option)(
+                self.raw.as_ptr(),
+                raw::TESS_CONTOUR_OPERAND,
+                (operand == Operand::Second) as c_int,
+            );
+        }
+    }
+}
+
+// both operands go through one sweep that tracks their winding numbers
+// separately; source indices number the first operand's vertices before the
+// second's. split_components is ignored
+pub fn boolean<A, B, CA, CB>(
+    first: A,
+    second: B,
+    operation: BooleanOp,
+    options: TessellationOptions,
+) -> Result<Tessellation, TessError>
+where
+    A: IntoIterator<Item = CA>,
+    B: IntoIterator<Item = CB>,
+    CA: AsRef<[Float3]>,
+    CB: AsRef<[Float3]>,
+{
+    let Some((tessellator, sources)) = prepare_boolean(first, second, operation, options)? else {
+        return Ok(Tessellation::default());
+    };
+    let mut tessellation = tessellator.tessellate(TessellationOptions {
+        normalize_input: false,
+        ..options
+    })?;
+    sources.restore(
+        &mut tessellation.vertices,
+        &mut tessellation.source_vertex_indices,
+    );
+    if options.reorder_output {
+        reorder::reorder_for_locality(&mut tessellation);
+    }
+    Ok(tessellation)
+}
+
+pub fn boolean_outlines<A, B, CA, CB>(
+    first: A,
+    second: B,
+    operation: BooleanOp,
+    options: TessellationOptions,
+) -> Result<Outlines, TessError>
+where
+    A: IntoIterator<Item = CA>,
+    B: IntoIterator<Item = CB>,
+    CA: AsRef<[Float3]>,
+    CB: AsRef<[Float3]>,
+{
+    let Some((tessellator, sources)) = prepare_boolean(first, second, operation, options)? else {
+        return Ok(Outlines::default());
+    };
+    let mut outlines = tessellator.resolve_outlines(TessellationOptions {
+        normalize_input: false,
+        ..options
+    })?;
+    sources.restore(&mut outlines.vertices, &mut outlines.source_vertex_indices);
+    Ok(outlines)
+}
+
+fn prepare_boolean<A, B, CA, CB>(
+    first: A,
+    second: B,
+    operation: BooleanOp,
+    options: TessellationOptions,
+) -> Result<Option<(Tessellator, BatchSources)>, TessError>
+where
+    A: IntoIterator<Item = CA>,
+    B: IntoIterator<Item = CB>,
+    CA: AsRef<[Float3]>,
+    CB: AsRef<[Float3]>,
+{
+    let mut contours: Vec<_> = first
+        .into_iter()
+        .map(|contour| contour.as_ref().to_vec())
+        .collect();
+    let second_operand = contours.len();
+    contours.extend(second.into_iter().map(|contour| contour.as_ref().to_vec()));
+    if contours.is_empty() {
+        return Ok(None);
+    }
+
+    let source_offsets = contour_source_offsets(&contours);
+    let indexed_contours = contours.into_iter().enumerate().collect::<Vec<_>>();
+    let (mut tessellator, sources) = prepare_batch(
+        &indexed_contours,
+        &source_offsets,
+        options,
+        Some(second_operand),
+    )?;
+    tessellator.set_boolean_operation(Some(operation));
+    Ok(Some((tessellator, sources)))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::WindingRule;
+    use crate::test_support::square;
+
+    fn area(tessellation: &Tessellation) -> f32 {
+        tessellation
+            .triangles
+            .iter()
+            .map(|&[a, b, c]| {
+                let ab = tessellation.vertices[b] - tessellation.vertices[a];
+                let ac = tessellation.vertices[c] - tessellation.vertices[a];
+                ab.cross(ac).len() * 0.5
+            })
+            .sum()
+    }
+
+    #[test]
+    fn boolean_operations_of_overlapping_squares() {
+        let options = TessellationOptions {
+            winding_rule: WindingRule::NonZero,
+            normal: Some(Float3::Z),
+            ..TessellationOptions::default()
+        };
+        let first = [square(0.0, 0.0, 2.0)];
+        let second = [square(1.0, 1.0, 2.0)];
+
+        for (operation, expected) in [
+            (BooleanOp::Union, 7.0),
+            (BooleanOp::Intersection, 1.0),
+            (BooleanOp::Difference, 3.0),
+            (BooleanOp::Xor, 6.0),
+        ] {
+            let tessellation = boolean(&first, &second, operation, options).unwrap();
+            assert!(
+                (area(&tessellation) - expected).abs() < 1e-5,
+                "{operation:?}: {}",
+                area(&tessellation)
+            );
+        }
+    }
+
+    #[test]
+    fn operands_resolve_their_own_winding_before_combining() {
+        // the first operand overlaps itself; under NonZero it still counts once,
+        // so subtracting a square that covers it all leaves nothing
+        let options = TessellationOptions {
+            winding_rule: WindingRule::NonZero,
+            normal: Some(Float3::Z),
+            ..TessellationOptions::default()
+        };
+        let first = [square(0.0, 0.0, 1.0), square(0.5, 0.0, 1.0)];
+        let second = [square(-1.0, -1.0, 4.0)];
+
+        let difference = boolean(&first, &second, BooleanOp::Difference, options).unwrap();
+        let intersection = boolean(&first, &second, BooleanOp::Intersection, options).unwrap();
+
+        assert!(difference.triangles.is_empty());
+        assert!((area(&intersection) - 1.5).abs() < 1e-5);
+    }
+
+    #[test]
+    fn boolean_outlines_use_global_source_indices() {
+        let outlines = boolean_outlines(
+            [square(0.0, 0.0, 2.0)],
+            [square(1.0, 1.0, 2.0)],
+            BooleanOp::Intersection,
+            TessellationOptions {
+                normal: Some(Float3::Z),
+                ..TessellationOptions::default()
+            },
+        )
+        .unwrap();
+
+        assert_eq!(outlines.contours, vec![0..4]);
+        let mut sources = outlines.source_vertex_indices.clone();
+        sources.sort_unstable();
+        assert_eq!(sources, vec![None, None, Some(2), Some(4)]);
+    }
+}
@@ -0,0 +1,189 @@
+use std::{
+    alloc::{Layout, alloc, dealloc, realloc},
+    ffi::{c_uint, c_void},
+    ptr,
+};
+
+use crate::raw;
+
+// every block carries its size in front of the pointer handed to libtess2 so
+// memrealloc/memfree can keep the live byte count exact
+const HEADER_BYTES: usize = 16;
+
+#[derive(Debug, Default)]
+pub(crate) struct AllocationBudget {
+    pub limit: Option<usize>,
+    pub live_bytes: usize,
+    pub peak_bytes: usize,
+    // live + requested bytes of the first allocation refused by the budget
+    pub exceeded_at: Option<usize>,
+    // reallocations that grew a block, i.e. copies of a heap array
+    pub grown_blocks: usize,
+}
+
+impl AllocationBudget {
+    pub fn new(limit: Option<usize>) -> Self {
+        Self {
+            limit,
+            ..Self::default()
+        }
+    }
+
+    fn reserve(&mut self, released: usize, requested: usize) -> bool {
+        let live = self.live_bytes - released + requested;
+        if self.limit.is_some_and(|limit| live > limit) {
+            self.exceeded_at.get_or_insert(live);
+            return false;
+        }
+        self.live_bytes = live;
+        self.peak_bytes = self.peak_bytes.max(live);
+        true
+    }
+}
+
+pub(crate) fn budgeted_alloc(budget: *mut AllocationBudget) -> raw::TESSalloc {
+    raw::TESSalloc {
+        memalloc: Some(budget_alloc),
+        memrealloc: Some(budget_realloc),
+        memfree: Some(budget_free),
+        user_data: budget.cast(),
+        ..raw::TESSalloc::default()
+    }
+}
+
+fn block_layout(size: usize) -> Option<Layout> {
+    Layout::from_size_align(size.checked_add(HEADER_BYTES)?, HEADER_BYTES).ok()
+}
+
+unsafe fn block_start(ptr: *mut c_void) -> (*mut u8, usize) {
+    unsafe {
+        let block = ptr.cast::<u8>().sub(HEADER_BYTES);
+        (block, block.cast::<usize>().read())
+    }
+}
+
+unsafe fn finish_block(block: *mut u8, size: usize) -> *mut c_void {
+    if block.is_null() {
+        return ptr::null_mut();
+    }
+    unsafe {
+        block.cast::<usize>().write(size);
+        block.add(HEADER_BYTES).cast()
+    }
+}
+
+unsafe extern "C" fn budget_alloc(user_data: *mut c_void, size: c_uint) -> *mut c_void {
+    let budget = unsafe { &mut *user_data.cast::<AllocationBudget>() };
+    let size = size as usize;
+    let Some(layout) = block_layout(size) else {
+        return ptr::null_mut();
+    };
+    if !budget.reserve(0, size) {
+        return ptr::null_mut();
+    }
+    let block = unsafe { alloc(layout) };
+    if block.is_null() {
+        budget.live_bytes -= size;
+    }
+    unsafe { finish_block(block, size) }
+}
+
+unsafe extern "C" fn budget_realloc(
+    user_data: *mut c_void,
+    ptr: *mut c_void,
+    size: c_uint,
+) -> *mut c_void {
+    if ptr.is_null() {
+        return unsafe { budget_alloc(user_data, size) };
+    }
+    let budget = unsafe { &mut *user_data.cast::<AllocationBudget>() };
+    let size = size as usize;
+    let (block, old_size) = unsafe { block_start(ptr) };
+    let (Some(old_layout), Some(_)) = (block_layout(old_size), block_layout(size)) else {
+        return ptr::null_mut();
+    };
+    // a refused realloc leaves the old block untouched, which libtess2 relies on
+    // to free it during cleanup
+    if !budget.reserve(old_size, size) {
+        return ptr::null_mut();
+    }
+    if size > old_size {
+        budget.grown_blocks += 1;
+    }
+    let grown = unsafe { realloc(block, old_layout, size + HEADER_BYTES) };
+    if grown.is_null() {
+        budget.live_bytes = budget.live_bytes - size + old_size;
+    }
+    unsafe { finish_block(grown, size) }
+}
+
+unsafe extern "C" fn budget_free(user_data: *mut c_void, ptr: *mut c_void) {
+    if ptr.is_null() {
+        return;
+    }
+    let budget = unsafe { &mut *user_data.cast::<AllocationBudget>() };
+    let (block, size) = unsafe { block_start(ptr) };
+    budget.live_bytes -= size;
+    if let Some(layout) = block_layout(size) {
+        unsafe { dealloc(block, layout) };
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::test_support::star_polygon;
+    use crate::{TessError, TessellationOptions, WindingRule, triangulate};
+
+    #[test]
+    fn budget_tracks_live_and_peak_bytes() {
+        let mut budget = AllocationBudget::new(None);
+        let user_data = (&mut budget as *mut AllocationBudget).cast();
+        unsafe {
+            let a = budget_alloc(user_data, 64);
+            let b = budget_alloc(user_data, 32);
+            let a = budget_realloc(user_data, a, 256);
+            budget_free(user_data, b);
+            budget_free(user_data, a);
+        }
+
+        assert_eq!(budget.live_bytes, 0);
+        assert_eq!(budget.peak_bytes, 288);
+        assert_eq!(budget.exceeded_at, None);
+    }
+
+    #[test]
+    fn tessellation_reports_peak_bytes() {
+        let tessellation =
+            triangulate([star_polygon(101, 1.0)], TessellationOptions::default()).unwrap();
+
+        assert!(tessellation.stats.peak_bytes > 0);
+    }
+
+    #[test]
+    fn exceeding_the_memory_limit_is_a_typed_error() {
+        let options = TessellationOptions {
+            winding_rule: WindingRule::NonZero,
+            ..TessellationOptions::default()
+        };
+        let peak = triangulate([star_polygon(401, 1.0)], options)
+            .unwrap()
+            .stats
+            .peak_bytes;
+
+        let error = triangulate(
+            [star_polygon(401, 1.0)],
+            TessellationOptions {
+                memory_limit: Some(peak / 2),
+                ..options
+            },
+        )
+        .unwrap_err();
+
+        assert!(matches!(
+            error,
+            TessError::MemoryBudgetExceeded { limit, requested }
+                if limit == peak / 2 && requested > limit
+        ));
+    }
+}
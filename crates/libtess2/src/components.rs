@@ -0,0 +1,324 @@
+use std::{num::NonZeroUsize, thread};
+
+use crate::{
+    Float3, TessError, Tessellation, TessellationOptions, inferred_batch_normal, polygon_basis,
+    triangulate_batch,
+};
+
+// wider than the jitter applied by normalize_input so contours that touch
+// before jittering still land in the same component
+const COMPONENT_BOUNDS_EPSILON: f32 = 4e-3;
+const PARALLEL_COMPONENT_MIN_VERTICES: usize = 1 << 12;
+
+#[derive(Debug, Clone, Copy)]
+pub(crate) struct Bounds2 {
+    min: [f32; 2],
+    max: [f32; 2],
+}
+
+// groups contours whose projected bounding boxes overlap (transitively) using a
+// sort-and-sweep over the boxes' min-x; each group can be swept on its own
+pub(crate) fn bounding_box_components(
+    contours: &[Vec<Float3>],
+    normal: Option<Float3>,
+) -> Vec<Vec<usize>> {
+    let (basis_x, basis_y, _) = polygon_basis(inferred_batch_normal(contours, normal));
+    let bounds: Vec<_> = contours
+        .iter()
+        .map(|contour| projected_bounds(contour, basis_x, basis_y))
+        .collect();
+    overlapping_bounds_components(&bounds)
+}
+
+pub(crate) fn overlapping_bounds_components(bounds: &[Bounds2]) -> Vec<Vec<usize>> {
+    let mut order: Vec<_> = (0..bounds.len()).collect();
+    order.sort_by(|&lhs, &rhs| bounds[lhs].min[0].total_cmp(&bounds[rhs].min[0]));
+
+    let mut parents: Vec<_> = (0..bounds.len()).collect();
+    let mut active: Vec<usize> = Vec::new();
+    for idx in order {
+        let current = bounds[idx];
+        active.retain(|&other| bounds[other].max[0] >= current.min[0]);
+        for &other in &active {
+            if bounds[other].min[1] <= current.max[1] && current.min[1] <= bounds[other].max[1] {
+                union(&mut parents, idx, other);
+            }
+        }
+        active.push(idx);
+    }
+
+    let mut component_of_root = vec![usize::MAX; bounds.len()];
+    let mut components: Vec<Vec<usize>> = Vec::new();
+    for idx in 0..bounds.len() {
+        let root = find(&mut parents, idx);
+        if component_of_root[root] == usize::MAX {
+            component_of_root[root] = components.len();
+            components.push(Vec::new());
+        }
+        components[component_of_root[root]].push(idx);
+    }
+    components
+}
+
+pub(crate) fn triangulate_components(
+    contours: &[(usize, Vec<Float3>)],
+    source_offsets: &[usize],
+    components: &[Vec<usize>],
+    options: TessellationOptions,
+) -> Result<Tessellation, TessError> {
+    let batches: Vec<Vec<(usize, Vec<Float3>)>> = components
+        .iter()
+        .map(|component| {
+            component
+                .iter()
+                .map(|&contour_idx| contours[contour_idx].clone())
+                .collect()
+        })
+        .collect();
+
+    let batch_options = vec![options; batches.len()];
+    let mut merged = Tessellation::default();
+    for part in triangulate_batches(&batches, source_offsets, &batch_options) {
+        append_tessellation(&mut merged, part?);
+    }
+    Ok(merged)
+}
+
+// sweeps each batch with its own options, across threads when the first
+// batch's options ask for parallel_components and there is enough work
+pub(crate) fn triangulate_batches(
+    batches: &[Vec<(usize, Vec<Float3>)>],
+    source_offsets: &[usize],
+    options: &[TessellationOptions],
+) -> Vec<Result<Tessellation, TessError>> {
+    let vertex_count: usize = batches
+        .iter()
+        .flatten()
+        .map(|(_, contour)| contour.len())
+        .sum();
+    let workers = thread::available_parallelism().map_or(1, NonZeroUsize::get);
+    let parallel = options
+        .first()
+        .is_some_and(|options| options.parallel_components);
+    if parallel
+        && workers > 1
+        && batches.len() > 1
+        && vertex_count >= PARALLEL_COMPONENT_MIN_VERTICES
+    {
+        triangulate_batches_in_parallel(batches, source_offsets, options, workers)
+    } else {
+        batches
+            .iter()
+            .zip(options)
+            .map(|(batch, &options)| triangulate_batch(batch, source_offsets, options))
+            .collect()
+    }
+}
+
+// batches are dealt out to workers largest-first so one dense glyph does not
+// serialise the whole batch behind it
+fn triangulate_batches_in_parallel(
+    batches: &[Vec<(usize, Vec<Float3>)>],
+    source_offsets: &[usize],
+    options: &[TessellationOptions],
+    workers: usize,
+) -> Vec<Result<Tessellation, TessError>> {
+    let batch_size =
+        |batch: &Vec<(usize, Vec<Float3>)>| batch.iter().map(|(_, c)| c.len()).sum::<usize>();
+    let mut by_size: Vec<_> = (0..batches.len()).collect();
+    by_size.sort_by_key(|&idx| std::cmp::Reverse(batch_size(&batches[idx])));
+
+    let workers = workers.min(batches.len());
+    let mut assignments = vec![Vec::new(); workers];
+    let mut loads = vec![0usize; workers];
+    for idx in by_size {
+        let worker = (0..workers)
+            .min_by_key(|&worker| loads[worker])
+            .unwrap_or(0);
+        loads[worker] += batch_size(&batches[idx]);
+        assignments[worker].push(idx);
+    }
+
+    let mut results: Vec<Option<Result<Tessellation, TessError>>> =
+        (0..batches.len()).map(|_| None).collect();
+    thread::scope(|scope| {
+        let handles: Vec<_> = assignments
+            .iter()
+            .map(|assigned| {
+                scope.spawn(move || {
+                    assigned
+                        .iter()
+                        .map(|&idx| {
+                            (
+                                idx,
+                                triangulate_batch(&batches[idx], source_offsets, options[idx]),
+                            )
+                        })
+                        .collect::<Vec<_>>()
+                })
+            })
+            .collect();
+        for handle in handles {
+            for (idx, result) in handle.join().expect("tessellation worker panicked") {
+                results[idx] = Some(result);
+            }
+        }
+    });
+
+    results
+        .into_iter()
+        .map(|result| result.expect("every component is assigned to a worker"))
+        .collect()
+}
+
+pub(crate) fn append_tessellation(merged: &mut Tessellation, part: Tessellation) {
+    let offset = merged.vertices.len();
+    merged.stats = merged.stats.merge(part.stats);
+    merged.vertices.extend(part.vertices);
+    merged
+        .source_vertex_indices
+        .extend(part.source_vertex_indices);
+    merged.triangles.extend(
+        part.triangles
+            .into_iter()
+            .map(|face| face.map(|vertex| vertex + offset)),
+    );
+}
+
+pub(crate) fn projected_bounds(contour: &[Float3], basis_x: Float3, basis_y: Float3) -> Bounds2 {
+    let mut bounds = Bounds2 {
+        min: [f32::INFINITY; 2],
+        max: [f32::NEG_INFINITY; 2],
+    };
+    for point in contour {
+        let projected = [point.dot(basis_x), point.dot(basis_y)];
+        for axis in 0..2 {
+            bounds.min[axis] = bounds.min[axis].min(projected[axis]);
+            bounds.max[axis] = bounds.max[axis].max(projected[axis]);
+        }
+    }
+    for axis in 0..2 {
+        let pad = COMPONENT_BOUNDS_EPSILON
+            .max((bounds.max[axis].abs().max(bounds.min[axis].abs())) * f32::EPSILON * 16.0);
+        bounds.min[axis] -= pad;
+        bounds.max[axis] += pad;
+    }
+    bounds
+}
+
+fn find(parents: &mut [usize], idx: usize) -> usize {
+    let mut root = idx;
+    while parents[root] != root {
+        root = parents[root];
+    }
+    let mut cursor = idx;
+    while parents[cursor] != root {
+        let next = parents[cursor];
+        parents[cursor] = root;
+        cursor = next;
+    }
+    root
+}
+
+fn union(parents: &mut [usize], lhs: usize, rhs: usize) {
+    let lhs = find(parents, lhs);
+    let rhs = find(parents, rhs);
+    if lhs != rhs {
+        parents[lhs.max(rhs)] = lhs.min(rhs);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::test_support::square;
+    use crate::{WindingRule, triangulate};
+
+    #[test]
+    fn overlapping_bounds_share_a_component() {
+        let contours = vec![
+            square(0.0, 0.0, 1.0),
+            square(5.0, 1.0, 1.0),
+            square(0.5, 0.5, 1.0),
+            square(10.0, 10.0, 1.0),
+            square(1.4, 1.4, 4.0),
+        ];
+
+        let components = bounding_box_components(&contours, Some(Float3::Z));
+
+        assert_eq!(components, vec![vec![0, 1, 2, 4], vec![3]]);
+    }
+
+    #[test]
+    fn split_components_keep_global_source_indices() {
+        let contours = [
+            square(0.0, 0.0, 1.0),
+            square(3.0, 0.0, 1.0),
+            square(6.0, 0.0, 1.0),
+        ];
+
+        let tessellation = triangulate(
+            &contours,
+            TessellationOptions {
+                winding_rule: WindingRule::NonZero,
+                split_components: true,
+                ..TessellationOptions::default()
+            },
+        )
+        .unwrap();
+
+        assert_eq!(tessellation.triangles.len(), 6);
+        for (vertex, source) in tessellation
+            .vertices
+            .iter()
+            .zip(&tessellation.source_vertex_indices)
+        {
+            let source = source.expect("squares produce no intersection vertices");
+            assert_eq!(*vertex, contours[source / 4][source % 4]);
+        }
+        for face in &tessellation.triangles {
+            let contour = tessellation.source_vertex_indices[face[0]].unwrap() / 4;
+            assert!(
+                face.iter().all(
+                    |&vertex| tessellation.source_vertex_indices[vertex].unwrap() / 4 == contour
+                )
+            );
+        }
+    }
+
+    #[test]
+    fn parallel_components_match_sequential_components() {
+        let contours: Vec<_> = (0..64)
+            .map(|idx| {
+                let mut ring: Vec<_> = (0..96)
+                    .map(|sample| {
+                        let theta = sample as f32 / 96.0 * std::f32::consts::TAU;
+                        Float3::new(idx as f32 * 3.0 + theta.cos(), theta.sin(), 0.0)
+                    })
+                    .collect();
+                if idx % 2 == 1 {
+                    ring.reverse();
+                }
+                ring
+            })
+            .collect();
+        let options = TessellationOptions {
+            winding_rule: WindingRule::NonZero,
+            constrained_delaunay: true,
+            split_components: true,
+            ..TessellationOptions::default()
+        };
+
+        let sequential = triangulate(&contours, options).unwrap();
+        let parallel = triangulate(
+            &contours,
+            TessellationOptions {
+                parallel_components: true,
+                ..options
+            },
+        )
+        .unwrap();
+
+        assert_eq!(sequential, parallel);
+    }
+}
@@ -0,0 +1,293 @@
+use crate::{
+    Float3, contour_area_normal,
+    locate::{Point2, UniformGrid, cross, project},
+    polygon_basis,
+};
+
+// pair tests beyond this are extrapolated from the cells already visited
+const MAX_PAIR_TESTS: usize = 1 << 22;
+// pair tests per edge after which the simplicity check gives up; input dense
+// enough to need more is left to the sweep
+const MAX_SIMPLE_PAIR_TESTS_PER_EDGE: usize = 64;
+
+// counts proper crossings between contour edges projected onto the sweep
+// plane; a pair overlapping several cells is only counted in the cell holding
+// its crossing point. touching and collinear edges are not counted, so this
+// slightly undershoots what the sweep will split
+pub(crate) fn estimate_crossings(
+    contours: &[(usize, Vec<Float3>)],
+    normal: Option<Float3>,
+) -> usize {
+    let normal = normal
+        .filter(|normal| normal.len_sq() > 0.0)
+        .map(Float3::normalize)
+        .or_else(|| {
+            contours
+                .iter()
+                .find_map(|(_, contour)| contour_area_normal(contour))
+        })
+        .unwrap_or(Float3::Z);
+    let (basis_x, basis_y, _) = polygon_basis(normal);
+
+    let segments: Vec<[Point2; 2]> = contours
+        .iter()
+        .flat_map(|(_, contour)| {
+            (0..contour.len()).map(move |idx| {
+                [
+                    project(contour[idx], (basis_x, basis_y)),
+                    project(contour[(idx + 1) % contour.len()], (basis_x, basis_y)),
+                ]
+            })
+        })
+        .collect();
+    if segments.len() < 2 {
+        return 0;
+    }
+    let bounds: Vec<_> = segments
+        .iter()
+        .map(|[a, b]| {
+            (
+                [a[0].min(b[0]), a[1].min(b[1])],
+                [a[0].max(b[0]), a[1].max(b[1])],
+            )
+        })
+        .collect();
+    let grid = UniformGrid::build(&bounds, false);
+
+    let total_pairs: usize = (0..grid.cell_count())
+        .map(|cell| {
+            let count = grid.cell_items(cell).len();
+            count * count.saturating_sub(1) / 2
+        })
+        .sum();
+    let mut tested = 0;
+    let mut crossings = 0;
+    for cell in 0..grid.cell_count() {
+        let items = grid.cell_items(cell);
+        for (idx, &first) in items.iter().enumerate() {
+            for &second in &items[idx + 1..] {
+                let (first, second) = (first as usize, second as usize);
+                let overlaps = (0..2).all(|axis| {
+                    bounds[first].0[axis] <= bounds[second].1[axis]
+                        && bounds[second].0[axis] <= bounds[first].1[axis]
+                });
+                if !overlaps {
+                    continue;
+                }
+                if let Some(point) = crossing_point(segments[first], segments[second]) {
+                    if grid.cell_at(point) == cell {
+                        crossings += 1;
+                    }
+                }
+            }
+            tested += items.len() - idx - 1;
+        }
+        if tested > MAX_PAIR_TESTS {
+            return (crossings as f64 * total_pairs as f64 / tested as f64).ceil() as usize;
+        }
+    }
+    crossings
+}
+
+// whether projected contours are simple and pairwise disjoint: no edge of any
+// contour touches another except where consecutive edges share their vertex,
+// and no edge has zero length or folds back onto the previous one. bucketed on
+// the same grid as the crossing estimate, so near-linear unless many edges
+// crowd one cell, in which case this answers false rather than go quadratic
+pub(crate) fn contours_are_simple(contours: &[Vec<Point2>]) -> bool {
+    // (contour, first vertex) for every edge
+    let edges: Vec<(usize, usize)> = contours
+        .iter()
+        .enumerate()
+        .flat_map(|(contour_idx, contour)| (0..contour.len()).map(move |idx| (contour_idx, idx)))
+        .collect();
+    let segment = |(contour_idx, idx): (usize, usize)| {
+        let contour = &contours[contour_idx];
+        [contour[idx], contour[(idx + 1) % contour.len()]]
+    };
+    if edges.iter().any(|&edge| {
+        let [a, b] = segment(edge);
+        a == b
+    }) {
+        return false;
+    }
+    let bounds: Vec<_> = edges
+        .iter()
+        .map(|&edge| {
+            let [a, b] = segment(edge);
+            (
+                [a[0].min(b[0]), a[1].min(b[1])],
+                [a[0].max(b[0]), a[1].max(b[1])],
+            )
+        })
+        .collect();
+    let grid = UniformGrid::build(&bounds, false);
+
+    let budget = edges.len() * MAX_SIMPLE_PAIR_TESTS_PER_EDGE;
+    let mut tested = 0;
+    for cell in 0..grid.cell_count() {
+        let items = grid.cell_items(cell);
+        for (idx, &first) in items.iter().enumerate() {
+            for &second in &items[idx + 1..] {
+                let (first, second) = (first as usize, second as usize);
+                let overlaps = (0..2).all(|axis| {
+                    bounds[first].0[axis] <= bounds[second].1[axis]
+                        && bounds[second].0[axis] <= bounds[first].1[axis]
+                });
+                if !overlaps {
+                    continue;
+                }
+                tested += 1;
+                if tested > budget {
+                    return false;
+                }
+                let ((first_contour, first_idx), (second_contour, second_idx)) =
+                    (edges[first], edges[second]);
+                let count = contours[first_contour].len();
+                let (before, after) = if first_contour != second_contour {
+                    (None, None)
+                } else if (first_idx + 1) % count == second_idx {
+                    (Some(first), Some(second))
+                } else if (second_idx + 1) % count == first_idx {
+                    (Some(second), Some(first))
+                } else {
+                    (None, None)
+                };
+                let touches = match (before, after) {
+                    (Some(before), Some(after)) => {
+                        let [a, b] = segment(edges[before]);
+                        let [_, c] = segment(edges[after]);
+                        folds_back(a, b, c)
+                    }
+                    _ => segments_touch(segment(edges[first]), segment(edges[second])),
+                };
+                if touches {
+                    return false;
+                }
+            }
+        }
+    }
+    true
+}
+
+// orientation of b about o-a in double precision, where products of
+// single-precision differences are exact and the sign is reliable
+fn orient(o: Point2, a: Point2, b: Point2) -> f64 {
+    let (o, a, b) = (o.map(f64::from), a.map(f64::from), b.map(f64::from));
+    (a[0] - o[0]) * (b[1] - o[1]) - (a[1] - o[1]) * (b[0] - o[0])
+}
+
+// whether the edge b-c runs back along a-b
+fn folds_back(a: Point2, b: Point2, c: Point2) -> bool {
+    let (ba, bc) = (
+        [
+            f64::from(a[0]) - f64::from(b[0]),
+            f64::from(a[1]) - f64::from(b[1]),
+        ],
+        [
+            f64::from(c[0]) - f64::from(b[0]),
+            f64::from(c[1]) - f64::from(b[1]),
+        ],
+    );
+    orient(a, b, c) == 0.0 && ba[0] * bc[0] + ba[1] * bc[1] > 0.0
+}
+
+fn segments_touch([a, b]: [Point2; 2], [c, d]: [Point2; 2]) -> bool {
+    let (ac, ad) = (orient(a, b, c), orient(a, b, d));
+    let (ca, cb) = (orient(c, d, a), orient(c, d, b));
+    let on_segment = |[a, b]: [Point2; 2], point: Point2| {
+        (0..2)
+            .all(|axis| a[axis].min(b[axis]) <= point[axis] && point[axis] <= a[axis].max(b[axis]))
+    };
+    (ac * ad < 0.0 && ca * cb < 0.0)
+        || (ac == 0.0 && on_segment([a, b], c))
+        || (ad == 0.0 && on_segment([a, b], d))
+        || (ca == 0.0 && on_segment([c, d], a))
+        || (cb == 0.0 && on_segment([c, d], b))
+}
+
+fn crossing_point([a, b]: [Point2; 2], [c, d]: [Point2; 2]) -> Option<Point2> {
+    let (ac, ad) = (cross(a, b, c), cross(a, b, d));
+    let (ca, cb) = (cross(c, d, a), cross(c, d, b));
+    let proper = ac * ad < 0.0 && ca * cb < 0.0;
+    if !proper {
+        return None;
+    }
+    let t = ca / (ca - cb);
+    Some([a[0] + (b[0] - a[0]) * t, a[1] + (b[1] - a[1]) * t])
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::test_support::star_polygon;
+    use crate::{
+        TessellationOptions, WindingRule, contour_source_offsets, prepare_batch, raw, triangulate,
+    };
+
+    #[test]
+    fn estimate_tracks_the_crossings_the_sweep_splits() {
+        let contours = vec![(0, star_polygon(61, 1.0))];
+        let estimate = estimate_crossings(&contours, None);
+        let tessellation = triangulate(
+            [star_polygon(61, 1.0)],
+            TessellationOptions {
+                winding_rule: WindingRule::NonZero,
+                ..TessellationOptions::default()
+            },
+        )
+        .unwrap();
+
+        let actual = tessellation.stats.intersections;
+        assert!(actual > 0);
+        assert!(
+            estimate.abs_diff(actual) <= actual / 10,
+            "{estimate} vs {actual}"
+        );
+    }
+
+    #[test]
+    fn intersection_heavy_mode_reserves_instead_of_regrowing() {
+        let contours = vec![(0, star_polygon(61, 1.0)), (1, star_polygon(41, 1.0))];
+        let offsets = contour_source_offsets(&[star_polygon(61, 1.0), star_polygon(41, 1.0)]);
+        let sweep = |intersection_heavy| {
+            let options = TessellationOptions {
+                winding_rule: WindingRule::NonZero,
+                normal: Some(Float3::Z),
+                intersection_heavy,
+                ..TessellationOptions::default()
+            };
+            let (mut tessellator, _) = prepare_batch(&contours, &offsets, options, None).unwrap();
+            // count only what the sweep itself regrows, not contour loading
+            let before = tessellator.budget().grown_blocks;
+            tessellator.run(options, raw::TESS_POLYGONS).unwrap();
+            let regrown = tessellator.budget().grown_blocks - before;
+            (tessellator.extract_tessellation().unwrap(), regrown)
+        };
+
+        let (plain, plain_regrown) = sweep(false);
+        let (heavy, heavy_regrown) = sweep(true);
+        assert_eq!(plain.triangles, heavy.triangles);
+        assert_eq!(plain.stats.intersections, heavy.stats.intersections);
+        assert!(plain_regrown > 0);
+        assert_eq!(heavy_regrown, 0);
+    }
+
+    #[test]
+    fn disjoint_and_nested_contours_have_no_crossings() {
+        let square = |x: f32, size: f32| {
+            vec![
+                Float3::new(x, x, 0.0),
+                Float3::new(x + size, x, 0.0),
+                Float3::new(x + size, x + size, 0.0),
+                Float3::new(x, x + size, 0.0),
+            ]
+        };
+        let contours = vec![
+            (0, square(0.0, 4.0)),
+            (1, square(1.0, 1.0)),
+            (2, square(9.0, 1.0)),
+        ];
+        assert_eq!(estimate_crossings(&contours, Some(Float3::Z)), 0);
+    }
+}
@@ -7,15 +7,70 @@ use std::{
 
 pub use geo::simd::Float3;
 
+mod annulus;
+mod boolean;
+mod budget;
+mod components;
+mod crossings;
+mod locate;
+mod monotone;
+mod outlines;
+mod planes;
+mod reorder;
+mod retained;
+mod strips;
+
+pub use boolean::{BooleanOp, Operand, boolean, boolean_outlines};
+pub use locate::{PointLocator, WindingIndex};
+pub use outlines::{Outlines, resolve_outlines};
+pub use planes::{
+    PlanarTessellation, Plane, PlaneGroup, PlaneTolerance, group_by_plane, triangulate_planes,
+};
+pub use retained::{ContourId, RetainedTessellator, RetainedUpdate};
+pub use strips::{STRIP_MIN_VERTICES, StripOptions, triangulate_in_strips};
+
 mod raw {
-    use std::ffi::{c_int, c_void};
+    use std::ffi::{c_int, c_uint, c_void};
 
     pub type TESSindex = c_int;
-    pub type TESSreal = f32;
     pub type TESStesselator = c_void;
 
     pub const TESS_UNDEF: TESSindex = !0;
 
+    // mirrors struct TESSalloc in tesselator.h; zeroed bucket sizes select the
+    // library defaults
+    #[repr(C)]
+    pub struct TESSalloc {
+        pub memalloc: Option<unsafe extern "C" fn(*mut c_void, c_uint) -> *mut c_void>,
+        pub memrealloc:
+            Option<unsafe extern "C" fn(*mut c_void, *mut c_void, c_uint) -> *mut c_void>,
+        pub memfree: Option<unsafe extern "C" fn(*mut c_void, *mut c_void)>,
+        pub user_data: *mut c_void,
+        pub mesh_edge_bucket_size: c_int,
+        pub mesh_vertex_bucket_size: c_int,
+        pub mesh_face_bucket_size: c_int,
+        pub dict_node_bucket_size: c_int,
+        pub region_bucket_size: c_int,
+        pub extra_vertices: c_int,
+    }
+
+    impl Default for TESSalloc {
+        fn default() -> Self {
+            Self {
+                memalloc: None,
+                memrealloc: None,
+                memfree: None,
+                user_data: std::ptr::null_mut(),
+                mesh_edge_bucket_size: 0,
+                mesh_vertex_bucket_size: 0,
+                mesh_face_bucket_size: 0,
+                dict_node_bucket_size: 0,
+                region_bucket_size: 0,
+                extra_vertices: 0,
+            }
+        }
+    }
+
     pub const TESS_WINDING_ODD: c_int = 0;
     pub const TESS_WINDING_NONZERO: c_int = 1;
     pub const TESS_WINDING_POSITIVE: c_int = 2;
@@ -23,41 +78,118 @@ mod raw {
     pub const TESS_WINDING_ABS_GEQ_TWO: c_int = 4;
 
     pub const TESS_POLYGONS: c_int = 0;
+    pub const TESS_BOUNDARY_CONTOURS: c_int = 2;
 
     pub const TESS_CONSTRAINED_DELAUNAY_TRIANGULATION: c_int = 0;
     pub const TESS_REVERSE_CONTOURS: c_int = 1;
+    pub const TESS_GRID_RESOLUTION: c_int = 2;
+    pub const TESS_BOOLEAN_OPERATION: c_int = 3;
+    pub const TESS_CONTOUR_OPERAND: c_int = 4;
+
+    pub const TESS_BOOLEAN_NONE: c_int = 0;
+    pub const TESS_BOOLEAN_UNION: c_int = 1;
+    pub const TESS_BOOLEAN_INTERSECTION: c_int = 2;
+    pub const TESS_BOOLEAN_DIFFERENCE: c_int = 3;
+    pub const TESS_BOOLEAN_XOR: c_int = 4;
 
     pub const TESS_STATUS_OK: c_int = 0;
     pub const TESS_STATUS_OUT_OF_MEMORY: c_int = 1;
     pub const TESS_STATUS_INVALID_INPUT: c_int = 2;
 
-    #[link(name = "tess2_upstream", kind = "static")]
-    unsafe extern "C" {
-        pub fn tessNewTess(alloc: *mut c_void) -> *mut TESStesselator;
-        pub fn tessDeleteTess(tess: *mut TESStesselator);
-        pub fn tessAddContour(
-            tess: *mut TESStesselator,
-            size: c_int,
-            pointer: *const c_void,
-            stride: c_int,
-            count: c_int,
-        );
-        pub fn tessSetOption(tess: *mut TESStesselator, option: c_int, value: c_int);
-        pub fn tessTesselate(
-            tess: *mut TESStesselator,
-            winding_rule: c_int,
-            element_type: c_int,
-            poly_size: c_int,
-            vertex_size: c_int,
-            normal: *const TESSreal,
-        ) -> c_int;
-        pub fn tessGetVertexCount(tess: *mut TESStesselator) -> c_int;
-        pub fn tessGetVertices(tess: *mut TESStesselator) -> *const TESSreal;
-        pub fn tessGetVertexIndices(tess: *mut TESStesselator) -> *const TESSindex;
-        pub fn tessGetElementCount(tess: *mut TESStesselator) -> c_int;
-        pub fn tessGetElements(tess: *mut TESStesselator) -> *const TESSindex;
-        pub fn tessGetStatus(tess: *mut TESStesselator) -> c_int;
+    // entry points of one compiled kernel; coordinate pointers are TESSreal of
+    // that kernel's precision
+    pub struct Kernel {
+        pub new_tess: unsafe extern "C" fn(*mut TESSalloc) -> *mut TESStesselator,
+        pub delete_tess: unsafe extern "C" fn(*mut TESStesselator),
+        pub add_contour:
+            unsafe extern "C" fn(*mut TESStesselator, c_int, *const c_void, c_int, c_int),
+        pub set_option: unsafe extern "C" fn(*mut TESStesselator, c_int, c_int),
+        pub tesselate: unsafe extern "C" fn(
+            *mut TESStesselator,
+            c_int,
+            c_int,
+            c_int,
+            c_int,
+            *const c_void,
+        ) -> c_int,
+        pub get_vertex_count: unsafe extern "C" fn(*mut TESStesselator) -> c_int,
+        pub get_vertices: unsafe extern "C" fn(*mut TESStesselator) -> *const c_void,
+        pub get_vertex_indices: unsafe extern "C" fn(*mut TESStesselator) -> *const TESSindex,
+        pub get_element_count: unsafe extern "C" fn(*mut TESStesselator) -> c_int,
+        pub get_elements: unsafe extern "C" fn(*mut TESStesselator) -> *const TESSindex,
+        pub get_status: unsafe extern "C" fn(*mut TESStesselator) -> c_int,
+        pub get_intersection_count: unsafe extern "C" fn(*mut TESStesselator) -> c_int,
+    }
+
+    // build.rs compiles the C sources once per TESSreal, renaming every
+    // external symbol with the kernel's prefix
+    macro_rules! kernel_bindings {
+        ($module:ident, $library:literal, $prefix:literal) => {
+            pub mod $module {
+                use super::*;
+
+                #[link(name = $library, kind = "static")]
+                unsafe extern "C" {
+                    #[link_name = concat!($prefix, "tessNewTess")]
+                    fn tessNewTess(alloc: *mut TESSalloc) -> *mut TESStesselator;
+                    #[link_name = concat!($prefix, "tessDeleteTess")]
+                    fn tessDeleteTess(tess: *mut TESStesselator);
+                    #[link_name = concat!($prefix, "tessAddContour")]
+                    fn tessAddContour(
+                        tess: *mut TESStesselator,
+                        size: c_int,
+                        pointer: *const c_void,
+                        stride: c_int,
+                        count: c_int,
+                    );
+                    #[link_name = concat!($prefix, "tessSetOption")]
+                    fn tessSetOption(tess: *mut TESStesselator, option: c_int, value: c_int);
+                    #[link_name = concat!($prefix, "tessTesselate")]
+                    fn tessTesselate(
+                        tess: *mut TESStesselator,
+                        winding_rule: c_int,
+                        element_type: c_int,
+                        poly_size: c_int,
+                        vertex_size: c_int,
+                        normal: *const c_void,
+                    ) -> c_int;
+                    #[link_name = concat!($prefix, "tessGetVertexCount")]
+                    fn tessGetVertexCount(tess: *mut TESStesselator) -> c_int;
+                    #[link_name = concat!($prefix, "tessGetVertices")]
+                    fn tessGetVertices(tess: *mut TESStesselator) -> *const c_void;
+                    #[link_name = concat!($prefix, "tessGetVertexIndices")]
+                    fn tessGetVertexIndices(tess: *mut TESStesselator) -> *const TESSindex;
+                    #[link_name = concat!($prefix, "tessGetElementCount")]
+                    fn tessGetElementCount(tess: *mut TESStesselator) -> c_int;
+                    #[link_name = concat!($prefix, "tessGetElements")]
+                    fn tessGetElements(tess: *mut TESStesselator) -> *const TESSindex;
+                    #[link_name = concat!($prefix, "tessGetStatus")]
+                    fn tessGetStatus(tess: *mut TESStesselator) -> c_int;
+                    #[link_name = concat!($prefix, "tessGetIntersectionCount")]
+                    fn tessGetIntersectionCount(tess: *mut TESStesselator) -> c_int;
+                }
+
+                pub static KERNEL: Kernel = Kernel {
+                    new_tess: tessNewTess,
+                    delete_tess: tessDeleteTess,
+                    add_contour: tessAddContour,
+                    set_option: tessSetOption,
+                    tesselate: tessTesselate,
+                    get_vertex_count: tessGetVertexCount,
+                    get_vertices: tessGetVertices,
+                    get_vertex_indices: tessGetVertexIndices,
+                    get_element_count: tessGetElementCount,
+                    get_elements: tessGetElements,
+                    get_status: tessGetStatus,
+                    get_intersection_count: tessGetIntersectionCount,
+                };
+            }
+        };
     }
+
+    kernel_bindings!(single, "tess2_upstream_f32", "tess2_f32_");
+    kernel_bindings!(double, "tess2_upstream_f64", "tess2_f64_");
+    kernel_bindings!(grid, "tess2_upstream_grid", "tess2_grid_");
 }
 
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
@@ -89,6 +221,16 @@ pub enum WindingRule {
 }
 
 impl WindingRule {
+    pub fn is_inside(self, winding: i32) -> bool {
+        match self {
+            Self::Odd => winding & 1 != 0,
+            Self::NonZero => winding != 0,
+            Self::Positive => winding > 0,
+            Self::Negative => winding < 0,
+            Self::AbsGeqTwo => winding.abs() >= 2,
+        }
+    }
+
     fn as_raw(self) -> c_int {
         match self {
             Self::Odd => raw::TESS_WINDING_ODD,
@@ -100,6 +242,28 @@ impl WindingRule {
     }
 }
 
+// which libtess2 kernel sweeps the contours; Auto picks double only for inputs
+// whose magnitude or feature size would lose precision in float, Grid snaps the
+// projected input to `cells` steps across its bounds and evaluates every sweep
+// predicate exactly in integers
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub enum Precision {
+    #[default]
+    Auto,
+    Single,
+    Double,
+    Grid {
+        cells: u32,
+    },
+}
+
+pub const DEFAULT_GRID_CELLS: u32 = 4096;
+pub const MAX_GRID_CELLS: u32 = 1 << 15;
+// libtess2 clamps its bucket allocators to this many entries per block
+const MAX_MESH_BUCKET_SIZE: c_int = 4096;
+// slack on top of the crossing estimate, which misses touching edges
+const RESERVED_CROSSING_MARGIN: usize = 8;
+
 #[derive(Debug, Clone, Copy, PartialEq)]
 pub struct TessellationOptions {
     pub winding_rule: WindingRule,
@@ -107,6 +271,23 @@ pub struct TessellationOptions {
     pub constrained_delaunay: bool,
     pub reverse_contours: bool,
     pub normalize_input: bool,
+    pub split_components: bool,
+    pub parallel_components: bool,
+    // cap on the bytes libtess2 may hold at once during a single sweep
+    pub memory_limit: Option<usize>,
+    pub precision: Precision,
+    // reorder triangles for vertex-cache reuse and renumber vertices in
+    // first-use order; the triangulation itself is unchanged
+    pub reorder_output: bool,
+    // estimate edge crossings with a coarse grid pass before the sweep and
+    // reserve room for the vertices they create, for self-intersecting input
+    // such as stroke outlines
+    pub intersection_heavy: bool,
+    // the contours are expected to be simple and pairwise disjoint: check that
+    // in near-linear time and, when it holds, triangulate by monotone
+    // decomposition instead of the sweep. input that fails the check is swept
+    // as usual
+    pub simple_input: bool,
 }
 
 impl Default for TessellationOptions {
@@ -117,15 +298,50 @@ impl Default for TessellationOptions {
             constrained_delaunay: false,
             reverse_contours: false,
             normalize_input: false,
+            split_components: false,
+            parallel_components: false,
+            memory_limit: None,
+            precision: Precision::Auto,
+            reorder_output: false,
+            intersection_heavy: false,
+            simple_input: false,
+        }
+    }
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub struct TessellationStats {
+    // high-water mark of the largest single libtess2 sweep that produced the
+    // result, which is also what memory_limit is checked against
+    pub peak_bytes: usize,
+    // edge crossings the sweep split into new vertices, summed over sweeps
+    pub intersections: usize,
+    // batches triangulated by each path: the libtess2 sweep, the strip
+    // between two nested convex loops, and monotone decomposition of simple
+    // input
+    pub swept_batches: usize,
+    pub strip_batches: usize,
+    pub monotone_batches: usize,
+}
+
+impl TessellationStats {
+    pub fn merge(self, other: Self) -> Self {
+        Self {
+            peak_bytes: self.peak_bytes.max(other.peak_bytes),
+            intersections: self.intersections + other.intersections,
+            swept_batches: self.swept_batches + other.swept_batches,
+            strip_batches: self.strip_batches + other.strip_batches,
+            monotone_batches: self.monotone_batches + other.monotone_batches,
         }
     }
 }
 
-#[derive(Debug, Clone, PartialEq)]
+#[derive(Debug, Clone, PartialEq, Default)]
 pub struct Tessellation {
     pub vertices: Vec<Float3>,
     pub source_vertex_indices: Vec<Option<usize>>,
     pub triangles: Vec<[usize; 3]>,
+    pub stats: TessellationStats,
 }
 
 #[derive(Debug, Clone, PartialEq, Eq)]
@@ -134,6 +350,7 @@ pub enum TessError {
     ContourTooShort,
     TooManyVertices,
     UnexpectedTriangleIndex(raw::TESSindex),
+    MemoryBudgetExceeded { limit: usize, requested: usize },
     Failed(TessStatus),
 }
 
@@ -146,6 +363,10 @@ impl fmt::Display for TessError {
             Self::UnexpectedTriangleIndex(index) => {
                 write!(f, "libtess2 produced unexpected triangle index {index}")
             }
+            Self::MemoryBudgetExceeded { limit, requested } => write!(
+                f,
+                "libtess2 needed {requested} bytes, exceeding its memory budget of {limit} bytes"
+            ),
             Self::Failed(TessStatus::Ok) => f.write_str("libtess2 reported an unknown failure"),
             Self::Failed(TessStatus::OutOfMemory) => f.write_str("libtess2 ran out of memory"),
             Self::Failed(TessStatus::InvalidInput) => {
@@ -159,13 +380,103 @@ impl Error for TessError {}
 
 pub struct Tessellator {
     raw: NonNull<raw::TESStesselator>,
+    kernel: &'static raw::Kernel,
+    precision: Precision,
+    // owned here and freed after the tesselator, since libtess2 calls back into
+    // it until tessDeleteTess returns
+    budget: NonNull<budget::AllocationBudget>,
 }
 
 impl Tessellator {
     pub fn new() -> Result<Self, TessError> {
-        let raw = unsafe { raw::tessNewTess(std::ptr::null_mut()) };
-        let raw = NonNull::new(raw).ok_or(TessError::CreateFailed)?;
-        Ok(Self { raw })
+        Self::with_memory_limit(None)
+    }
+
+    pub fn with_memory_limit(limit: Option<usize>) -> Result<Self, TessError> {
+        Self::with_precision(Precision::Single, limit)
+    }
+
+    // Precision::Auto has no contours to inspect yet and selects the float kernel
+    pub fn with_precision(precision: Precision, limit: Option<usize>) -> Result<Self, TessError> {
+        Self::with_reserved_vertices(precision, limit, 0)
+    }
+
+    // sizes the event queue for `extra_vertices` intersection vertices up front,
+    // and grows the mesh pools in larger blocks, so a sweep that splits many
+    // crossing edges does not keep reallocating and copying its heap arrays.
+    // the reservation counts against `limit` like any other allocation
+    pub fn with_reserved_vertices(
+        precision: Precision,
+        limit: Option<usize>,
+        extra_vertices: usize,
+    ) -> Result<Self, TessError> {
+        let (precision, kernel) = match precision {
+            Precision::Double => (Precision::Double, &raw::double::KERNEL),
+            Precision::Grid { cells } => (
+                Precision::Grid {
+                    cells: cells.clamp(1, MAX_GRID_CELLS),
+                },
+                &raw::grid::KERNEL,
+            ),
+            Precision::Auto | Precision::Single => (Precision::Single, &raw::single::KERNEL),
+        };
+        let budget = NonNull::from(Box::leak(Box::new(budget::AllocationBudget::new(limit))));
+        let mut alloc = budget::budgeted_alloc(budget.as_ptr());
+        if extra_vertices > 0 {
+            let reserved = c_int::try_from(extra_vertices).unwrap_or(c_int::MAX);
+            alloc.extra_vertices = reserved;
+            // every crossing adds one vertex and splits two edges
+            alloc.mesh_vertex_bucket_size = reserved.clamp(512, MAX_MESH_BUCKET_SIZE);
+            alloc.mesh_edge_bucket_size =
+                reserved.saturating_mul(2).clamp(512, MAX_MESH_BUCKET_SIZE);
+        }
+        let raw = unsafe { (kernel.new_tess)(&mut alloc) };
+        match NonNull::new(raw) {
+            Some(raw) => {
+                let tessellator = Self {
+                    raw,
+                    kernel,
+                    precision,
+                    budget,
+                };
+                if let Precision::Grid { cells } = precision {
+                    unsafe {
+                        (kernel.set_option)(
+                            raw.as_ptr(),
+                            raw::TESS_GRID_RESOLUTION,
+                            cells as c_int,
+                        );
+                    }
+                }
+                Ok(tessellator)
+            }
+            None => {
+                let budget = unsafe { Box::from_raw(budget.as_ptr()) };
+                Err(budget_error(&budget).unwrap_or(TessError::CreateFailed))
+            }
+        }
+    }
+
+    pub fn precision(&self) -> Precision {
+        self.precision
+    }
+
+    pub fn peak_bytes(&self) -> usize {
+        self.budget().peak_bytes
+    }
+
+    fn stats(&self) -> TessellationStats {
+        TessellationStats {
+            peak_bytes: self.peak_bytes(),
+            intersections: unsafe { (self.kernel.get_intersection_count)(self.raw.as_ptr()) }
+                as usize,
+            swept_batches: 1,
+            ..TessellationStats::default()
+        }
+    }
+
+    fn budget(&self) -> &budget::AllocationBudget {
+        unsafe { self.budget.as_ref() }
     }
 
     pub fn add_contour(&mut self, contour: &[Float3]) -> Result<(), TessError> {
@@ -175,14 +486,18 @@ impl Tessellator {
 
         let count = c_int::try_from(contour.len()).map_err(|_| TessError::TooManyVertices)?;
 
+        // libtess2 copies the coordinates, so the widened buffer only has to
+        // outlive the call
+        let widened: Vec<[f64; 3]>;
+        let (pointer, stride) = match self.precision {
+            Precision::Double => {
+                widened = contour.iter().copied().map(widen).collect();
+                (widened.as_ptr().cast(), size_of::<[f64; 3]>())
+            }
+            _ => (contour.as_ptr().cast(), size_of::<Float3>()),
+        };
         unsafe {
-            raw::tessAddContour(
-                self.raw.as_ptr(),
-                3,
-                contour.as_ptr().cast(),
-                size_of::<Float3>() as c_int,
-                count,
-            );
+            (self.kernel.add_contour)(self.raw.as_ptr(), 3, pointer, stride as c_int, count);
         }
 
         self.check_status()
@@ -190,7 +505,7 @@ impl Tessellator {
 
     pub fn set_constrained_delaunay(&mut self, enabled: bool) {
         unsafe {
-            raw::tessSetOption(
+            (self.kernel.set_option)(
                 self.raw.as_ptr(),
                 raw::TESS_CONSTRAINED_DELAUNAY_TRIANGULATION,
                 enabled as c_int,
@@ -200,7 +515,7 @@ impl Tessellator {
 
     pub fn set_reverse_contours(&mut self, enabled: bool) {
         unsafe {
-            raw::tessSetOption(
+            (self.kernel.set_option)(
                 self.raw.as_ptr(),
                 raw::TESS_REVERSE_CONTOURS,
                 enabled as c_int,
@@ -209,19 +524,30 @@ impl Tessellator {
     }
 
     pub fn tessellate(mut self, options: TessellationOptions) -> Result<Tessellation, TessError> {
+        self.run(options, raw::TESS_POLYGONS)?;
+        self.extract_tessellation()
+    }
+
+    fn run(&mut self, options: TessellationOptions, element_type: c_int) -> Result<(), TessError> {
         self.set_constrained_delaunay(options.constrained_delaunay);
         self.set_reverse_contours(options.reverse_contours);
 
         let normal = options.normal.map(Float3::to_array);
-        let normal_ptr = normal
-            .as_ref()
-            .map_or(std::ptr::null(), |normal| normal.as_ptr());
+        let wide_normal = options.normal.map(widen);
+        let normal_ptr = match self.precision {
+            Precision::Double => wide_normal
+                .as_ref()
+                .map_or(std::ptr::null(), |normal| normal.as_ptr().cast()),
+            _ => normal
+                .as_ref()
+                .map_or(std::ptr::null(), |normal| normal.as_ptr().cast()),
+        };
 
         let ok = unsafe {
-            raw::tessTesselate(
+            (self.kernel.tesselate)(
                 self.raw.as_ptr(),
                 options.winding_rule.as_raw(),
-                raw::TESS_POLYGONS,
+                element_type,
                 3,
                 3,
                 normal_ptr,
@@ -229,45 +555,23 @@ impl Tessellator {
         };
 
         if ok == 0 {
-            return Err(TessError::Failed(self.status()));
+            return Err(self.failure(self.status()));
         }
-
-        self.extract_tessellation()
+        Ok(())
     }
 
     fn extract_tessellation(&mut self) -> Result<Tessellation, TessError> {
-        let vertex_count = self.vertex_count();
         let element_count = self.element_count();
-
-        let vertices = if vertex_count == 0 {
-            Vec::new()
-        } else {
-            let raw_vertices = unsafe {
-                slice::from_raw_parts(raw::tessGetVertices(self.raw.as_ptr()), vertex_count * 3)
-            };
-            raw_vertices
-                .chunks_exact(3)
-                .map(|coords| Float3::new(coords[0], coords[1], coords[2]))
-                .collect()
-        };
-
-        let source_vertex_indices = if vertex_count == 0 {
-            Vec::new()
-        } else {
-            let indices = unsafe {
-                slice::from_raw_parts(raw::tessGetVertexIndices(self.raw.as_ptr()), vertex_count)
-            };
-            indices
-                .iter()
-                .map(|&index| source_vertex_index(index))
-                .collect()
-        };
+        let (vertices, source_vertex_indices) = self.output_vertices();
 
         let triangles = if element_count == 0 {
             Vec::new()
         } else {
             let elements = unsafe {
-                slice::from_raw_parts(raw::tessGetElements(self.raw.as_ptr()), element_count * 3)
+                slice::from_raw_parts(
+                    (self.kernel.get_elements)(self.raw.as_ptr()),
+                    element_count * 3,
+                )
             };
             let mut triangles = Vec::with_capacity(element_count);
             for triangle in elements.chunks_exact(3) {
@@ -284,37 +588,136 @@ impl Tessellator {
             vertices,
             source_vertex_indices,
             triangles,
+            stats: self.stats(),
         })
     }
 
+    fn output_vertices(&self) -> (Vec<Float3>, Vec<Option<usize>>) {
+        let vertex_count = self.vertex_count();
+        let vertices = if vertex_count == 0 {
+            Vec::new()
+        } else {
+            let raw_vertices = unsafe { (self.kernel.get_vertices)(self.raw.as_ptr()) };
+            match self.precision {
+                Precision::Double => {
+                    let raw_vertices = unsafe {
+                        slice::from_raw_parts(raw_vertices.cast::<f64>(), vertex_count * 3)
+                    };
+                    raw_vertices
+                        .chunks_exact(3)
+                        .map(|coords| {
+                            Float3::new(coords[0] as f32, coords[1] as f32, coords[2] as f32)
+                        })
+                        .collect()
+                }
+                _ => {
+                    let raw_vertices = unsafe {
+                        slice::from_raw_parts(raw_vertices.cast::<f32>(), vertex_count * 3)
+                    };
+                    raw_vertices
+                        .chunks_exact(3)
+                        .map(|coords| Float3::new(coords[0], coords[1], coords[2]))
+                        .collect()
+                }
+            }
+        };
+
+        let source_vertex_indices = if vertex_count == 0 {
+            Vec::new()
+        } else {
+            let indices = unsafe {
+                slice::from_raw_parts(
+                    (self.kernel.get_vertex_indices)(self.raw.as_ptr()),
+                    vertex_count,
+                )
+            };
+            indices
+                .iter()
+                .map(|&index| source_vertex_index(index))
+                .collect()
+        };
+
+        (vertices, source_vertex_indices)
+    }
+
     fn vertex_count(&self) -> usize {
-        unsafe { raw::tessGetVertexCount(self.raw.as_ptr()) as usize }
+        unsafe { (self.kernel.get_vertex_count)(self.raw.as_ptr()) as usize }
     }
 
     fn element_count(&self) -> usize {
-        unsafe { raw::tessGetElementCount(self.raw.as_ptr()) as usize }
+        unsafe { (self.kernel.get_element_count)(self.raw.as_ptr()) as usize }
     }
 
     fn status(&self) -> TessStatus {
-        TessStatus::from_raw(unsafe { raw::tessGetStatus(self.raw.as_ptr()) })
+        TessStatus::from_raw(unsafe { (self.kernel.get_status)(self.raw.as_ptr()) })
     }
 
     fn check_status(&self) -> Result<(), TessError> {
         match self.status() {
             TessStatus::Ok => Ok(()),
-            status => Err(TessError::Failed(status)),
+            status => Err(self.failure(status)),
         }
     }
+
+    fn failure(&self, status: TessStatus) -> TessError {
+        budget_error(self.budget()).unwrap_or(TessError::Failed(status))
+    }
 }
 
 impl Drop for Tessellator {
     fn drop(&mut self) {
         unsafe {
-            raw::tessDeleteTess(self.raw.as_ptr());
+            (self.kernel.delete_tess)(self.raw.as_ptr());
+            drop(Box::from_raw(self.budget.as_ptr()));
         }
     }
 }
 
+fn widen(point: Float3) -> [f64; 3] {
+    [point.x as f64, point.y as f64, point.z as f64]
+}
+
+// float keeps 24 mantissa bits; past this magnitude, or with features this
+// small relative to it, the sweep's edge evaluations stop separating nearby
+// vertices and the double kernel is used instead
+const SINGLE_PRECISION_MAX_COORD: f32 = 4096.0;
+const SINGLE_PRECISION_MIN_RELATIVE_FEATURE: f32 = 1e-4;
+
+fn resolve_precision(contours: &[(usize, Vec<Float3>)], precision: Precision) -> Precision {
+    if precision != Precision::Auto {
+        return precision;
+    }
+
+    let mut magnitude = 0.0f32;
+    let mut min_edge_sq = f32::INFINITY;
+    for (_, contour) in contours {
+        for (idx, point) in contour.iter().enumerate() {
+            magnitude = magnitude
+                .max(point.x.abs())
+                .max(point.y.abs())
+                .max(point.z.abs());
+            let edge_sq = (contour[(idx + 1) % contour.len()] - *point).len_sq();
+            if edge_sq > 0.0 {
+                min_edge_sq = min_edge_sq.min(edge_sq);
+            }
+        }
+    }
+
+    let min_feature = magnitude * SINGLE_PRECISION_MIN_RELATIVE_FEATURE;
+    if magnitude > SINGLE_PRECISION_MAX_COORD || min_edge_sq < min_feature * min_feature {
+        Precision::Double
+    } else {
+        Precision::Single
+    }
+}
+
+fn budget_error(budget: &budget::AllocationBudget) -> Option<TessError> {
+    Some(TessError::MemoryBudgetExceeded {
+        limit: budget.limit?,
+        requested: budget.exceeded_at?,
+    })
+}
+
 fn float3_key(point: Float3) -> [u32; 3] {
     [point.x.to_bits(), point.y.to_bits(), point.z.to_bits()]
 }
@@ -455,18 +858,20 @@ fn inferred_batch_normal(contours: &[Vec<Float3>], preferred: Option<Float3>) ->
 
     contours
         .iter()
-        .find_map(|contour| {
-            let area_normal = contour
-                .iter()
-                .copied()
-                .zip(contour.iter().copied().cycle().skip(1))
-                .take(contour.len())
-                .fold(Float3::ZERO, |acc, (a, b)| acc + a.cross(b));
-            (area_normal.len_sq() > 1e-8).then_some(area_normal.normalize())
-        })
+        .find_map(|contour| contour_area_normal(contour))
         .unwrap_or(Float3::Z)
 }
 
+fn contour_area_normal(contour: &[Float3]) -> Option<Float3> {
+    let area_normal = contour
+        .iter()
+        .copied()
+        .zip(contour.iter().copied().cycle().skip(1))
+        .take(contour.len())
+        .fold(Float3::ZERO, |acc, (a, b)| acc + a.cross(b));
+    (area_normal.len_sq() > 1e-8).then_some(area_normal.normalize())
+}
+
 #[cfg(test)]
 fn signed_area_2d(points: &[(f32, f32)]) -> f32 {
     points
@@ -511,11 +916,33 @@ fn separate_contours_with_sources(
         .collect()
 }
 
-fn triangulate_batch(
+// maps a batch's output back onto the caller's global source indices and
+// unjittered positions
+struct BatchSources {
+    original_vertices: Vec<Float3>,
+    local_to_global_source: Vec<usize>,
+}
+
+impl BatchSources {
+    fn restore(&self, vertices: &mut [Float3], sources: &mut [Option<usize>]) {
+        for (vertex, source) in vertices.iter_mut().zip(sources.iter_mut()) {
+            if let Some(local_idx) = *source {
+                *vertex = self.original_vertices[local_idx];
+            }
+            *source =
+                source.and_then(|local_idx| self.local_to_global_source.get(local_idx).copied());
+        }
+    }
+}
+
+// contours from index `second_operand` on are added as the second operand of a
+// boolean operation
+fn prepare_batch(
     contours: &[(usize, Vec<Float3>)],
     source_offsets: &[usize],
-    mut options: TessellationOptions,
-) -> Result<Tessellation, TessError> {
+    options: TessellationOptions,
+    second_operand: Option<usize>,
+) -> Result<(Tessellator, BatchSources), TessError> {
     let original_vertices = contours
         .iter()
         .flat_map(|(_, contour)| contour.iter().copied())
@@ -526,31 +953,70 @@ fn triangulate_batch(
         contours.to_vec()
     };
 
-    let mut tessellator = Tessellator::new()?;
+    let precision = resolve_precision(&contours, options.precision);
+    let extra_vertices = if options.intersection_heavy {
+        let crossings = crossings::estimate_crossings(&contours, options.normal);
+        crossings + crossings / RESERVED_CROSSING_MARGIN
+    } else {
+        0
+    };
+    let mut tessellator =
+        Tessellator::with_reserved_vertices(precision, options.memory_limit, extra_vertices)?;
     let mut local_to_global_source = Vec::new();
     for (contour_idx, contour) in &contours {
+        if second_operand.is_some_and(|start| *contour_idx >= start) {
+            tessellator.set_contour_operand(Operand::Second);
+        }
         tessellator.add_contour(contour)?;
         let offset = source_offsets[*contour_idx];
         local_to_global_source.extend((0..contour.len()).map(|vertex_idx| offset + vertex_idx));
     }
 
-    options.normalize_input = false;
-    let mut tessellation = tessellator.tessellate(options)?;
-    for source in &mut tessellation.source_vertex_indices {
-        *source = source.and_then(|local_idx| local_to_global_source.get(local_idx).copied());
+    Ok((
+        tessellator,
+        BatchSources {
+            original_vertices,
+            local_to_global_source,
+        },
+    ))
+}
+
+fn triangulate_batch(
+    contours: &[(usize, Vec<Float3>)],
+    source_offsets: &[usize],
+    options: TessellationOptions,
+) -> Result<Tessellation, TessError> {
+    if let Some(tessellation) = annulus::triangulate_annulus(contours, source_offsets, options) {
+        return Ok(tessellation);
     }
-    for (vertex, source) in tessellation
-        .vertices
-        .iter_mut()
-        .zip(tessellation.source_vertex_indices.iter().copied())
+    if options.simple_input
+        && let Some(tessellation) = monotone::triangulate_simple(contours, source_offsets, options)
     {
-        if let Some(source) = source {
-            *vertex = original_vertices[source];
-        }
+        return Ok(tessellation);
     }
+    let (tessellator, sources) = prepare_batch(contours, source_offsets, options, None)?;
+    let mut tessellation = tessellator.tessellate(TessellationOptions {
+        normalize_input: false,
+        ..options
+    })?;
+    sources.restore(
+        &mut tessellation.vertices,
+        &mut tessellation.source_vertex_indices,
+    );
     Ok(tessellation)
 }
 
+fn contour_source_offsets(contours: &[Vec<Float3>]) -> Vec<usize> {
+    contours
+        .iter()
+        .scan(0usize, |offset, contour| {
+            let current = *offset;
+            *offset += contour.len();
+            Some(current)
+        })
+        .collect()
+}
+
 pub fn triangulate<I, C>(
     contours: I,
     options: TessellationOptions,
@@ -564,24 +1030,32 @@ where
         .map(|contour| contour.as_ref().to_vec())
         .collect();
     if contours.is_empty() {
-        return Ok(Tessellation {
-            vertices: Vec::new(),
-            source_vertex_indices: Vec::new(),
-            triangles: Vec::new(),
-        });
+        return Ok(Tessellation::default());
     }
 
-    let source_offsets: Vec<_> = contours
-        .iter()
-        .scan(0usize, |offset, contour| {
-            let current = *offset;
-            *offset += contour.len();
-            Some(current)
-        })
-        .collect();
+    let source_offsets = contour_source_offsets(&contours);
+
+    let components = if options.split_components && contours.len() > 1 {
+        components::bounding_box_components(&contours, options.normal)
+    } else {
+        Vec::new()
+    };
 
     let indexed_contours = contours.into_iter().enumerate().collect::<Vec<_>>();
-    triangulate_batch(&indexed_contours, &source_offsets, options)
+    let mut tessellation = if components.len() > 1 {
+        components::triangulate_components(
+            &indexed_contours,
+            &source_offsets,
+            &components,
+            options,
+        )?
+    } else {
+        triangulate_batch(&indexed_contours, &source_offsets, options)?
+    };
+    if options.reorder_output {
+        reorder::reorder_for_locality(&mut tessellation);
+    }
+    Ok(tessellation)
 }
 
 fn triangle_index(index: raw::TESSindex) -> Result<usize, TessError> {
@@ -600,6 +1074,51 @@ fn source_vertex_index(index: raw::TESSindex) -> Option<usize> {
     }
 }
 
+// contours shared by the tests of the sweep's submodules
+#[cfg(test)]
+mod test_support {
+    use super::Float3;
+
+    pub(crate) fn square(x: f32, y: f32, size: f32) -> Vec<Float3> {
+        vec![
+            Float3::new(x, y, 0.0),
+            Float3::new(x + size, y, 0.0),
+            Float3::new(x + size, y + size, 0.0),
+            Float3::new(x, y + size, 0.0),
+        ]
+    }
+
+    // a {points/2 - 1} star polygon, whose edges all cross each other
+    pub(crate) fn star_polygon(points: usize, radius: f32) -> Vec<Float3> {
+        (0..points)
+            .map(|idx| {
+                let theta =
+                    idx as f32 * std::f32::consts::TAU * (points / 2 - 1) as f32 / points as f32;
+                Float3::new(radius * theta.cos(), radius * theta.sin(), 0.0)
+            })
+            .collect()
+    }
+
+    // counter-clockwise
+    pub(crate) fn circle(center: (f32, f32), radius: f32, samples: usize) -> Vec<Float3> {
+        (0..samples)
+            .map(|idx| {
+                let theta = idx as f32 * std::f32::consts::TAU / samples as f32;
+                Float3::new(
+                    center.0 + radius * theta.cos(),
+                    center.1 + radius * theta.sin(),
+                    0.0,
+                )
+            })
+            .collect()
+    }
+
+    pub(crate) fn reversed(mut contour: Vec<Float3>) -> Vec<Float3> {
+        contour.reverse();
+        contour
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -791,6 +1310,152 @@ mod tests {
         assert_eq!(source_indices, vec![0, 1, 2, 3, 4, 5, 6, 7]);
     }
 
+    #[test]
+    fn double_kernel_matches_single_kernel_on_a_square() {
+        let contour = [
+            Float3::new(0.0, 0.0, 0.0),
+            Float3::new(1.0, 0.0, 0.0),
+            Float3::new(1.0, 1.0, 0.0),
+            Float3::new(0.0, 1.0, 0.0),
+        ];
+
+        let single = triangulate(
+            [contour.as_slice()],
+            TessellationOptions {
+                precision: Precision::Single,
+                ..TessellationOptions::default()
+            },
+        )
+        .unwrap();
+        let double = triangulate(
+            [contour.as_slice()],
+            TessellationOptions {
+                precision: Precision::Double,
+                ..TessellationOptions::default()
+            },
+        )
+        .unwrap();
+
+        assert_eq!(single.vertices, double.vertices);
+        assert_eq!(single.triangles, double.triangles);
+    }
+
+    #[test]
+    fn auto_precision_promotes_large_or_finely_detailed_inputs() {
+        let square = |offset: f32, size: f32| {
+            vec![(
+                0,
+                vec![
+                    Float3::new(offset, offset, 0.0),
+                    Float3::new(offset + size, offset, 0.0),
+                    Float3::new(offset + size, offset + size, 0.0),
+                    Float3::new(offset, offset + size, 0.0),
+                ],
+            )]
+        };
+
+        assert_eq!(
+            resolve_precision(&square(0.0, 1.0), Precision::Auto),
+            Precision::Single
+        );
+        assert_eq!(
+            resolve_precision(&square(10_000.0, 1.0), Precision::Auto),
+            Precision::Double
+        );
+        assert_eq!(
+            resolve_precision(&square(100.0, 1e-3), Precision::Auto),
+            Precision::Double
+        );
+        assert_eq!(
+            resolve_precision(&square(10_000.0, 1.0), Precision::Single),
+            Precision::Single
+        );
+    }
+
+    #[test]
+    fn double_kernel_resolves_crossings_far_from_the_origin() {
+        let offset = 100_000.0;
+        let bowtie = [
+            Float3::new(offset, offset, 0.0),
+            Float3::new(offset + 0.5, offset + 0.5, 0.0),
+            Float3::new(offset + 0.5, offset, 0.0),
+            Float3::new(offset, offset + 0.5, 0.0),
+        ];
+
+        let tessellation =
+            triangulate([bowtie.as_slice()], TessellationOptions::default()).unwrap();
+
+        assert_eq!(tessellation.triangles.len(), 2);
+        assert_eq!(tessellation.vertices.len(), 5);
+    }
+
+    fn triangle_area_sum(tessellation: &Tessellation) -> f32 {
+        tessellation
+            .triangles
+            .iter()
+            .map(|face| {
+                let [a, b, c] = face.map(|idx| tessellation.vertices[idx]);
+                (b - a).cross(c - a).len() * 0.5
+            })
+            .sum()
+    }
+
+    #[test]
+    fn grid_kernel_is_deterministic_and_matches_float_area() {
+        let star: Vec<_> = (0..257)
+            .map(|idx| {
+                let theta = idx as f32 * std::f32::consts::TAU * 100.0 / 257.0;
+                let radius = 1.0 + 0.25 * (idx as f32 * 0.7).sin();
+                Float3::new(radius * theta.cos(), radius * theta.sin(), 0.0)
+            })
+            .collect();
+        let options = TessellationOptions {
+            winding_rule: WindingRule::NonZero,
+            ..TessellationOptions::default()
+        };
+        let grid_options = TessellationOptions {
+            precision: Precision::Grid {
+                cells: DEFAULT_GRID_CELLS,
+            },
+            ..options
+        };
+
+        let float = triangulate([star.as_slice()], options).unwrap();
+        let grid = triangulate([star.as_slice()], grid_options).unwrap();
+        let again = triangulate([star.as_slice()], grid_options).unwrap();
+
+        assert_eq!(grid, again);
+        let float_area = triangle_area_sum(&float);
+        let grid_area = triangle_area_sum(&grid);
+        assert!(
+            (float_area - grid_area).abs() < float_area * 1e-2,
+            "{float_area} vs {grid_area}"
+        );
+    }
+
+    #[test]
+    fn grid_kernel_merges_vertices_within_a_cell() {
+        let contour = [
+            Float3::new(0.0, 0.0, 0.0),
+            Float3::new(1.0, 0.0, 0.0),
+            Float3::new(1.0, 1.0, 0.0),
+            Float3::new(1e-5, 1.0, 0.0),
+            Float3::new(0.0, 1.0, 0.0),
+        ];
+
+        let tessellation = triangulate(
+            [contour.as_slice()],
+            TessellationOptions {
+                precision: Precision::Grid { cells: 16 },
+                ..TessellationOptions::default()
+            },
+        )
+        .unwrap();
+
+        assert_eq!(tessellation.triangles.len(), 2);
+        assert!((triangle_area_sum(&tessellation) - 1.0).abs() < 1e-4);
+    }
+
     fn point_in_triangle_2d(point: (f32, f32), a: Float3, b: Float3, c: Float3) -> bool {
         let cross = |p0: (f32, f32), p1: (f32, f32), p2: (f32, f32)| {
             (p1.0 - p0.0) * (p2.1 - p0.1) - (p1.1 - p0.1) * (p2.0 - p0.0)
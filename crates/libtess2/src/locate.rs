@@ -0,0 +1,411 @@
+use crate::{Float3, WindingRule, polygon_basis};
+
+const TARGET_ITEMS_PER_CELL: usize = 2;
+const MAX_LOCATOR_CELLS: usize = 1 << 20;
+// long slivers from monotone triangulation can straddle many cells; coarsen the
+// grid until the bucket lists stay within this many entries per item
+const MAX_ENTRIES_PER_ITEM: usize = 16;
+
+pub(crate) type Point2 = [f32; 2];
+
+// buckets items by the cells their bounds overlap; a grid with a single column
+// is a set of horizontal bands
+#[derive(Debug, Clone)]
+pub(crate) struct UniformGrid {
+    origin: Point2,
+    inv_cell: Point2,
+    dims: [usize; 2],
+    offsets: Vec<u32>,
+    items: Vec<u32>,
+}
+
+impl UniformGrid {
+    pub(crate) fn build(bounds: &[(Point2, Point2)], bands_only: bool) -> Self {
+        let mut min = [f32::INFINITY; 2];
+        let mut max = [f32::NEG_INFINITY; 2];
+        for (lo, hi) in bounds {
+            for axis in 0..2 {
+                min[axis] = min[axis].min(lo[axis]);
+                max[axis] = max[axis].max(hi[axis]);
+            }
+        }
+        if bounds.is_empty() {
+            (min, max) = ([0.0; 2], [0.0; 2]);
+        }
+
+        let extent = [(max[0] - min[0]).max(1e-6), (max[1] - min[1]).max(1e-6)];
+        let mut cells = if bands_only {
+            // a ray query walks its whole band, so keep bands near sqrt(n) deep
+            ((bounds.len() as f32).sqrt() as usize).clamp(1, MAX_LOCATOR_CELLS)
+        } else {
+            (bounds.len() / TARGET_ITEMS_PER_CELL).clamp(1, MAX_LOCATOR_CELLS)
+        };
+        let mut grid = loop {
+            let dims = if bands_only {
+                [1, cells]
+            } else {
+                // square-ish cells over the bounds
+                let columns =
+                    ((cells as f32 * extent[0] / extent[1]).sqrt().ceil() as usize).clamp(1, cells);
+                [columns, cells.div_ceil(columns).max(1)]
+            };
+            let grid = Self {
+                origin: min,
+                inv_cell: [dims[0] as f32 / extent[0], dims[1] as f32 / extent[1]],
+                dims,
+                offsets: vec![0; dims[0] * dims[1] + 1],
+                items: Vec::new(),
+            };
+            let entries: usize = bounds
+                .iter()
+                .map(|(lo, hi)| {
+                    (grid.cell_coord(hi[0], 0) - grid.cell_coord(lo[0], 0) + 1)
+                        * (grid.cell_coord(hi[1], 1) - grid.cell_coord(lo[1], 1) + 1)
+                })
+                .sum();
+            if cells == 1 || entries <= MAX_ENTRIES_PER_ITEM * bounds.len() {
+                break grid;
+            }
+            cells /= 4;
+        };
+        let dims = grid.dims;
+
+        for (lo, hi) in bounds {
+            grid.for_each_cell(*lo, *hi, |grid, cell| grid.offsets[cell + 1] += 1);
+        }
+        for cell in 0..dims[0] * dims[1] {
+            grid.offsets[cell + 1] += grid.offsets[cell];
+        }
+        let mut fill = grid.offsets.clone();
+        grid.items = vec![0; grid.offsets[dims[0] * dims[1]] as usize];
+        for (item, (lo, hi)) in bounds.iter().enumerate() {
+            grid.for_each_cell(*lo, *hi, |grid, cell| {
+                grid.items[fill[cell] as usize] = item as u32;
+                fill[cell] += 1;
+            });
+        }
+        grid
+    }
+
+    fn cell_coord(&self, value: f32, axis: usize) -> usize {
+        let cell = ((value - self.origin[axis]) * self.inv_cell[axis]).floor();
+        cell.clamp(0.0, (self.dims[axis] - 1) as f32) as usize
+    }
+
+    fn for_each_cell(&mut self, lo: Point2, hi: Point2, mut visit: impl FnMut(&mut Self, usize)) {
+        let (x0, x1) = (self.cell_coord(lo[0], 0), self.cell_coord(hi[0], 0));
+        let (y0, y1) = (self.cell_coord(lo[1], 1), self.cell_coord(hi[1], 1));
+        for y in y0..=y1 {
+            for x in x0..=x1 {
+                visit(self, y * self.dims[0] + x);
+            }
+        }
+    }
+
+    // items whose bounds overlap the cell holding `point`; points outside the
+    // grid fall into the nearest border cell and are rejected by the caller
+    fn items_at(&self, point: Point2) -> &[u32] {
+        self.cell_items(self.cell_at(point))
+    }
+
+    pub(crate) fn cell_at(&self, point: Point2) -> usize {
+        self.cell_coord(point[1], 1) * self.dims[0] + self.cell_coord(point[0], 0)
+    }
+
+    pub(crate) fn cell_count(&self) -> usize {
+        self.dims[0] * self.dims[1]
+    }
+
+    pub(crate) fn cell_items(&self, cell: usize) -> &[u32] {
+        &self.items[self.offsets[cell] as usize..self.offsets[cell + 1] as usize]
+    }
+}
+
+pub(crate) fn project(point: Float3, basis: (Float3, Float3)) -> Point2 {
+    [point.dot(basis.0), point.dot(basis.1)]
+}
+
+pub(crate) fn cross(o: Point2, a: Point2, b: Point2) -> f32 {
+    (a[0] - o[0]) * (b[1] - o[1]) - (a[1] - o[1]) * (b[0] - o[0])
+}
+
+fn segment_distance_sq(point: Point2, a: Point2, b: Point2) -> f32 {
+    let ab = [b[0] - a[0], b[1] - a[1]];
+    let ap = [point[0] - a[0], point[1] - a[1]];
+    let len_sq = ab[0] * ab[0] + ab[1] * ab[1];
+    let t = if len_sq > 0.0 {
+        ((ap[0] * ab[0] + ap[1] * ab[1]) / len_sq).clamp(0.0, 1.0)
+    } else {
+        0.0
+    };
+    let d = [ap[0] - ab[0] * t, ap[1] - ab[1] * t];
+    d[0] * d[0] + d[1] * d[1]
+}
+
+// answers point-in-fill queries against a triangulation by projecting onto the
+// plane of `normal` and testing only the triangles bucketed in the query's
+// grid cell; build once per mesh and keep it alongside the mesh
+#[derive(Debug, Clone)]
+pub struct PointLocator {
+    basis: (Float3, Float3),
+    triangles: Vec<[Point2; 3]>,
+    tolerances: Vec<f32>,
+    grid: UniformGrid,
+}
+
+impl PointLocator {
+    // points within `tolerance` of a triangle (in the projected plane) count as
+    // inside it; bounds are padded by the same amount
+    pub fn new(
+        vertices: &[Float3],
+        triangles: &[[usize; 3]],
+        normal: Float3,
+        tolerance: f32,
+    ) -> Self {
+        Self::with_tolerances(
+            vertices,
+            triangles,
+            normal,
+            &vec![tolerance; triangles.len()],
+        )
+    }
+
+    // like new, but with each triangle's own tolerance, so one small triangle
+    // needing a wide margin does not pad every other triangle's bounds with it
+    pub fn with_tolerances(
+        vertices: &[Float3],
+        triangles: &[[usize; 3]],
+        normal: Float3,
+        tolerances: &[f32],
+    ) -> Self {
+        let (basis_x, basis_y, _) = polygon_basis(normal);
+        let basis = (basis_x, basis_y);
+        let projected: Vec<_> = vertices
+            .iter()
+            .map(|&vertex| project(vertex, basis))
+            .collect();
+        let triangles: Vec<[Point2; 3]> = triangles
+            .iter()
+            .map(|face| face.map(|vertex| projected[vertex]))
+            .collect();
+        let bounds: Vec<_> = triangles
+            .iter()
+            .zip(tolerances)
+            .map(|(corners, &tolerance)| {
+                let mut lo = corners[0];
+                let mut hi = corners[0];
+                for corner in &corners[1..] {
+                    for axis in 0..2 {
+                        lo[axis] = lo[axis].min(corner[axis]);
+                        hi[axis] = hi[axis].max(corner[axis]);
+                    }
+                }
+                (
+                    [lo[0] - tolerance, lo[1] - tolerance],
+                    [hi[0] + tolerance, hi[1] + tolerance],
+                )
+            })
+            .collect();
+
+        Self {
+            basis,
+            grid: UniformGrid::build(&bounds, false),
+            triangles,
+            tolerances: tolerances.to_vec(),
+        }
+    }
+
+    pub fn triangle_count(&self) -> usize {
+        self.triangles.len()
+    }
+
+    // triangles whose padded bounds share the query's cell; a superset of the
+    // triangles that contain the point
+    pub fn candidates(&self, point: Float3) -> impl Iterator<Item = usize> + '_ {
+        self.grid
+            .items_at(project(point, self.basis))
+            .iter()
+            .map(|&triangle| triangle as usize)
+    }
+
+    pub fn locate(&self, point: Float3) -> Option<usize> {
+        let point = project(point, self.basis);
+        self.grid
+            .items_at(point)
+            .iter()
+            .map(|&triangle| triangle as usize)
+            .find(|&triangle| self.triangle_contains(triangle, point))
+    }
+
+    pub fn contains(&self, point: Float3) -> bool {
+        self.locate(point).is_some()
+    }
+
+    fn triangle_contains(&self, triangle: usize, point: Point2) -> bool {
+        let [a, b, c] = self.triangles[triangle];
+        let area = cross(a, b, c);
+        let sign = if area < 0.0 { -1.0 } else { 1.0 };
+        let inside = area != 0.0
+            && [(a, b), (b, c), (c, a)]
+                .iter()
+                .all(|&(from, to)| sign * cross(from, to, point) >= 0.0);
+        inside
+            || [(a, b), (b, c), (c, a)].iter().any(|&(from, to)| {
+                let tolerance = self.tolerances[triangle];
+                segment_distance_sq(point, from, to) <= tolerance * tolerance
+            })
+    }
+}
+
+// winding numbers of a contour set, from the edges bucketed in the query's
+// horizontal band; matches the winding libtess2 would compute for the same
+// contours and normal
+#[derive(Debug, Clone)]
+pub struct WindingIndex {
+    basis: (Float3, Float3),
+    edges: Vec<[Point2; 2]>,
+    bands: UniformGrid,
+}
+
+impl WindingIndex {
+    pub fn new<I, C>(contours: I, normal: Float3) -> Self
+    where
+        I: IntoIterator<Item = C>,
+        C: AsRef<[Float3]>,
+    {
+        let (basis_x, basis_y, _) = polygon_basis(normal);
+        let basis = (basis_x, basis_y);
+        let mut edges = Vec::new();
+        for contour in contours {
+            let contour = contour.as_ref();
+            for (idx, &point) in contour.iter().enumerate() {
+                let next = contour[(idx + 1) % contour.len()];
+                edges.push([project(point, basis), project(next, basis)]);
+            }
+        }
+        let bounds: Vec<_> = edges
+            .iter()
+            .map(|&[a, b]| {
+                (
+                    [a[0].min(b[0]), a[1].min(b[1])],
+                    [a[0].max(b[0]), a[1].max(b[1])],
+                )
+            })
+            .collect();
+
+        Self {
+            basis,
+            bands: UniformGrid::build(&bounds, true),
+            edges,
+        }
+    }
+
+    // counts signed crossings of the ray from the point towards +x; only the
+    // point's band can hold edges spanning its height
+    pub fn winding_number(&self, point: Float3) -> i32 {
+        let point = project(point, self.basis);
+        let mut winding = 0;
+        for &edge in self.bands.items_at(point) {
+            let [a, b] = self.edges[edge as usize];
+            if a[1] <= point[1] {
+                if b[1] > point[1] && cross(a, b, point) > 0.0 {
+                    winding += 1;
+                }
+            } else if b[1] <= point[1] && cross(a, b, point) < 0.0 {
+                winding -= 1;
+            }
+        }
+        winding
+    }
+
+    pub fn contains(&self, point: Float3, winding_rule: WindingRule) -> bool {
+        winding_rule.is_inside(self.winding_number(point))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::test_support::{circle, reversed};
+    use crate::{TessellationOptions, triangulate};
+
+    fn brute_force_contains(locator: &PointLocator, point: Float3) -> bool {
+        let point = project(point, locator.basis);
+        (0..locator.triangles.len()).any(|triangle| locator.triangle_contains(triangle, point))
+    }
+
+    #[test]
+    fn locator_matches_a_brute_force_scan() {
+        let contours: Vec<_> = (0..16)
+            .flat_map(|idx| {
+                let center = ((idx % 4) as f32 * 3.0, (idx / 4) as f32 * 3.0);
+                [circle(center, 1.0, 48), reversed(circle(center, 0.5, 24))]
+            })
+            .collect();
+        let tessellation = triangulate(
+            &contours,
+            TessellationOptions {
+                winding_rule: WindingRule::NonZero,
+                normal: Some(Float3::Z),
+                ..TessellationOptions::default()
+            },
+        )
+        .unwrap();
+        let locator = PointLocator::new(
+            &tessellation.vertices,
+            &tessellation.triangles,
+            Float3::Z,
+            1e-4,
+        );
+
+        for idx in 0..4000 {
+            let point = Float3::new(
+                (idx % 80) as f32 * 0.15 - 1.5,
+                (idx / 80) as f32 * 0.25 - 1.5,
+                0.0,
+            );
+            assert_eq!(
+                locator.contains(point),
+                brute_force_contains(&locator, point)
+            );
+        }
+        assert!(locator.contains(Float3::new(0.75, 0.0, 0.0)));
+        assert!(!locator.contains(Float3::new(0.0, 0.0, 0.0)));
+        assert!(!locator.contains(Float3::new(100.0, 100.0, 0.0)));
+    }
+
+    #[test]
+    fn tolerances_pad_each_triangle_on_its_own() {
+        let vertices = [
+            Float3::new(0.0, 0.0, 0.0),
+            Float3::new(10.0, 0.0, 0.0),
+            Float3::new(0.0, 10.0, 0.0),
+            Float3::new(20.0, 0.0, 0.0),
+            Float3::new(20.01, 0.0, 0.0),
+            Float3::new(20.0, 0.01, 0.0),
+        ];
+        let triangles = [[0, 1, 2], [3, 4, 5]];
+        let locator = PointLocator::with_tolerances(&vertices, &triangles, Float3::Z, &[1e-4, 0.5]);
+
+        assert!(locator.contains(Float3::new(20.3, 0.0, 0.0)));
+        assert!(!locator.contains(Float3::new(-0.3, 5.0, 0.0)));
+        assert!(locator.contains(Float3::new(-0.00005, 5.0, 0.0)));
+    }
+
+    #[test]
+    fn winding_index_counts_nested_contours() {
+        let contours = [
+            circle((0.0, 0.0), 3.0, 64),
+            circle((0.0, 0.0), 2.0, 64),
+            reversed(circle((0.0, 0.0), 1.0, 64)),
+        ];
+        let index = WindingIndex::new(&contours, Float3::Z);
+
+        assert_eq!(index.winding_number(Float3::new(2.5, 0.1, 0.0)), 1);
+        assert_eq!(index.winding_number(Float3::new(0.0, 1.5, 0.0)), 2);
+        assert_eq!(index.winding_number(Float3::new(0.2, 0.3, 0.0)), 1);
+        assert_eq!(index.winding_number(Float3::new(-4.0, 0.0, 0.0)), 0);
+        assert!(index.contains(Float3::new(0.0, 1.5, 0.0), WindingRule::AbsGeqTwo));
+        assert!(!index.contains(Float3::new(0.0, 1.5, 0.0), WindingRule::Odd));
+    }
+}
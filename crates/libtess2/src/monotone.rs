@@ -0,0 +1,828 @@
+use std::cmp::Ordering;
+
+use crate::{
+    Float3, Tessellation, TessellationOptions, TessellationStats, crossings,
+    locate::{Point2, project},
+    polygon_basis,
+};
+
+// nesting is settled by testing one vertex of every contour against every
+// other contour; batches that would need more tests than this are swept
+const MAX_NESTING_TESTS: usize = 1 << 22;
+// lawson flips allowed per triangle before the delaunay pass settles for what
+// it has, so rounding on cocircular points cannot cycle
+const MAX_FLIPS_PER_TRIANGLE: usize = 16;
+// edges the monotone split keeps crossing the sweep line at once; it scans
+// them linearly, so regions that would need more are swept instead
+const MAX_STATUS_EDGES: usize = 64;
+
+type Point = [f64; 2];
+
+// triangulates contours that are simple and pairwise disjoint without the
+// sweep's intersection machinery: each contour is kept or dropped by the
+// winding rule, the kept ones are split into y-monotone pieces by a plane
+// sweep, and each piece is triangulated with a stack. vertices come back in
+// input order with their source indices, and triangles face the same way as
+// the sweep's. returns None when the contours are not simple (or the batch
+// needs options this path does not implement), leaving it to the sweep
+pub(crate) fn triangulate_simple(
+    contours: &[(usize, Vec<Float3>)],
+    source_offsets: &[usize],
+    options: TessellationOptions,
+) -> Option<Tessellation> {
+    // the predicates here are exact on the input floats, which is what grid
+    // precision buys the sweep, so it needs no snapping of its own
+    if options.reverse_contours {
+        return None;
+    }
+    if contours.is_empty() || contours.iter().any(|(_, contour)| contour.len() < 3) {
+        return None;
+    }
+    let vertex_count: usize = contours.iter().map(|(_, contour)| contour.len()).sum();
+    if contours.len().saturating_mul(vertex_count) > MAX_NESTING_TESTS {
+        return None;
+    }
+
+    // without a normal, libtess2 orients the plane so the contours' total
+    // area is positive
+    let normal = options
+        .normal
+        .filter(|normal| normal.len_sq() > 0.0)
+        .map(Float3::normalize)
+        .or_else(|| {
+            let area = contours
+                .iter()
+                .flat_map(|(_, contour)| {
+                    (0..contour.len())
+                        .map(|idx| contour[idx].cross(contour[(idx + 1) % contour.len()]))
+                })
+                .fold(Float3::ZERO, |sum, area| sum + area);
+            (area.len_sq() > 1e-8).then(|| area.normalize())
+        })?;
+    let (basis_x, basis_y, _) = polygon_basis(normal);
+    let projected: Vec<Vec<Point2>> = contours
+        .iter()
+        .map(|(_, contour)| {
+            contour
+                .iter()
+                .map(|&point| project(point, (basis_x, basis_y)))
+                .collect()
+        })
+        .collect();
+    if !crossings::contours_are_simple(&projected) {
+        return None;
+    }
+    let signs: Vec<i32> = projected
+        .iter()
+        .map(|contour| signed_area(contour).signum() as i32)
+        .collect();
+    if signs.contains(&0) {
+        return None;
+    }
+
+    // contours are disjoint, so they nest as a tree; each contour's parent is
+    // the smallest one holding it, and the winding just outside a contour is
+    // the sum of the orientations of everything holding it
+    let areas: Vec<f64> = projected
+        .iter()
+        .map(|contour| signed_area(contour).abs())
+        .collect();
+    let mut parents = vec![None; projected.len()];
+    let mut outside = vec![0; projected.len()];
+    for (contour_idx, contour) in projected.iter().enumerate() {
+        for other in 0..projected.len() {
+            if other == contour_idx || !contains(&projected[other], contour[0]) {
+                continue;
+            }
+            outside[contour_idx] += signs[other];
+            if parents[contour_idx].is_none_or(|parent: usize| areas[other] < areas[parent]) {
+                parents[contour_idx] = Some(other);
+            }
+        }
+    }
+    let filled_inside: Vec<bool> = (0..projected.len())
+        .map(|contour_idx| {
+            options
+                .winding_rule
+                .is_inside(outside[contour_idx] + signs[contour_idx])
+        })
+        .collect();
+
+    // like the sweep, a contour stays when either side of it is filled, even
+    // if both are
+    let mut points = Vec::with_capacity(vertex_count);
+    let mut starts = vec![None; projected.len()];
+    let mut tessellation = Tessellation {
+        stats: TessellationStats {
+            monotone_batches: 1,
+            ..TessellationStats::default()
+        },
+        ..Tessellation::default()
+    };
+    for (contour_idx, contour) in projected.iter().enumerate() {
+        if !filled_inside[contour_idx] && !options.winding_rule.is_inside(outside[contour_idx]) {
+            continue;
+        }
+        starts[contour_idx] = Some(points.len());
+        points.extend(contour.iter().map(|point| point.map(f64::from)));
+        let (source_idx, ref original) = contours[contour_idx];
+        tessellation.vertices.extend_from_slice(original);
+        tessellation
+            .source_vertex_indices
+            .extend((0..original.len()).map(|vertex| Some(source_offsets[source_idx] + vertex)));
+    }
+    // the loop through a kept contour's points, turned by `counter_clockwise`
+    let as_loop = |contour_idx: usize, counter_clockwise: bool| {
+        let start = starts[contour_idx].unwrap();
+        let mut order: Vec<usize> = (start..start + projected[contour_idx].len()).collect();
+        if (signs[contour_idx] > 0) != counter_clockwise {
+            order.reverse();
+        }
+        order
+    };
+
+    // every filled inside is its own region: the contour counter-clockwise
+    // and its children as clockwise holes, so the region is left of all loops
+    for contour_idx in (0..projected.len()).filter(|&contour_idx| filled_inside[contour_idx]) {
+        let mut loops = vec![as_loop(contour_idx, true)];
+        loops.extend(
+            (0..projected.len())
+                .filter(|&child| parents[child] == Some(contour_idx))
+                .map(|child| as_loop(child, false)),
+        );
+        tessellation
+            .triangles
+            .extend(triangulate_loops(&points, &loops)?);
+    }
+    if options.constrained_delaunay {
+        let contour_edge = |a: usize, b: usize| {
+            starts.iter().zip(&projected).any(|(start, contour)| {
+                start.is_some_and(|start| {
+                    let range = start..start + contour.len();
+                    range.contains(&a)
+                        && range.contains(&b)
+                        && ((a + 1 - start) % contour.len() == b - start
+                            || (b + 1 - start) % contour.len() == a - start)
+                })
+            })
+        };
+        refine_delaunay(&points, &mut tessellation.triangles, contour_edge);
+    }
+    Some(tessellation)
+}
+
+// crossing-number test; the point is never on the contour, since contours
+// that touch are not simple
+fn contains(contour: &[Point2], point: Point2) -> bool {
+    let mut inside = false;
+    for idx in 0..contour.len() {
+        let (a, b) = (contour[idx], contour[(idx + 1) % contour.len()]);
+        if (a[1] > point[1]) != (b[1] > point[1]) {
+            let x = a[0] as f64
+                + (point[1] as f64 - a[1] as f64) * (b[0] as f64 - a[0] as f64)
+                    / (b[1] as f64 - a[1] as f64);
+            if (point[0] as f64) < x {
+                inside = !inside;
+            }
+        }
+    }
+    inside
+}
+
+fn signed_area(contour: &[Point2]) -> f64 {
+    (0..contour.len())
+        .map(|idx| {
+            let (a, b) = (contour[idx], contour[(idx + 1) % contour.len()]);
+            a[0] as f64 * b[1] as f64 - a[1] as f64 * b[0] as f64
+        })
+        .sum()
+}
+
+#[derive(Debug, Clone, Copy, PartialEq)]
+enum VertexKind {
+    Start,
+    Split,
+    End,
+    Merge,
+    Regular,
+}
+
+// sweep order: higher first, and left first at equal height
+fn above(points: &[Point], lhs: usize, rhs: usize) -> bool {
+    let (a, b) = (points[lhs], points[rhs]);
+    a[1] > b[1] || (a[1] == b[1] && a[0] < b[0])
+}
+
+fn sweep_order(points: &[Point], lhs: usize, rhs: usize) -> Ordering {
+    if lhs == rhs {
+        Ordering::Equal
+    } else if above(points, lhs, rhs) {
+        Ordering::Less
+    } else {
+        Ordering::Greater
+    }
+}
+
+fn cross(o: Point, a: Point, b: Point) -> f64 {
+    (a[0] - o[0]) * (b[1] - o[1]) - (a[1] - o[1]) * (b[0] - o[0])
+}
+
+// splits the region left of the loops into y-monotone pieces and triangulates
+// each (de berg et al., computational geometry, ch. 3). None when rounding
+// leaves the sweep without an edge it needs, or when more than
+// MAX_STATUS_EDGES edges cross the sweep line at once
+fn triangulate_loops(points: &[Point], loops: &[Vec<usize>]) -> Option<Vec<[usize; 3]>> {
+    // numbered locally, loop after loop, so a region costs only its own size
+    let global: Vec<usize> = loops.iter().flatten().copied().collect();
+    let points: Vec<Point> = global.iter().map(|&vertex| points[vertex]).collect();
+    let points = points.as_slice();
+    let mut prev = Vec::with_capacity(points.len());
+    let mut next = Vec::with_capacity(points.len());
+    for order in loops {
+        let start = prev.len();
+        for idx in 0..order.len() {
+            prev.push(start + (idx + order.len() - 1) % order.len());
+            next.push(start + (idx + 1) % order.len());
+        }
+    }
+    let mut events: Vec<usize> = (0..points.len()).collect();
+    events.sort_unstable_by(|&lhs, &rhs| sweep_order(points, lhs, rhs));
+
+    let kinds: Vec<VertexKind> = (0..points.len())
+        .map(|vertex| {
+            let (before, after) = (prev[vertex], next[vertex]);
+            let convex = cross(points[before], points[vertex], points[after]) > 0.0;
+            match (above(points, vertex, before), above(points, vertex, after)) {
+                (true, true) if convex => VertexKind::Start,
+                (true, true) => VertexKind::Split,
+                (false, false) if convex => VertexKind::End,
+                (false, false) => VertexKind::Merge,
+                _ => VertexKind::Regular,
+            }
+        })
+        .collect();
+    // x where the edge leaving `edge` crosses the sweep line through `y`
+    let x_at = |edge: usize, y: f64| {
+        let (a, b) = (points[edge], points[next[edge]]);
+        if a[1] == b[1] {
+            a[0].min(b[0])
+        } else {
+            a[0] + (y - a[1]) * (b[0] - a[0]) / (b[1] - a[1])
+        }
+    };
+
+    // edges with the region on their right, each named by its first vertex.
+    // the status is scanned rather than kept ordered; it only holds the edges
+    // crossing the sweep line, which for outlines is a handful, and is capped
+    // so a region with many side-by-side teeth or holes cannot go quadratic
+    let mut status: Vec<usize> = Vec::new();
+    let mut helper = vec![usize::MAX; points.len()];
+    let mut diagonals = Vec::new();
+    let open_edge = |status: &mut Vec<usize>, vertex: usize| {
+        (status.len() < MAX_STATUS_EDGES).then(|| status.push(vertex))
+    };
+    let left_of = |status: &[usize], vertex: usize| {
+        let [x, y] = points[vertex];
+        status
+            .iter()
+            .copied()
+            .map(|edge| (edge, x_at(edge, y)))
+            .filter(|&(_, edge_x)| edge_x < x)
+            .max_by(|lhs, rhs| lhs.1.total_cmp(&rhs.1))
+            .map(|(edge, _)| edge)
+    };
+    let finish_edge =
+        |status: &mut Vec<usize>, diagonals: &mut Vec<_>, helper: &[usize], vertex: usize| {
+            let edge = prev[vertex];
+            let at = status.iter().position(|&open| open == edge)?;
+            status.swap_remove(at);
+            if kinds[helper[edge]] == VertexKind::Merge {
+                diagonals.push((vertex, helper[edge]));
+            }
+            Some(())
+        };
+
+    for &vertex in &events {
+        match kinds[vertex] {
+            VertexKind::Start => {
+                open_edge(&mut status, vertex)?;
+                helper[vertex] = vertex;
+            }
+            VertexKind::End => finish_edge(&mut status, &mut diagonals, &helper, vertex)?,
+            VertexKind::Split => {
+                let left = left_of(&status, vertex)?;
+                diagonals.push((vertex, helper[left]));
+                helper[left] = vertex;
+                open_edge(&mut status, vertex)?;
+                helper[vertex] = vertex;
+            }
+            VertexKind::Merge => {
+                finish_edge(&mut status, &mut diagonals, &helper, vertex)?;
+                let left = left_of(&status, vertex)?;
+                if kinds[helper[left]] == VertexKind::Merge {
+                    diagonals.push((vertex, helper[left]));
+                }
+                helper[left] = vertex;
+            }
+            // the region is on the right while the boundary runs downward
+            VertexKind::Regular if above(points, prev[vertex], vertex) => {
+                finish_edge(&mut status, &mut diagonals, &helper, vertex)?;
+                open_edge(&mut status, vertex)?;
+                helper[vertex] = vertex;
+            }
+            VertexKind::Regular => {
+                let left = left_of(&status, vertex)?;
+                if kinds[helper[left]] == VertexKind::Merge {
+                    diagonals.push((vertex, helper[left]));
+                }
+                helper[left] = vertex;
+            }
+        }
+    }
+
+    let mut triangles = Vec::with_capacity(points.len() + 2 * loops.len());
+    for piece in monotone_pieces(points, &next, &diagonals)? {
+        triangulate_monotone(points, &piece, &mut triangles)?;
+    }
+    Some(
+        triangles
+            .into_iter()
+            .map(|triangle| triangle.map(|vertex| global[vertex]))
+            .collect(),
+    )
+}
+
+// walks the faces left of the loop edges and both sides of every diagonal
+fn monotone_pieces(
+    points: &[Point],
+    next: &[usize],
+    diagonals: &[(usize, usize)],
+) -> Option<Vec<Vec<usize>>> {
+    // outgoing edges of every vertex, counter-clockwise by direction; most
+    // vertices only have their loop edge
+    let mut first = vec![1; points.len() + 1];
+    first[points.len()] = 0;
+    for &(a, b) in diagonals {
+        first[a] += 1;
+        first[b] += 1;
+    }
+    let mut total = 0;
+    for count in &mut first {
+        (*count, total) = (total, total + *count);
+    }
+    let mut targets = vec![usize::MAX; total];
+    let mut fill = first.clone();
+    let mut push = |from: usize, to: usize| {
+        targets[fill[from]] = to;
+        fill[from] += 1;
+    };
+    for (vertex, &to) in next.iter().enumerate() {
+        push(vertex, to);
+    }
+    for &(a, b) in diagonals {
+        push(a, b);
+        push(b, a);
+    }
+    for from in 0..points.len() {
+        let around = &mut targets[first[from]..first[from + 1]];
+        if around.len() > 1 {
+            around.sort_unstable_by(|&lhs, &rhs| {
+                direction_order(
+                    sub(points[lhs], points[from]),
+                    sub(points[rhs], points[from]),
+                )
+            });
+        }
+    }
+
+    let mut visited = vec![false; total];
+    let mut pieces = Vec::new();
+    for start in 0..total {
+        if visited[start] {
+            continue;
+        }
+        let from = first.partition_point(|&offset| offset <= start) - 1;
+        let mut piece = Vec::new();
+        let (mut a, mut edge) = (from, start);
+        while !visited[edge] {
+            visited[edge] = true;
+            piece.push(a);
+            let b = targets[edge];
+            // the next edge is the first one clockwise from the way back
+            let around = &targets[first[b]..first[b + 1]];
+            let slot = if around.len() == 1 {
+                0
+            } else {
+                let back = sub(points[a], points[b]);
+                let at = around.partition_point(|&target| {
+                    direction_order(sub(points[target], points[b]), back) == Ordering::Less
+                });
+                (at + around.len() - 1) % around.len()
+            };
+            (a, edge) = (b, first[b] + slot);
+        }
+        if edge != start {
+            return None;
+        }
+        pieces.push(piece);
+    }
+    Some(pieces)
+}
+
+fn sub(a: Point, b: Point) -> Point {
+    [a[0] - b[0], a[1] - b[1]]
+}
+
+// by angle from +x, counter-clockwise, without trigonometry
+fn direction_order(lhs: Point, rhs: Point) -> Ordering {
+    let upper =
+        |direction: Point| direction[1] > 0.0 || (direction[1] == 0.0 && direction[0] > 0.0);
+    match (upper(lhs), upper(rhs)) {
+        (true, false) => Ordering::Less,
+        (false, true) => Ordering::Greater,
+        _ => 0.0f64.total_cmp(&cross([0.0, 0.0], lhs, rhs)),
+    }
+}
+
+// stack triangulation of a counter-clockwise y-monotone polygon
+fn triangulate_monotone(
+    points: &[Point],
+    piece: &[usize],
+    triangles: &mut Vec<[usize; 3]>,
+) -> Option<()> {
+    if piece.len() < 3 {
+        return None;
+    }
+    let top = (0..piece.len()).min_by(|&lhs, &rhs| sweep_order(points, piece[lhs], piece[rhs]))?;
+    let bottom =
+        (0..piece.len()).max_by(|&lhs, &rhs| sweep_order(points, piece[lhs], piece[rhs]))?;
+    // counter-clockwise from the top runs down the left chain
+    let mut on_left = vec![false; piece.len()];
+    let mut at = top;
+    while at != bottom {
+        on_left[at] = true;
+        at = (at + 1) % piece.len();
+    }
+    let mut order: Vec<usize> = (0..piece.len()).collect();
+    order.sort_unstable_by(|&lhs, &rhs| sweep_order(points, piece[lhs], piece[rhs]));
+
+    let mut emit = |a: usize, b: usize, c: usize| {
+        let [a, b, c] = [a, b, c].map(|at| piece[at]);
+        triangles.push(if cross(points[a], points[b], points[c]) >= 0.0 {
+            [a, b, c]
+        } else {
+            [a, c, b]
+        });
+    };
+    let mut stack = vec![order[0], order[1]];
+    for &current in &order[2..order.len() - 1] {
+        let last = *stack.last()?;
+        if on_left[current] != on_left[last] {
+            for pair in stack.windows(2) {
+                emit(current, pair[0], pair[1]);
+            }
+            stack = vec![last, current];
+        } else {
+            let mut last = stack.pop()?;
+            while let Some(&stacked) = stack.last() {
+                let turn = cross(
+                    points[piece[current]],
+                    points[piece[last]],
+                    points[piece[stacked]],
+                );
+                let inside = if on_left[current] {
+                    turn < 0.0
+                } else {
+                    turn > 0.0
+                };
+                if !inside {
+                    break;
+                }
+                emit(current, last, stacked);
+                last = stack.pop()?;
+            }
+            stack.push(last);
+            stack.push(current);
+        }
+    }
+    let lowest = order[order.len() - 1];
+    for pair in stack.windows(2) {
+        emit(lowest, pair[0], pair[1]);
+    }
+    Some(())
+}
+
+// lawson flips across every edge that is not on a contour; the triangles must
+// be counter-clockwise in `points`
+pub(crate) fn refine_delaunay(
+    points: &[Point],
+    triangles: &mut [[usize; 3]],
+    contour_edge: impl Fn(usize, usize) -> bool,
+) {
+    const NONE: usize = usize::MAX;
+    // neighbors[t][k] is the triangle across the edge from corner k to k + 1,
+    // left as NONE on contours so they are never flipped
+    let mut neighbors = vec![[NONE; 3]; triangles.len()];
+    let mut edges: Vec<(usize, usize, usize, usize)> = triangles
+        .iter()
+        .enumerate()
+        .flat_map(|(triangle_idx, triangle)| {
+            (0..3).map(move |corner| {
+                let (a, b) = (triangle[corner], triangle[(corner + 1) % 3]);
+                (a.min(b), a.max(b), triangle_idx, corner)
+            })
+        })
+        .collect();
+    edges.sort_unstable();
+    let mut pending = Vec::new();
+    for pair in edges.windows(2) {
+        let ((a, b, first, first_corner), (c, d, second, second_corner)) = (pair[0], pair[1]);
+        if (a, b) == (c, d) && !contour_edge(a, b) {
+            neighbors[first][first_corner] = second;
+            neighbors[second][second_corner] = first;
+            pending.push((
+                first,
+                triangles[first][first_corner],
+                triangles[first][(first_corner + 1) % 3],
+            ));
+        }
+    }
+
+    let corner_of = |triangle: [usize; 3], a: usize, b: usize| {
+        (0..3).find(|&corner| triangle[corner] == a && triangle[(corner + 1) % 3] == b)
+    };
+    let mut flips_left = triangles.len() * MAX_FLIPS_PER_TRIANGLE;
+    while let Some((first, a, b)) = pending.pop() {
+        let Some(first_corner) = corner_of(triangles[first], a, b) else {
+            continue;
+        };
+        let second = neighbors[first][first_corner];
+        if second == NONE {
+            continue;
+        }
+        let Some(second_corner) = corner_of(triangles[second], b, a) else {
+            continue;
+        };
+        let c = triangles[first][(first_corner + 2) % 3];
+        let d = triangles[second][(second_corner + 2) % 3];
+        let [pa, pb, pc, pd] = [a, b, c, d].map(|vertex| points[vertex]);
+        // the flipped pair must stay counter-clockwise
+        if !in_circle(pa, pb, pc, pd) || cross(pa, pd, pc) <= 0.0 || cross(pd, pb, pc) <= 0.0 {
+            continue;
+        }
+        if flips_left == 0 {
+            break;
+        }
+        flips_left -= 1;
+
+        let across_bc = neighbors[first][(first_corner + 1) % 3];
+        let across_ca = neighbors[first][(first_corner + 2) % 3];
+        let across_ad = neighbors[second][(second_corner + 1) % 3];
+        let across_db = neighbors[second][(second_corner + 2) % 3];
+        triangles[first] = [a, d, c];
+        triangles[second] = [d, b, c];
+        neighbors[first] = [across_ad, second, across_ca];
+        neighbors[second] = [across_db, across_bc, first];
+        for (across, from, to) in [(across_ad, second, first), (across_bc, first, second)] {
+            if across != NONE {
+                for neighbor in &mut neighbors[across] {
+                    if *neighbor == from {
+                        *neighbor = to;
+                    }
+                }
+            }
+        }
+        pending.extend([(first, a, d), (second, d, b), (second, b, c), (first, c, a)]);
+    }
+}
+
+// whether d is strictly inside the circle through counter-clockwise a, b, c,
+// with a margin so cocircular points are left alone
+fn in_circle(a: Point, b: Point, c: Point, d: Point) -> bool {
+    let [ad, bd, cd] = [a, b, c].map(|point| sub(point, d));
+    let lift = |point: Point| point[0] * point[0] + point[1] * point[1];
+    let det = lift(ad) * (bd[0] * cd[1] - cd[0] * bd[1])
+        + lift(bd) * (cd[0] * ad[1] - ad[0] * cd[1])
+        + lift(cd) * (ad[0] * bd[1] - bd[0] * ad[1]);
+    let magnitude = lift(ad) * (bd[0] * cd[1]).abs().max((cd[0] * bd[1]).abs())
+        + lift(bd) * (cd[0] * ad[1]).abs().max((ad[0] * cd[1]).abs())
+        + lift(cd) * (ad[0] * bd[1]).abs().max((bd[0] * ad[1]).abs());
+    det > magnitude * 1e-9
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::test_support::{reversed, square};
+    use crate::{WindingRule, contour_source_offsets, triangulate};
+
+    // teeth hanging down from a bar and rising from a floor bar, so every
+    // vertex kind turns up; the offsets keep the points in general position
+    fn combs(teeth: usize) -> Vec<Float3> {
+        let wobble = |idx: usize| (idx * 37 % 11) as f32 * 0.01;
+        let mut contour = Vec::new();
+        for idx in 0..teeth {
+            let x = idx as f32 * 2.0;
+            contour.push(Float3::new(x + wobble(idx), -3.0 - wobble(idx + 1), 0.0));
+            contour.push(Float3::new(x + 1.0, 0.0 + wobble(idx + 2), 0.0));
+        }
+        let right = teeth as f32 * 2.0;
+        contour.push(Float3::new(right, -3.5, 0.0));
+        contour.push(Float3::new(right + 0.3, 6.1, 0.0));
+        for idx in (0..teeth).rev() {
+            let x = idx as f32 * 2.0;
+            contour.push(Float3::new(x + 1.3, 9.0 + wobble(idx + 3), 0.0));
+            contour.push(Float3::new(x + 0.2, 2.0 + wobble(idx + 4), 0.0));
+        }
+        contour.push(Float3::new(-0.7, 9.2, 0.0));
+        contour
+    }
+
+    fn star(points: usize, radius: f32) -> Vec<Float3> {
+        (0..points * 2)
+            .map(|idx| {
+                let theta = idx as f32 * std::f32::consts::PI / points as f32 + 0.1;
+                let r = if idx % 2 == 0 { radius } else { radius * 0.45 };
+                Float3::new(r * theta.cos(), r * theta.sin(), 0.0)
+            })
+            .collect()
+    }
+
+    fn fast(contours: &[Vec<Float3>], options: TessellationOptions) -> Option<Tessellation> {
+        let indexed: Vec<_> = contours.iter().cloned().enumerate().collect();
+        triangulate_simple(&indexed, &contour_source_offsets(contours), options)
+    }
+
+    fn signed_areas(tessellation: &Tessellation) -> Vec<f32> {
+        tessellation
+            .triangles
+            .iter()
+            .map(|face| {
+                let [a, b, c] = face.map(|vertex| tessellation.vertices[vertex]);
+                (b - a).cross(c - a).z / 2.0
+            })
+            .collect()
+    }
+
+    // triangles as sorted source indices, for comparing triangulations that
+    // number their vertices differently
+    fn source_triangles(tessellation: &Tessellation) -> Vec<[usize; 3]> {
+        let mut triangles: Vec<_> = tessellation
+            .triangles
+            .iter()
+            .map(|face| {
+                let mut face =
+                    face.map(|vertex| tessellation.source_vertex_indices[vertex].unwrap());
+                face.sort_unstable();
+                face
+            })
+            .collect();
+        triangles.sort_unstable();
+        triangles
+    }
+
+    fn assert_matches_sweep(contours: &[Vec<Float3>], options: TessellationOptions) {
+        let fast = fast(contours, options).expect("simple input should take the fast path");
+        let swept = triangulate(contours, options).unwrap();
+        assert_eq!(fast.stats.monotone_batches, 1);
+        assert_eq!(swept.stats.swept_batches, 1);
+
+        let mut fast_sources = fast.source_vertex_indices.clone();
+        let mut swept_sources = swept.source_vertex_indices.clone();
+        fast_sources.sort_unstable();
+        swept_sources.sort_unstable();
+        assert_eq!(fast_sources, swept_sources);
+        assert_eq!(fast.triangles.len(), swept.triangles.len());
+
+        let (fast_areas, swept_areas) = (signed_areas(&fast), signed_areas(&swept));
+        let sign = swept_areas[0].signum();
+        assert!(fast_areas.iter().all(|area| area.signum() == sign));
+        let total = |areas: &[f32]| areas.iter().sum::<f32>();
+        assert!(
+            (total(&fast_areas) - total(&swept_areas)).abs() < 1e-4 * total(&swept_areas).abs()
+        );
+
+        if options.constrained_delaunay {
+            assert_eq!(source_triangles(&fast), source_triangles(&swept));
+        }
+    }
+
+    #[test]
+    fn simple_shapes_match_the_sweep() {
+        let arrow = vec![
+            Float3::new(0.0, -0.2, 0.0),
+            Float3::new(2.0, -0.2, 0.0),
+            Float3::new(2.0, -0.6, 0.0),
+            Float3::new(3.0, 0.0, 0.0),
+            Float3::new(2.0, 0.6, 0.0),
+            Float3::new(2.0, 0.2, 0.0),
+            Float3::new(0.0, 0.2, 0.0),
+        ];
+        let holes = vec![
+            square(0.0, 0.0, 10.0),
+            reversed(square(1.0, 1.0, 2.0)),
+            reversed(square(5.0, 6.0, 3.0)),
+        ];
+        for normal in [None, Some(Float3::Z), Some(-Float3::Z)] {
+            for winding_rule in [WindingRule::Odd, WindingRule::NonZero] {
+                let options = TessellationOptions {
+                    winding_rule,
+                    normal,
+                    ..TessellationOptions::default()
+                };
+                assert_matches_sweep(&[arrow.clone()], options);
+                assert_matches_sweep(&[star(7, 2.0)], options);
+                assert_matches_sweep(&[combs(9)], options);
+                assert_matches_sweep(&[reversed(combs(4))], options);
+                assert_matches_sweep(&holes, options);
+            }
+        }
+    }
+
+    #[test]
+    fn nesting_follows_the_winding_rule() {
+        // an island inside a hole, and a second outline inside the first
+        // wound the same way, which only odd fills as a hole
+        let contours = vec![
+            square(0.0, 0.0, 10.0),
+            reversed(square(1.0, 1.0, 6.0)),
+            square(2.0, 2.0, 2.0),
+            square(8.0, 8.0, 1.0),
+        ];
+        for winding_rule in [
+            WindingRule::Odd,
+            WindingRule::NonZero,
+            WindingRule::Positive,
+            WindingRule::AbsGeqTwo,
+        ] {
+            assert_matches_sweep(
+                &contours,
+                TessellationOptions {
+                    winding_rule,
+                    normal: Some(Float3::Z),
+                    ..TessellationOptions::default()
+                },
+            );
+        }
+    }
+
+    #[test]
+    fn delaunay_refinement_matches_the_sweep() {
+        let options = TessellationOptions {
+            winding_rule: WindingRule::NonZero,
+            normal: Some(Float3::Z),
+            constrained_delaunay: true,
+            ..TessellationOptions::default()
+        };
+        assert_matches_sweep(&[combs(12)], options);
+        assert_matches_sweep(&[square(-5.0, -4.0, 10.3), reversed(star(5, 2.0))], options);
+    }
+
+    #[test]
+    fn input_that_is_not_simple_is_swept() {
+        let bowtie = vec![
+            Float3::new(0.0, 0.0, 0.0),
+            Float3::new(2.0, 2.0, 0.0),
+            Float3::new(2.0, 0.0, 0.0),
+            Float3::new(0.0, 2.0, 0.0),
+        ];
+        let overlapping = vec![square(0.0, 0.0, 2.0), square(1.0, 1.0, 2.0)];
+        let touching = vec![square(0.0, 0.0, 2.0), square(2.0, 0.0, 2.0)];
+        let mut doubled = square(0.0, 0.0, 2.0);
+        doubled.insert(2, doubled[1]);
+        // simple, but with more edges across the sweep line than the split
+        // scans; turned so its teeth line up across the sweep, which runs
+        // along x for a +z normal
+        let wide_comb = combs(2 * MAX_STATUS_EDGES)
+            .into_iter()
+            .map(|point| Float3::new(point.y, point.x, 0.0))
+            .collect();
+        for contours in [
+            vec![bowtie],
+            overlapping,
+            touching,
+            vec![doubled],
+            vec![wide_comb],
+        ] {
+            let options = TessellationOptions {
+                simple_input: true,
+                ..TessellationOptions::default()
+            };
+            assert!(fast(&contours, options).is_none());
+            let swept = triangulate(&contours, options).unwrap();
+            assert_eq!(swept.stats.swept_batches, 1);
+            assert_eq!(swept.stats.monotone_batches, 0);
+        }
+
+        let simple = triangulate(
+            [combs(3)],
+            TessellationOptions {
+                simple_input: true,
+                ..TessellationOptions::default()
+            },
+        )
+        .unwrap();
+        assert_eq!(simple.stats.monotone_batches, 1);
+        assert_eq!(simple.stats.swept_batches, 0);
+    }
+}
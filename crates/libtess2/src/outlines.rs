@@ -0,0 +1,234 @@
+use std::{ops::Range, slice};
+
+use crate::{
+    Float3, TessError, TessellationOptions, TessellationStats, Tessellator, components,
+    contour_source_offsets, prepare_batch, raw, triangle_index,
+};
+
+// boundary loops separating the filled region (per the winding rule) from the
+// rest of the plane; loops never cross each other or themselves
+#[derive(Debug, Clone, PartialEq, Default)]
+pub struct Outlines {
+    pub vertices: Vec<Float3>,
+    pub source_vertex_indices: Vec<Option<usize>>,
+    // each range of vertices is one closed loop; outer loops wind
+    // counter-clockwise about the normal and holes clockwise
+    pub contours: Vec<Range<usize>>,
+    pub stats: TessellationStats,
+}
+
+impl Tessellator {
+    // runs the sweep without triangulating, so constrained_delaunay is ignored
+    pub fn resolve_outlines(mut self, options: TessellationOptions) -> Result<Outlines, TessError> {
+        self.run(
+            TessellationOptions {
+                constrained_delaunay: false,
+                ..options
+            },
+            raw::TESS_BOUNDARY_CONTOURS,
+        )?;
+        self.extract_outlines()
+    }
+
+    fn extract_outlines(&mut self) -> Result<Outlines, TessError> {
+        let (vertices, source_vertex_indices) = self.output_vertices();
+        let element_count = self.element_count();
+        let contours = if element_count == 0 {
+            Vec::new()
+        } else {
+            let elements = unsafe {
+                slice::from_raw_parts(
+                    (self.kernel.get_elements)(self.raw.as_ptr()),
+                    element_count * 2,
+                )
+            };
+            elements
+                .chunks_exact(2)
+                .map(|element| {
+                    let start = triangle_index(element[0])?;
+                    let count = triangle_index(element[1])?;
+                    if start + count > vertices.len() {
+                        return Err(TessError::UnexpectedTriangleIndex(element[0]));
+                    }
+                    Ok(start..start + count)
+                })
+                .collect::<Result<_, _>>()?
+        };
+
+        Ok(Outlines {
+            vertices,
+            source_vertex_indices,
+            contours,
+            stats: self.stats(),
+        })
+    }
+}
+
+pub fn resolve_outlines<I, C>(
+    contours: I,
+    options: TessellationOptions,
+) -> Result<Outlines, TessError>
+where
+    I: IntoIterator<Item = C>,
+    C: AsRef<[Float3]>,
+{
+    let contours: Vec<_> = contours
+        .into_iter()
+        .map(|contour| contour.as_ref().to_vec())
+        .collect();
+    if contours.is_empty() {
+        return Ok(Outlines::default());
+    }
+
+    let source_offsets = contour_source_offsets(&contours);
+    let components = if options.split_components && contours.len() > 1 {
+        components::bounding_box_components(&contours, options.normal)
+    } else {
+        Vec::new()
+    };
+
+    let indexed_contours = contours.into_iter().enumerate().collect::<Vec<_>>();
+    if components.len() <= 1 {
+        return outline_batch(&indexed_contours, &source_offsets, options);
+    }
+
+    let mut merged = Outlines::default();
+    for component in components {
+        let batch: Vec<_> = component
+            .iter()
+            .map(|&contour_idx| indexed_contours[contour_idx].clone())
+            .collect();
+        let part = outline_batch(&batch, &source_offsets, options)?;
+        let offset = merged.vertices.len();
+        merged.vertices.extend(part.vertices);
+        merged
+            .source_vertex_indices
+            .extend(part.source_vertex_indices);
+        merged.contours.extend(
+            part.contours
+                .into_iter()
+                .map(|range| range.start + offset..range.end + offset),
+        );
+        merged.stats = merged.stats.merge(part.stats);
+    }
+    Ok(merged)
+}
+
+fn outline_batch(
+    contours: &[(usize, Vec<Float3>)],
+    source_offsets: &[usize],
+    options: TessellationOptions,
+) -> Result<Outlines, TessError> {
+    let (tessellator, sources) = prepare_batch(contours, source_offsets, options, None)?;
+    let mut outlines = tessellator.resolve_outlines(TessellationOptions {
+        normalize_input: false,
+        ..options
+    })?;
+    sources.restore(&mut outlines.vertices, &mut outlines.source_vertex_indices);
+    Ok(outlines)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::WindingRule;
+    use crate::test_support::square;
+
+    fn signed_area(outlines: &Outlines, contour: &Range<usize>) -> f32 {
+        let points = &outlines.vertices[contour.clone()];
+        (0..points.len())
+            .map(|idx| {
+                let a = points[idx];
+                let b = points[(idx + 1) % points.len()];
+                a.x * b.y - a.y * b.x
+            })
+            .sum::<f32>()
+            * 0.5
+    }
+
+    #[test]
+    fn overlapping_squares_resolve_to_a_single_outline() {
+        let outlines = resolve_outlines(
+            [square(0.0, 0.0, 2.0), square(1.0, 1.0, 2.0)],
+            TessellationOptions {
+                winding_rule: WindingRule::NonZero,
+                normal: Some(Float3::Z),
+                ..TessellationOptions::default()
+            },
+        )
+        .unwrap();
+
+        assert_eq!(outlines.contours.len(), 1);
+        let contour = outlines.contours[0].clone();
+        assert_eq!(contour.len(), 8);
+        assert!((signed_area(&outlines, &contour) - 7.0).abs() < 1e-5);
+        let intersections = outlines.source_vertex_indices[contour]
+            .iter()
+            .filter(|source| source.is_none())
+            .count();
+        assert_eq!(intersections, 2);
+    }
+
+    #[test]
+    fn holes_come_back_with_opposite_orientation() {
+        let mut hole = square(1.0, 1.0, 1.0);
+        hole.reverse();
+
+        let outlines = resolve_outlines(
+            [square(0.0, 0.0, 3.0), hole],
+            TessellationOptions {
+                winding_rule: WindingRule::NonZero,
+                normal: Some(Float3::Z),
+                ..TessellationOptions::default()
+            },
+        )
+        .unwrap();
+
+        let mut areas: Vec<_> = outlines
+            .contours
+            .iter()
+            .map(|contour| signed_area(&outlines, contour))
+            .collect();
+        areas.sort_by(f32::total_cmp);
+        assert_eq!(areas.len(), 2);
+        assert!((areas[0] + 1.0).abs() < 1e-5);
+        assert!((areas[1] - 9.0).abs() < 1e-5);
+        for (vertex, source) in outlines
+            .vertices
+            .iter()
+            .zip(&outlines.source_vertex_indices)
+        {
+            let source = source.expect("nested squares do not intersect");
+            let expected = if source < 4 {
+                square(0.0, 0.0, 3.0)[source]
+            } else {
+                let mut hole = square(1.0, 1.0, 1.0);
+                hole.reverse();
+                hole[source - 4]
+            };
+            assert_eq!(*vertex, expected);
+        }
+    }
+
+    #[test]
+    fn split_components_offset_contour_ranges() {
+        let outlines = resolve_outlines(
+            [square(0.0, 0.0, 1.0), square(5.0, 0.0, 1.0)],
+            TessellationOptions {
+                normal: Some(Float3::Z),
+                split_components: true,
+                ..TessellationOptions::default()
+            },
+        )
+        .unwrap();
+
+        assert_eq!(outlines.contours, vec![0..4, 4..8]);
+        let mut sources: Vec<_> = outlines
+            .source_vertex_indices
+            .iter()
+            .map(|source| source.unwrap())
+            .collect();
+        sources.sort_unstable();
+        assert_eq!(sources, (0..8).collect::<Vec<_>>());
+    }
+}
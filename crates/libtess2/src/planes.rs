@@ -0,0 +1,356 @@
+use crate::{
+    Float3, TessError, Tessellation, TessellationOptions, components, contour_area_normal,
+    contour_source_offsets, inferred_batch_normal, reorder,
+};
+
+// how far a contour may stray from a plane and still be swept with it
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct PlaneTolerance {
+    // radians between the contour's area normal and the plane's (either sign)
+    pub angle: f32,
+    // distance of every contour vertex from the plane
+    pub distance: f32,
+}
+
+impl Default for PlaneTolerance {
+    fn default() -> Self {
+        Self {
+            angle: 1e-3,
+            distance: 1e-4,
+        }
+    }
+}
+
+// points p with normal.dot(p) == offset
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct Plane {
+    pub normal: Float3,
+    pub offset: f32,
+}
+
+impl Plane {
+    fn distance(&self, point: Float3) -> f32 {
+        (self.normal.dot(point) - self.offset).abs()
+    }
+}
+
+#[derive(Debug, Clone, PartialEq)]
+pub struct PlaneGroup {
+    pub plane: Plane,
+    // indices into the input contours, in input order
+    pub contours: Vec<usize>,
+}
+
+#[derive(Debug, Clone, PartialEq, Default)]
+pub struct PlanarTessellation {
+    pub tessellation: Tessellation,
+    pub planes: Vec<Plane>,
+    // index into planes for every triangle
+    pub triangle_planes: Vec<usize>,
+}
+
+// clusters contours by the plane they lie in. each group takes the area normal
+// of its first contour, turned to face `preferred` when that is given (and
+// replaced by it when they are parallel), so opposite-wound holes join their
+// outer contour. contours without area join the first plane holding all their
+// vertices, or the first group when none does
+pub fn group_by_plane<C: AsRef<[Float3]>>(
+    contours: &[C],
+    preferred: Option<Float3>,
+    tolerance: PlaneTolerance,
+) -> Vec<PlaneGroup> {
+    let preferred = preferred
+        .filter(|normal| normal.len_sq() > 0.0)
+        .map(Float3::normalize);
+    let min_cos = tolerance.angle.cos();
+    let fits = |plane: &Plane, contour: &[Float3]| {
+        let distance = tolerance
+            .distance
+            .max(magnitude(contour) * f32::EPSILON * 16.0);
+        contour
+            .iter()
+            .all(|&point| plane.distance(point) <= distance)
+    };
+
+    let mut groups: Vec<PlaneGroup> = Vec::new();
+    let mut flat = Vec::new();
+    for (contour_idx, contour) in contours.iter().enumerate() {
+        let contour = contour.as_ref();
+        let Some(normal) = contour_area_normal(contour) else {
+            flat.push(contour_idx);
+            continue;
+        };
+        let existing = groups.iter_mut().find(|group| {
+            group.plane.normal.dot(normal).abs() >= min_cos && fits(&group.plane, contour)
+        });
+        match existing {
+            Some(group) => group.contours.push(contour_idx),
+            None => {
+                let normal = orient(normal, preferred, min_cos);
+                let centroid = contour.iter().fold(Float3::ZERO, |sum, &point| sum + point)
+                    / contour.len() as f32;
+                groups.push(PlaneGroup {
+                    plane: Plane {
+                        normal,
+                        offset: normal.dot(centroid),
+                    },
+                    contours: vec![contour_idx],
+                });
+            }
+        }
+    }
+
+    if groups.is_empty() {
+        let all: Vec<_> = contours
+            .iter()
+            .map(|contour| contour.as_ref().to_vec())
+            .collect();
+        let normal = inferred_batch_normal(&all, preferred);
+        let offset = all
+            .iter()
+            .flatten()
+            .next()
+            .map_or(0.0, |&point| normal.dot(point));
+        return vec![PlaneGroup {
+            plane: Plane { normal, offset },
+            contours: (0..contours.len()).collect(),
+        }];
+    }
+    for contour_idx in flat {
+        let contour = contours[contour_idx].as_ref();
+        let group = groups
+            .iter()
+            .position(|group| fits(&group.plane, contour))
+            .unwrap_or(0);
+        let members = &mut groups[group].contours;
+        let at = members.partition_point(|&member| member < contour_idx);
+        members.insert(at, contour_idx);
+    }
+    groups
+}
+
+// tessellates contours from several planes in one call: each plane group is
+// swept with its own projection (and split into components when asked), the
+// sweeps share one worker pool, and the parts are merged plane by plane with
+// source indices numbered over all input contours
+pub fn triangulate_planes<I, C>(
+    contours: I,
+    tolerance: PlaneTolerance,
+    options: TessellationOptions,
+) -> Result<PlanarTessellation, TessError>
+where
+    I: IntoIterator<Item = C>,
+    C: AsRef<[Float3]>,
+{
+    let contours: Vec<_> = contours
+        .into_iter()
+        .map(|contour| contour.as_ref().to_vec())
+        .collect();
+    if contours.is_empty() {
+        return Ok(PlanarTessellation::default());
+    }
+
+    let groups = group_by_plane(&contours, options.normal, tolerance);
+    let source_offsets = contour_source_offsets(&contours);
+    let mut batches = Vec::new();
+    let mut batch_options = Vec::new();
+    let mut batch_planes = Vec::new();
+    for (plane_idx, group) in groups.iter().enumerate() {
+        let group_options = TessellationOptions {
+            normal: Some(group.plane.normal),
+            reorder_output: false,
+            ..options
+        };
+        let group_contours: Vec<_> = group
+            .contours
+            .iter()
+            .map(|&contour_idx| contours[contour_idx].clone())
+            .collect();
+        let parts = if options.split_components && group_contours.len() > 1 {
+            components::bounding_box_components(&group_contours, Some(group.plane.normal))
+        } else {
+            vec![(0..group_contours.len()).collect()]
+        };
+        for part in parts {
+            batches.push(
+                part.iter()
+                    .map(|&member| {
+                        let contour_idx = group.contours[member];
+                        (contour_idx, contours[contour_idx].clone())
+                    })
+                    .collect::<Vec<_>>(),
+            );
+            batch_options.push(group_options);
+            batch_planes.push(plane_idx);
+        }
+    }
+
+    let mut per_plane = vec![Tessellation::default(); groups.len()];
+    let parts = components::triangulate_batches(&batches, &source_offsets, &batch_options);
+    for (part, plane_idx) in parts.into_iter().zip(batch_planes) {
+        components::append_tessellation(&mut per_plane[plane_idx], part?);
+    }
+
+    let mut merged = PlanarTessellation {
+        planes: groups.iter().map(|group| group.plane).collect(),
+        ..PlanarTessellation::default()
+    };
+    for (plane_idx, mut part) in per_plane.into_iter().enumerate() {
+        if options.reorder_output {
+            reorder::reorder_for_locality(&mut part);
+        }
+        merged
+            .triangle_planes
+            .extend(std::iter::repeat_n(plane_idx, part.triangles.len()));
+        components::append_tessellation(&mut merged.tessellation, part);
+    }
+    Ok(merged)
+}
+
+fn orient(normal: Float3, preferred: Option<Float3>, min_cos: f32) -> Float3 {
+    match preferred {
+        Some(preferred) if preferred.dot(normal).abs() >= min_cos => preferred,
+        Some(preferred) if preferred.dot(normal) < 0.0 => -normal,
+        _ => normal,
+    }
+}
+
+fn magnitude(contour: &[Float3]) -> f32 {
+    contour
+        .iter()
+        .flat_map(|point| point.to_array())
+        .fold(0.0, |max, value| max.max(value.abs()))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::test_support::square;
+    use crate::{WindingRule, triangulate};
+
+    // the faces of the unit cube, each wound counter-clockwise seen from outside
+    fn cube_faces() -> Vec<Vec<Float3>> {
+        let corner = |x: f32, y: f32, z: f32| Float3::new(x, y, z);
+        vec![
+            vec![
+                corner(0., 0., 0.),
+                corner(0., 1., 0.),
+                corner(1., 1., 0.),
+                corner(1., 0., 0.),
+            ],
+            vec![
+                corner(0., 0., 1.),
+                corner(1., 0., 1.),
+                corner(1., 1., 1.),
+                corner(0., 1., 1.),
+            ],
+            vec![
+                corner(0., 0., 0.),
+                corner(1., 0., 0.),
+                corner(1., 0., 1.),
+                corner(0., 0., 1.),
+            ],
+            vec![
+                corner(0., 1., 0.),
+                corner(0., 1., 1.),
+                corner(1., 1., 1.),
+                corner(1., 1., 0.),
+            ],
+            vec![
+                corner(0., 0., 0.),
+                corner(0., 0., 1.),
+                corner(0., 1., 1.),
+                corner(0., 1., 0.),
+            ],
+            vec![
+                corner(1., 0., 0.),
+                corner(1., 1., 0.),
+                corner(1., 1., 1.),
+                corner(1., 0., 1.),
+            ],
+        ]
+    }
+
+    #[test]
+    fn cube_faces_are_swept_in_their_own_planes() {
+        let faces = cube_faces();
+        let result = triangulate_planes(
+            &faces,
+            PlaneTolerance::default(),
+            TessellationOptions {
+                split_components: true,
+                ..TessellationOptions::default()
+            },
+        )
+        .unwrap();
+
+        assert_eq!(result.planes.len(), 6);
+        assert_eq!(result.tessellation.triangles.len(), 12);
+        assert_eq!(result.triangle_planes.len(), 12);
+        let tessellation = &result.tessellation;
+        for (face, &plane_idx) in tessellation.triangles.iter().zip(&result.triangle_planes) {
+            let plane = result.planes[plane_idx];
+            let [a, b, c] = face.map(|vertex| tessellation.vertices[vertex]);
+            // outward winding survives and every corner is on its own plane
+            assert!((b - a).cross(c - a).dot(plane.normal) > 0.0);
+            for point in [a, b, c] {
+                assert!(plane.distance(point) < 1e-6);
+            }
+        }
+        let mut sources: Vec<_> = tessellation
+            .source_vertex_indices
+            .iter()
+            .map(|source| source.unwrap())
+            .collect();
+        sources.sort_unstable();
+        assert_eq!(sources, (0..24).collect::<Vec<_>>());
+    }
+
+    #[test]
+    fn coplanar_holes_and_flat_contours_join_their_plane() {
+        let mut hole = square(1.0, 1.0, 1.0);
+        hole.reverse();
+        let lifted: Vec<_> = square(0.0, 0.0, 1.0)
+            .into_iter()
+            .map(|point| point + Float3::new(0.0, 0.0, 2.0))
+            .collect();
+        let flat = vec![
+            Float3::new(0.0, 0.0, 0.0),
+            Float3::new(1.0, 0.0, 0.0),
+            Float3::new(2.0, 0.0, 0.0),
+        ];
+        let contours = vec![square(0.0, 0.0, 3.0), lifted, hole, flat];
+
+        let groups = group_by_plane(&contours, Some(Float3::Z), PlaneTolerance::default());
+
+        assert_eq!(groups.len(), 2);
+        assert_eq!(groups[0].contours, vec![0, 2, 3]);
+        assert_eq!(groups[1].contours, vec![1]);
+        assert_eq!(groups[1].plane.normal, Float3::Z);
+        assert!((groups[1].plane.offset - 2.0).abs() < 1e-6);
+    }
+
+    #[test]
+    fn a_single_plane_matches_triangulate() {
+        let options = TessellationOptions {
+            winding_rule: WindingRule::NonZero,
+            normal: Some(Float3::Z),
+            constrained_delaunay: true,
+            split_components: true,
+            ..TessellationOptions::default()
+        };
+        let contours = [
+            square(0.0, 0.0, 2.0),
+            square(1.0, 1.0, 2.0),
+            square(5.0, 0.0, 1.0),
+        ];
+
+        let planar = triangulate_planes(&contours, PlaneTolerance::default(), options).unwrap();
+
+        assert_eq!(planar.planes.len(), 1);
+        assert_eq!(
+            planar.tessellation,
+            triangulate(&contours, options).unwrap()
+        );
+    }
+}
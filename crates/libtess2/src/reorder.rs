@@ -0,0 +1,313 @@
+use crate::{Float3, Tessellation};
+
+// simulated post-transform cache; Forsyth's scoring is tuned for 32 entries and
+// degrades gracefully on hardware with smaller caches
+const CACHE_SIZE: usize = 32;
+const CACHE_DECAY_POWER: f32 = 1.5;
+const LAST_TRIANGLE_SCORE: f32 = 0.75;
+const VALENCE_BOOST_SCALE: f32 = 2.0;
+const VALENCE_BOOST_POWER: f32 = 0.5;
+const MORTON_BITS: u32 = 10;
+
+// reorders triangles for vertex-cache reuse (Forsyth's greedy scoring, falling
+// back to the next triangle along a Morton curve whenever the cache runs dry)
+// and renumbers vertices in first-use order, so index and vertex fetches both
+// stream forward; triangle winding and source indices are preserved
+pub(crate) fn reorder_for_locality(tessellation: &mut Tessellation) {
+    if tessellation.triangles.len() < 2 {
+        return;
+    }
+
+    let triangle_order = cache_order(tessellation);
+    let triangles: Vec<_> = triangle_order
+        .iter()
+        .map(|&idx| tessellation.triangles[idx])
+        .collect();
+
+    let vertex_count = tessellation.vertices.len();
+    let mut remap = vec![usize::MAX; vertex_count];
+    let mut order = Vec::with_capacity(vertex_count);
+    for &vertex in triangles.iter().flatten() {
+        if remap[vertex] == usize::MAX {
+            remap[vertex] = order.len();
+            order.push(vertex);
+        }
+    }
+    for vertex in 0..vertex_count {
+        if remap[vertex] == usize::MAX {
+            remap[vertex] = order.len();
+            order.push(vertex);
+        }
+    }
+
+    tessellation.vertices = order
+        .iter()
+        .map(|&vertex| tessellation.vertices[vertex])
+        .collect();
+    tessellation.source_vertex_indices = order
+        .iter()
+        .map(|&vertex| tessellation.source_vertex_indices[vertex])
+        .collect();
+    tessellation.triangles = triangles
+        .into_iter()
+        .map(|face| face.map(|vertex| remap[vertex]))
+        .collect();
+}
+
+fn cache_order(tessellation: &Tessellation) -> Vec<usize> {
+    let triangles = &tessellation.triangles;
+    let vertex_count = tessellation.vertices.len();
+
+    // vertex -> incident triangles, as offsets into one flat list
+    let mut offsets = vec![0usize; vertex_count + 1];
+    for &vertex in triangles.iter().flatten() {
+        offsets[vertex + 1] += 1;
+    }
+    for idx in 0..vertex_count {
+        offsets[idx + 1] += offsets[idx];
+    }
+    let mut fill = offsets.clone();
+    let mut incident = vec![0usize; offsets[vertex_count]];
+    for (triangle, face) in triangles.iter().enumerate() {
+        for &vertex in face {
+            incident[fill[vertex]] = triangle;
+            fill[vertex] += 1;
+        }
+    }
+
+    let mut remaining: Vec<usize> = (0..vertex_count)
+        .map(|vertex| offsets[vertex + 1] - offsets[vertex])
+        .collect();
+    let mut cache_position = vec![None; vertex_count];
+    let mut vertex_score: Vec<f32> = (0..vertex_count)
+        .map(|vertex| score(None, remaining[vertex]))
+        .collect();
+    let mut emitted = vec![false; triangles.len()];
+
+    let spatial = morton_order(tessellation);
+    let mut spatial_cursor = 0;
+    let mut cache: Vec<usize> = Vec::with_capacity(CACHE_SIZE + 3);
+    let mut order = Vec::with_capacity(triangles.len());
+    let mut best = None;
+
+    while order.len() < triangles.len() {
+        let next = match best.take() {
+            Some(triangle) => triangle,
+            None => {
+                while emitted[spatial[spatial_cursor]] {
+                    spatial_cursor += 1;
+                }
+                spatial[spatial_cursor]
+            }
+        };
+        emitted[next] = true;
+        order.push(next);
+
+        for &vertex in &triangles[next] {
+            remaining[vertex] -= 1;
+            if let Some(position) = cache.iter().position(|&cached| cached == vertex) {
+                cache.remove(position);
+            }
+            cache.insert(0, vertex);
+        }
+        let evicted: Vec<_> = cache.drain(CACHE_SIZE.min(cache.len())..).collect();
+        for &vertex in &evicted {
+            cache_position[vertex] = None;
+            vertex_score[vertex] = score(None, remaining[vertex]);
+        }
+        for (position, &vertex) in cache.iter().enumerate() {
+            cache_position[vertex] = Some(position);
+            vertex_score[vertex] = score(Some(position), remaining[vertex]);
+        }
+
+        // only triangles touching the cache can score above zero
+        let mut best_score = 0.0;
+        for &vertex in &cache {
+            for &triangle in &incident[offsets[vertex]..offsets[vertex + 1]] {
+                if emitted[triangle] {
+                    continue;
+                }
+                let triangle_score: f32 = triangles[triangle]
+                    .iter()
+                    .map(|&corner| vertex_score[corner])
+                    .sum();
+                if triangle_score > best_score {
+                    best_score = triangle_score;
+                    best = Some(triangle);
+                }
+            }
+        }
+    }
+    order
+}
+
+fn score(cache_position: Option<usize>, remaining: usize) -> f32 {
+    if remaining == 0 {
+        return -1.0;
+    }
+    let cache_score = match cache_position {
+        None => 0.0,
+        Some(position) if position < 3 => LAST_TRIANGLE_SCORE,
+        Some(position) => {
+            let scale = 1.0 / (CACHE_SIZE - 3) as f32;
+            (1.0 - (position - 3) as f32 * scale).powf(CACHE_DECAY_POWER)
+        }
+    };
+    cache_score + VALENCE_BOOST_SCALE * (remaining as f32).powf(-VALENCE_BOOST_POWER)
+}
+
+// triangles sorted along a Morton curve through their centroids
+fn morton_order(tessellation: &Tessellation) -> Vec<usize> {
+    let centroids: Vec<_> = tessellation
+        .triangles
+        .iter()
+        .map(|face| {
+            face.iter()
+                .map(|&vertex| tessellation.vertices[vertex])
+                .fold(Float3::ZERO, |sum, vertex| sum + vertex)
+                / 3.0
+        })
+        .collect();
+    let mut min = [f32::INFINITY; 3];
+    let mut max = [f32::NEG_INFINITY; 3];
+    for centroid in &centroids {
+        for (axis, value) in centroid.to_array().into_iter().enumerate() {
+            min[axis] = min[axis].min(value);
+            max[axis] = max[axis].max(value);
+        }
+    }
+    let cells = ((1u32 << MORTON_BITS) - 1) as f32;
+
+    let mut keyed: Vec<_> = centroids
+        .iter()
+        .enumerate()
+        .map(|(triangle, centroid)| {
+            let centroid = centroid.to_array();
+            let mut key = 0u32;
+            for axis in 0..3 {
+                let extent = max[axis] - min[axis];
+                let t = if extent > 0.0 {
+                    (centroid[axis] - min[axis]) / extent
+                } else {
+                    0.0
+                };
+                key |= spread_bits((t.clamp(0.0, 1.0) * cells) as u32) << axis;
+            }
+            (key, triangle)
+        })
+        .collect();
+    keyed.sort_unstable();
+    keyed.into_iter().map(|(_, triangle)| triangle).collect()
+}
+
+// inserts two zero bits between each of the low 10 bits
+fn spread_bits(value: u32) -> u32 {
+    let mut value = value & 0x3ff;
+    value = (value | (value << 16)) & 0x030000ff;
+    value = (value | (value << 8)) & 0x0300f00f;
+    value = (value | (value << 4)) & 0x030c30c3;
+    (value | (value << 2)) & 0x09249249
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::test_support::star_polygon;
+    use crate::{TessellationOptions, WindingRule, triangulate};
+
+    // misses of a FIFO cache of `size` entries, per triangle
+    fn average_cache_miss_ratio(tessellation: &Tessellation, size: usize) -> f32 {
+        let mut cache = std::collections::VecDeque::new();
+        let mut misses = 0;
+        for &vertex in tessellation.triangles.iter().flatten() {
+            if !cache.contains(&vertex) {
+                misses += 1;
+                cache.push_back(vertex);
+                if cache.len() > size {
+                    cache.pop_front();
+                }
+            }
+        }
+        misses as f32 / tessellation.triangles.len() as f32
+    }
+
+    #[test]
+    fn reordering_preserves_the_triangulation() {
+        let options = TessellationOptions {
+            winding_rule: WindingRule::NonZero,
+            normal: Some(Float3::Z),
+            constrained_delaunay: true,
+            ..TessellationOptions::default()
+        };
+        let plain = triangulate([star_polygon(151, 1.0)], options).unwrap();
+        let reordered = triangulate(
+            [star_polygon(151, 1.0)],
+            TessellationOptions {
+                reorder_output: true,
+                ..options
+            },
+        )
+        .unwrap();
+
+        let canonical = |tessellation: &Tessellation| {
+            let mut faces: Vec<_> = tessellation
+                .triangles
+                .iter()
+                .map(|face| {
+                    let keyed = face.map(|vertex| {
+                        let point = tessellation.vertices[vertex];
+                        (
+                            point.to_array().map(f32::to_bits),
+                            tessellation.source_vertex_indices[vertex],
+                        )
+                    });
+                    // rotate so the smallest corner leads, keeping the winding
+                    let lead = (0..3).min_by_key(|&idx| keyed[idx]).unwrap();
+                    [keyed[lead], keyed[(lead + 1) % 3], keyed[(lead + 2) % 3]]
+                })
+                .collect();
+            faces.sort_unstable();
+            faces
+        };
+        assert_eq!(canonical(&plain), canonical(&reordered));
+        assert_eq!(plain.vertices.len(), reordered.vertices.len());
+    }
+
+    #[test]
+    fn reordering_improves_cache_reuse_and_numbers_vertices_by_first_use() {
+        let mut tessellation = triangulate(
+            [star_polygon(151, 1.0)],
+            TessellationOptions {
+                winding_rule: WindingRule::NonZero,
+                normal: Some(Float3::Z),
+                constrained_delaunay: true,
+                ..TessellationOptions::default()
+            },
+        )
+        .unwrap();
+        // scatter the triangles so the test does not depend on how coherent
+        // libtess2's own face order happens to be
+        let count = tessellation.triangles.len();
+        let stride = (count / 2..)
+            .find(|stride| gcd(*stride, count) == 1)
+            .unwrap();
+        tessellation.triangles = (0..count)
+            .map(|idx| tessellation.triangles[idx * stride % count])
+            .collect();
+        let before = average_cache_miss_ratio(&tessellation, 16);
+
+        reorder_for_locality(&mut tessellation);
+
+        let after = average_cache_miss_ratio(&tessellation, 16);
+        assert!(after < before * 0.75, "{after} vs {before}");
+        let mut next = 0;
+        for &vertex in tessellation.triangles.iter().flatten() {
+            assert!(vertex <= next);
+            next = next.max(vertex + 1);
+        }
+    }
+
+    fn gcd(a: usize, b: usize) -> usize {
+        if b == 0 { a } else { gcd(b, a % b) }
+    }
+}
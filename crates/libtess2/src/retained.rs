@@ -0,0 +1,333 @@
+use std::collections::{BTreeMap, HashMap};
+
+use crate::{
+    Float3, TessError, Tessellation, TessellationOptions,
+    components::{self, Bounds2},
+    contour_area_normal, polygon_basis, reorder, triangulate_batch,
+};
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord, Hash)]
+pub struct ContourId(u64);
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub struct RetainedUpdate {
+    pub swept_components: usize,
+    pub reused_components: usize,
+}
+
+struct RetainedContour {
+    points: Vec<Float3>,
+    // projected with the retained normal; None until that normal is known
+    bounds: Option<Bounds2>,
+}
+
+// keeps the contour set and the tessellation of every bounding-box component
+// between runs, so an edit only re-sweeps the components it touches; the
+// output matches triangulate() over the live contours in insertion order.
+// without split_components every edit re-sweeps everything
+pub struct RetainedTessellator {
+    options: TessellationOptions,
+    // fixed by options.normal, or else by the first contour with area, so the
+    // projection stays stable across edits
+    normal: Option<Float3>,
+    next_id: u64,
+    contours: BTreeMap<ContourId, RetainedContour>,
+    // component (as its contour ids) -> tessellation with sources numbered
+    // over that component's contours only
+    swept: HashMap<Vec<ContourId>, Tessellation>,
+    component_of: HashMap<ContourId, Vec<ContourId>>,
+    last_update: RetainedUpdate,
+}
+
+impl RetainedTessellator {
+    pub fn new(options: TessellationOptions) -> Self {
+        Self {
+            options,
+            normal: options
+                .normal
+                .filter(|normal| normal.len_sq() > 0.0)
+                .map(Float3::normalize),
+            next_id: 0,
+            contours: BTreeMap::new(),
+            swept: HashMap::new(),
+            component_of: HashMap::new(),
+            last_update: RetainedUpdate::default(),
+        }
+    }
+
+    pub fn add_contour(&mut self, contour: &[Float3]) -> Result<ContourId, TessError> {
+        if contour.len() < 3 {
+            return Err(TessError::ContourTooShort);
+        }
+        let id = ContourId(self.next_id);
+        self.next_id += 1;
+        self.contours.insert(
+            id,
+            RetainedContour {
+                points: contour.to_vec(),
+                bounds: None,
+            },
+        );
+        Ok(id)
+    }
+
+    pub fn replace_contour(
+        &mut self,
+        id: ContourId,
+        contour: &[Float3],
+    ) -> Result<bool, TessError> {
+        if contour.len() < 3 {
+            return Err(TessError::ContourTooShort);
+        }
+        let Some(retained) = self.contours.get_mut(&id) else {
+            return Ok(false);
+        };
+        retained.points = contour.to_vec();
+        retained.bounds = None;
+        self.invalidate(id);
+        Ok(true)
+    }
+
+    pub fn remove_contour(&mut self, id: ContourId) -> bool {
+        self.invalidate(id);
+        self.contours.remove(&id).is_some()
+    }
+
+    pub fn contour_count(&self) -> usize {
+        self.contours.len()
+    }
+
+    pub fn last_update(&self) -> RetainedUpdate {
+        self.last_update
+    }
+
+    pub fn tessellate(&mut self) -> Result<Tessellation, TessError> {
+        self.resolve_bounds();
+        let ids: Vec<_> = self.contours.keys().copied().collect();
+        let partitions = if self.options.split_components && ids.len() > 1 {
+            let bounds: Vec<_> = self
+                .contours
+                .values()
+                .map(|contour| contour.bounds.expect("bounds resolved above"))
+                .collect();
+            components::overlapping_bounds_components(&bounds)
+        } else {
+            vec![(0..ids.len()).collect()]
+        };
+        let global_offsets: Vec<_> = self
+            .contours
+            .values()
+            .scan(0usize, |offset, contour| {
+                let current = *offset;
+                *offset += contour.points.len();
+                Some(current)
+            })
+            .collect();
+
+        let options = TessellationOptions {
+            normal: self.normal,
+            reorder_output: false,
+            ..self.options
+        };
+        let mut update = RetainedUpdate::default();
+        let mut merged = Tessellation::default();
+        let mut live = HashMap::with_capacity(partitions.len());
+        for partition in partitions {
+            let key: Vec<_> = partition.iter().map(|&idx| ids[idx]).collect();
+            let part = match self.swept.remove(&key) {
+                Some(part) => {
+                    update.reused_components += 1;
+                    part
+                }
+                None => {
+                    update.swept_components += 1;
+                    self.sweep(&key, options)?
+                }
+            };
+
+            let local_to_global: Vec<_> = partition
+                .iter()
+                .flat_map(|&idx| {
+                    let offset = global_offsets[idx];
+                    (0..self.contours[&ids[idx]].points.len()).map(move |vertex| offset + vertex)
+                })
+                .collect();
+            let mut global = part.clone();
+            for source in &mut global.source_vertex_indices {
+                *source = source.map(|local| local_to_global[local]);
+            }
+            components::append_tessellation(&mut merged, global);
+            live.insert(key, part);
+        }
+
+        self.component_of = live
+            .keys()
+            .flat_map(|key| key.iter().map(|&id| (id, key.clone())))
+            .collect();
+        self.swept = live;
+        self.last_update = update;
+        if self.options.reorder_output {
+            reorder::reorder_for_locality(&mut merged);
+        }
+        Ok(merged)
+    }
+
+    fn sweep(
+        &self,
+        key: &[ContourId],
+        options: TessellationOptions,
+    ) -> Result<Tessellation, TessError> {
+        let contours: Vec<_> = key
+            .iter()
+            .enumerate()
+            .map(|(local, id)| (local, self.contours[id].points.clone()))
+            .collect();
+        let local_offsets: Vec<_> = contours
+            .iter()
+            .scan(0usize, |offset, (_, contour)| {
+                let current = *offset;
+                *offset += contour.len();
+                Some(current)
+            })
+            .collect();
+        triangulate_batch(&contours, &local_offsets, options)
+    }
+
+    fn invalidate(&mut self, id: ContourId) {
+        if let Some(key) = self.component_of.remove(&id) {
+            for other in &key {
+                self.component_of.remove(other);
+            }
+            self.swept.remove(&key);
+        }
+    }
+
+    fn resolve_bounds(&mut self) {
+        let normal = self.resolve_normal();
+        let (basis_x, basis_y, _) = polygon_basis(normal);
+        for contour in self.contours.values_mut() {
+            if contour.bounds.is_none() {
+                contour.bounds = Some(components::projected_bounds(
+                    &contour.points,
+                    basis_x,
+                    basis_y,
+                ));
+            }
+        }
+    }
+
+    // mirrors inferred_batch_normal, but latches the first normal found
+    fn resolve_normal(&mut self) -> Float3 {
+        if let Some(normal) = self.normal {
+            return normal;
+        }
+        let Some(normal) = self
+            .contours
+            .values()
+            .find_map(|contour| contour_area_normal(&contour.points))
+        else {
+            return Float3::Z;
+        };
+
+        // anything bounded or swept under the +Z fallback is stale
+        self.normal = Some(normal);
+        for contour in self.contours.values_mut() {
+            contour.bounds = None;
+        }
+        self.swept.clear();
+        self.component_of.clear();
+        normal
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::test_support::square;
+    use crate::{WindingRule, triangulate};
+
+    fn full_run(
+        contours: &BTreeMap<ContourId, Vec<Float3>>,
+        options: TessellationOptions,
+    ) -> Tessellation {
+        triangulate(contours.values(), options).unwrap()
+    }
+
+    #[test]
+    fn edits_only_resweep_touched_components() {
+        let options = TessellationOptions {
+            winding_rule: WindingRule::NonZero,
+            constrained_delaunay: true,
+            split_components: true,
+            ..TessellationOptions::default()
+        };
+        let mut retained = RetainedTessellator::new(options);
+        let mut live = BTreeMap::new();
+        for idx in 0..12 {
+            let x = idx as f32 * 3.0;
+            for contour in [square(x, 0.0, 1.0), square(x + 0.5, 0.5, 1.0)] {
+                live.insert(retained.add_contour(&contour).unwrap(), contour);
+            }
+        }
+        assert_eq!(retained.tessellate().unwrap(), full_run(&live, options));
+        assert_eq!(retained.last_update().swept_components, 12);
+
+        let ids: Vec<_> = live.keys().copied().collect();
+        let moved = square(6.25, 0.25, 1.0);
+        assert!(retained.replace_contour(ids[4], &moved).unwrap());
+        live.insert(ids[4], moved);
+        assert_eq!(retained.tessellate().unwrap(), full_run(&live, options));
+        assert_eq!(
+            retained.last_update(),
+            RetainedUpdate {
+                swept_components: 1,
+                reused_components: 11,
+            }
+        );
+
+        assert!(retained.remove_contour(ids[7]));
+        live.remove(&ids[7]);
+        let bridge = square(10.0, 0.0, 3.0);
+        live.insert(retained.add_contour(&bridge).unwrap(), bridge);
+        assert_eq!(retained.tessellate().unwrap(), full_run(&live, options));
+        // the bridge merges the components at x = 9 and x = 12
+        assert_eq!(
+            retained.last_update(),
+            RetainedUpdate {
+                swept_components: 1,
+                reused_components: 10,
+            }
+        );
+
+        assert_eq!(retained.tessellate().unwrap(), full_run(&live, options));
+        assert_eq!(retained.last_update().swept_components, 0);
+    }
+
+    #[test]
+    fn without_split_components_every_edit_resweeps() {
+        let options = TessellationOptions {
+            normal: Some(Float3::Z),
+            ..TessellationOptions::default()
+        };
+        let mut retained = RetainedTessellator::new(options);
+        let first = retained.add_contour(&square(0.0, 0.0, 1.0)).unwrap();
+        retained.add_contour(&square(5.0, 0.0, 1.0)).unwrap();
+        retained.tessellate().unwrap();
+        retained.tessellate().unwrap();
+        assert_eq!(retained.last_update().reused_components, 1);
+
+        retained
+            .replace_contour(first, &square(0.0, 0.0, 2.0))
+            .unwrap();
+        let tessellation = retained.tessellate().unwrap();
+
+        assert_eq!(
+            retained.last_update(),
+            RetainedUpdate {
+                swept_components: 1,
+                reused_components: 0,
+            }
+        );
+        assert_eq!(tessellation.triangles.len(), 4);
+    }
+}
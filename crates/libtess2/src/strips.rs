@@ -0,0 +1,619 @@
+use std::{
+    collections::{HashMap, HashSet},
+    num::NonZeroUsize,
+    thread,
+};
+
+use crate::{
+    Float3, TessError, Tessellation, TessellationOptions, float3_key, inferred_batch_normal,
+    reorder, separate_contours_with_sources, triangulate,
+};
+
+// below this many input vertices the per-strip threads cost more than they save
+pub const STRIP_MIN_VERTICES: usize = 1 << 14;
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct StripOptions {
+    pub strip_count: usize,
+    pub reflip_seams: bool,
+}
+
+impl Default for StripOptions {
+    fn default() -> Self {
+        Self {
+            strip_count: thread::available_parallelism().map_or(1, NonZeroUsize::get),
+            reflip_seams: true,
+        }
+    }
+}
+
+#[derive(Debug, Clone, Copy)]
+struct ClipPoint {
+    pos: Float3,
+    source: Option<usize>,
+}
+
+#[derive(Debug, Clone, Copy)]
+struct Slab {
+    lo: Option<f32>,
+    hi: Option<f32>,
+}
+
+impl Slab {
+    fn contains(self, s: f32) -> bool {
+        self.lo.is_none_or(|lo| s >= lo) && self.hi.is_none_or(|hi| s <= hi)
+    }
+}
+
+// splits the projected bounds into vertical strips along libtess2's own sweep
+// axis, sweeps each strip on its own thread and welds the strips back together
+// along the shared cut lines
+pub fn triangulate_in_strips<I, C>(
+    contours: I,
+    options: TessellationOptions,
+    strips: StripOptions,
+) -> Result<Tessellation, TessError>
+where
+    I: IntoIterator<Item = C>,
+    C: AsRef<[Float3]>,
+{
+    let contours: Vec<_> = contours
+        .into_iter()
+        .map(|contour| contour.as_ref().to_vec())
+        .collect();
+    if contours.iter().any(|contour| contour.len() < 3) {
+        return Err(TessError::ContourTooShort);
+    }
+    if strips.strip_count <= 1 || contours.is_empty() {
+        return triangulate(contours, options);
+    }
+
+    let normal = inferred_batch_normal(&contours, options.normal);
+    let (s_axis, t_axis) = sweep_axes(normal);
+    let original_vertices: Vec<_> = contours.iter().flatten().copied().collect();
+
+    let indexed_contours: Vec<_> = contours.into_iter().enumerate().collect();
+    let swept_contours = if options.normalize_input {
+        separate_contours_with_sources(&indexed_contours, Some(normal))
+    } else {
+        indexed_contours
+    };
+
+    let mut next_source = 0usize;
+    let sourced: Vec<Vec<ClipPoint>> = swept_contours
+        .iter()
+        .map(|(_, contour)| {
+            contour
+                .iter()
+                .map(|&pos| {
+                    next_source += 1;
+                    ClipPoint {
+                        pos,
+                        source: Some(next_source - 1),
+                    }
+                })
+                .collect()
+        })
+        .collect();
+
+    let (s_min, s_max) = original_vertices
+        .iter()
+        .map(|point| axis_value(*point, s_axis))
+        .fold((f32::INFINITY, f32::NEG_INFINITY), |(min, max), s| {
+            (min.min(s), max.max(s))
+        });
+    let mut cuts: Vec<f32> = (1..strips.strip_count)
+        .map(|k| s_min + (s_max - s_min) * (k as f32 / strips.strip_count as f32))
+        .filter(|cut| *cut > s_min && *cut < s_max)
+        .collect();
+    cuts.dedup();
+    if cuts.is_empty() {
+        let contours: Vec<_> = swept_contours
+            .into_iter()
+            .map(|(_, contour)| contour)
+            .collect();
+        let mut tessellation = triangulate(
+            &contours,
+            TessellationOptions {
+                normalize_input: false,
+                ..options
+            },
+        )?;
+        restore_source_positions(&mut tessellation, &original_vertices);
+        return Ok(tessellation);
+    }
+
+    let slabs: Vec<_> = (0..=cuts.len())
+        .map(|k| Slab {
+            lo: k.checked_sub(1).map(|prev| cuts[prev]),
+            hi: cuts.get(k).copied(),
+        })
+        .collect();
+    let strip_options = TessellationOptions {
+        normal: Some(normal),
+        normalize_input: false,
+        reorder_output: false,
+        ..options
+    };
+
+    let results: Vec<_> = thread::scope(|scope| {
+        let handles: Vec<_> = slabs
+            .iter()
+            .map(|&slab| {
+                let sourced = &sourced;
+                scope.spawn(move || {
+                    let clipped: Vec<_> = sourced
+                        .iter()
+                        .map(|contour| clip_contour(contour, slab, s_axis))
+                        .filter(|contour| contour.len() >= 3)
+                        .collect();
+                    tessellate_strip(&clipped, strip_options)
+                })
+            })
+            .collect();
+        handles
+            .into_iter()
+            .map(|handle| handle.join().expect("tessellation strip panicked"))
+            .collect()
+    });
+
+    let cut_keys: HashSet<u32> = cuts.iter().map(|cut| cut.to_bits()).collect();
+    let mut tessellation = Tessellation::default();
+    let mut seam_vertices = HashMap::<[u32; 3], usize>::new();
+    for result in results {
+        let strip = result?;
+        tessellation.stats = tessellation.stats.merge(strip.stats);
+        let mut remap = Vec::with_capacity(strip.vertices.len());
+        for (vertex, source) in strip.vertices.into_iter().zip(strip.source_vertex_indices) {
+            if cut_keys.contains(&axis_value(vertex, s_axis).to_bits()) {
+                let key = float3_key(vertex);
+                if let Some(&welded) = seam_vertices.get(&key) {
+                    let existing = &mut tessellation.source_vertex_indices[welded];
+                    *existing = existing.or(source);
+                    remap.push(welded);
+                    continue;
+                }
+                seam_vertices.insert(key, tessellation.vertices.len());
+            }
+            remap.push(tessellation.vertices.len());
+            tessellation.vertices.push(vertex);
+            tessellation.source_vertex_indices.push(source);
+        }
+        tessellation.triangles.extend(
+            strip
+                .triangles
+                .iter()
+                .map(|face| [remap[face[0]], remap[face[1]], remap[face[2]]]),
+        );
+    }
+
+    split_seam_t_junctions(&mut tessellation, &cut_keys, (s_axis, t_axis));
+    if strips.reflip_seams && options.constrained_delaunay {
+        let seam_edges = seam_edges(&tessellation, &cut_keys, s_axis);
+        reflip_edges(
+            &tessellation.vertices,
+            &mut tessellation.triangles,
+            seam_edges,
+            (s_axis, t_axis),
+        );
+    }
+
+    restore_source_positions(&mut tessellation, &original_vertices);
+    if options.reorder_output {
+        reorder::reorder_for_locality(&mut tessellation);
+    }
+    Ok(tessellation)
+}
+
+fn tessellate_strip(
+    contours: &[Vec<ClipPoint>],
+    options: TessellationOptions,
+) -> Result<Tessellation, TessError> {
+    if contours.is_empty() {
+        return Ok(Tessellation::default());
+    }
+
+    let local_sources: Vec<_> = contours
+        .iter()
+        .flat_map(|contour| contour.iter().map(|point| point.source))
+        .collect();
+    let mut tessellation = triangulate(
+        contours
+            .iter()
+            .map(|contour| contour.iter().map(|point| point.pos).collect::<Vec<_>>()),
+        options,
+    )?;
+    for source in &mut tessellation.source_vertex_indices {
+        *source = source.and_then(|local| local_sources.get(local).copied().flatten());
+    }
+    Ok(tessellation)
+}
+
+fn restore_source_positions(tessellation: &mut Tessellation, original_vertices: &[Float3]) {
+    for (vertex, source) in tessellation
+        .vertices
+        .iter_mut()
+        .zip(tessellation.source_vertex_indices.iter().copied())
+    {
+        if let Some(source) = source {
+            *vertex = original_vertices[source];
+        }
+    }
+}
+
+// mirrors LongAxis in tess.c so the cut lines are exactly vertical in the
+// sweep's own (s, t) projection
+fn sweep_axes(normal: Float3) -> (usize, usize) {
+    let normal = normal.to_array();
+    let mut long_axis = 0;
+    if normal[1].abs() > normal[0].abs() {
+        long_axis = 1;
+    }
+    if normal[2].abs() > normal[long_axis].abs() {
+        long_axis = 2;
+    }
+    ((long_axis + 1) % 3, (long_axis + 2) % 3)
+}
+
+fn axis_value(point: Float3, axis: usize) -> f32 {
+    point.to_array()[axis]
+}
+
+fn clip_contour(contour: &[ClipPoint], slab: Slab, axis: usize) -> Vec<ClipPoint> {
+    let mut out: Vec<ClipPoint> = Vec::with_capacity(contour.len());
+    let mut push = |point: ClipPoint| {
+        if out.last().is_none_or(|last| last.pos != point.pos) {
+            out.push(point);
+        }
+    };
+
+    for (idx, &a) in contour.iter().enumerate() {
+        let b = contour[(idx + 1) % contour.len()];
+        let sa = axis_value(a.pos, axis);
+        let sb = axis_value(b.pos, axis);
+        if slab.contains(sa) {
+            push(a);
+        }
+
+        let mut crossings = [slab.lo, slab.hi]
+            .into_iter()
+            .flatten()
+            .filter(|&cut| (sa < cut && cut < sb) || (sb < cut && cut < sa))
+            .map(|cut| ((cut - sa) / (sb - sa), cut))
+            .collect::<Vec<_>>();
+        crossings.sort_by(|lhs, rhs| lhs.0.total_cmp(&rhs.0));
+        for (_, cut) in crossings {
+            push(cut_point(a, b, cut, axis));
+        }
+    }
+
+    while out.len() >= 2 && out.first().map(|point| point.pos) == out.last().map(|point| point.pos)
+    {
+        out.pop();
+    }
+    out
+}
+
+// both strips sharing a cut must produce bit-identical seam points, so the
+// interpolation always runs from the lexicographically smaller endpoint
+fn cut_point(a: ClipPoint, b: ClipPoint, cut: f32, axis: usize) -> ClipPoint {
+    let key = |point: ClipPoint| (axis_value(point.pos, axis).to_bits(), float3_key(point.pos));
+    let (from, to) = if axis_value(a.pos, axis) < axis_value(b.pos, axis)
+        || (axis_value(a.pos, axis) == axis_value(b.pos, axis) && key(a) <= key(b))
+    {
+        (a, b)
+    } else {
+        (b, a)
+    };
+
+    let s_from = axis_value(from.pos, axis);
+    let s_to = axis_value(to.pos, axis);
+    let t = (cut - s_from) / (s_to - s_from);
+    let mut pos = (from.pos + (to.pos - from.pos) * t).to_array();
+    pos[axis] = cut;
+    ClipPoint {
+        pos: Float3::from_array(pos),
+        source: None,
+    }
+}
+
+// a contour that only touches a cut (or gets clipped away on one side) leaves
+// a seam vertex in one strip but not its neighbour; fan the neighbour's seam
+// edge through those vertices so the result has no t-junctions
+fn split_seam_t_junctions(
+    tessellation: &mut Tessellation,
+    cut_keys: &HashSet<u32>,
+    (s_axis, t_axis): (usize, usize),
+) {
+    let mut seam_vertices = HashMap::<u32, Vec<(f32, usize)>>::new();
+    for (idx, vertex) in tessellation.vertices.iter().enumerate() {
+        let cut = axis_value(*vertex, s_axis).to_bits();
+        if cut_keys.contains(&cut) {
+            seam_vertices
+                .entry(cut)
+                .or_default()
+                .push((axis_value(*vertex, t_axis), idx));
+        }
+    }
+    for line in seam_vertices.values_mut() {
+        line.sort_by(|lhs, rhs| lhs.0.total_cmp(&rhs.0));
+    }
+
+    let vertices = &tessellation.vertices;
+    let mut split = Vec::with_capacity(tessellation.triangles.len());
+    for &face in &tessellation.triangles {
+        let seam_edge = (0..3).find_map(|edge| {
+            let (a, b) = (face[edge], face[(edge + 1) % 3]);
+            let cut = axis_value(vertices[a], s_axis).to_bits();
+            (cut == axis_value(vertices[b], s_axis).to_bits())
+                .then(|| seam_vertices.get(&cut))
+                .flatten()
+                .map(|line| (edge, line))
+        });
+        let Some((edge, line)) = seam_edge else {
+            split.push(face);
+            continue;
+        };
+
+        let (a, b, c) = (face[edge], face[(edge + 1) % 3], face[(edge + 2) % 3]);
+        let (ta, tb) = (
+            axis_value(vertices[a], t_axis),
+            axis_value(vertices[b], t_axis),
+        );
+        let (lo, hi) = (ta.min(tb), ta.max(tb));
+        let start = line.partition_point(|(t, _)| *t <= lo);
+        let end = line.partition_point(|(t, _)| *t < hi);
+        let mut between: Vec<_> = line[start..end.max(start)]
+            .iter()
+            .map(|&(_, idx)| idx)
+            .collect();
+        if between.is_empty() {
+            split.push(face);
+            continue;
+        }
+        if ta > tb {
+            between.reverse();
+        }
+
+        let mut prev = a;
+        for vertex in between.into_iter().chain([b]) {
+            split.push([prev, vertex, c]);
+            prev = vertex;
+        }
+    }
+    tessellation.triangles = split;
+}
+
+fn seam_edges(
+    tessellation: &Tessellation,
+    cut_keys: &HashSet<u32>,
+    s_axis: usize,
+) -> Vec<(usize, usize)> {
+    let on_cut = |idx: usize| axis_value(tessellation.vertices[idx], s_axis).to_bits();
+    let mut edges = Vec::new();
+    for face in &tessellation.triangles {
+        for (a, b) in [(face[0], face[1]), (face[1], face[2]), (face[2], face[0])] {
+            if a < b && on_cut(a) == on_cut(b) && cut_keys.contains(&on_cut(a)) {
+                edges.push((a, b));
+            }
+        }
+    }
+    edges
+}
+
+fn orient_2d(a: [f64; 2], b: [f64; 2], c: [f64; 2]) -> f64 {
+    (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0])
+}
+
+fn in_circle_2d(a: [f64; 2], b: [f64; 2], c: [f64; 2], d: [f64; 2]) -> f64 {
+    let (adx, ady) = (a[0] - d[0], a[1] - d[1]);
+    let (bdx, bdy) = (b[0] - d[0], b[1] - d[1]);
+    let (cdx, cdy) = (c[0] - d[0], c[1] - d[1]);
+    (adx * adx + ady * ady) * (bdx * cdy - cdx * bdy)
+        - (bdx * bdx + bdy * bdy) * (adx * cdy - cdx * ady)
+        + (cdx * cdx + cdy * cdy) * (adx * bdy - bdx * ady)
+}
+
+// lawson flips seeded from the seam edges; the strips were already delaunay
+// internally, so only the neighbourhood of the cut lines needs repair
+fn reflip_edges(
+    vertices: &[Float3],
+    triangles: &mut [[usize; 3]],
+    seeds: Vec<(usize, usize)>,
+    (s_axis, t_axis): (usize, usize),
+) {
+    let point = |idx: usize| {
+        let coords = vertices[idx].to_array();
+        [coords[s_axis] as f64, coords[t_axis] as f64]
+    };
+
+    let mut directed = HashMap::<(usize, usize), usize>::with_capacity(triangles.len() * 3);
+    for (tri_idx, face) in triangles.iter().enumerate() {
+        for (a, b) in [(face[0], face[1]), (face[1], face[2]), (face[2], face[0])] {
+            directed.insert((a, b), tri_idx);
+        }
+    }
+
+    let mut queue = seeds;
+    let max_flips = triangles.len() * 4 + queue.len();
+    let mut flips = 0usize;
+    while let Some((a, b)) = queue.pop() {
+        if flips >= max_flips {
+            break;
+        }
+        let (Some(&lhs), Some(&rhs)) = (directed.get(&(a, b)), directed.get(&(b, a))) else {
+            continue;
+        };
+        let c = opposite_vertex(triangles[lhs], a, b);
+        let d = opposite_vertex(triangles[rhs], b, a);
+        let (pa, pb, pc, pd) = (point(a), point(b), point(c), point(d));
+
+        let orientation = orient_2d(pa, pb, pc).signum();
+        if orientation == 0.0 || in_circle_2d(pa, pb, pc, pd) * orientation <= 0.0 {
+            continue;
+        }
+        if orient_2d(pa, pd, pc) * orientation <= 0.0 || orient_2d(pd, pb, pc) * orientation <= 0.0
+        {
+            continue;
+        }
+
+        for face in [triangles[lhs], triangles[rhs]] {
+            for (u, v) in [(face[0], face[1]), (face[1], face[2]), (face[2], face[0])] {
+                directed.remove(&(u, v));
+            }
+        }
+        triangles[lhs] = [a, d, c];
+        triangles[rhs] = [d, b, c];
+        for (tri_idx, face) in [(lhs, triangles[lhs]), (rhs, triangles[rhs])] {
+            for (u, v) in [(face[0], face[1]), (face[1], face[2]), (face[2], face[0])] {
+                directed.insert((u, v), tri_idx);
+            }
+        }
+        flips += 1;
+        queue.extend([(a, d), (d, b), (b, c), (c, a)]);
+    }
+}
+
+fn opposite_vertex(face: [usize; 3], a: usize, b: usize) -> usize {
+    face.into_iter()
+        .find(|&vertex| vertex != a && vertex != b)
+        .unwrap_or(face[0])
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::WindingRule;
+    use crate::test_support::{circle, reversed};
+
+    fn triangle_area(tessellation: &Tessellation) -> f32 {
+        tessellation
+            .triangles
+            .iter()
+            .map(|face| {
+                let a = tessellation.vertices[face[0]];
+                let b = tessellation.vertices[face[1]];
+                let c = tessellation.vertices[face[2]];
+                ((b - a).cross(c - a)).len() * 0.5
+            })
+            .sum()
+    }
+
+    fn boundary_edges(tessellation: &Tessellation) -> Vec<(usize, usize)> {
+        let mut edges = HashMap::<(usize, usize), i32>::new();
+        for face in &tessellation.triangles {
+            for (a, b) in [(face[0], face[1]), (face[1], face[2]), (face[2], face[0])] {
+                *edges.entry((a.min(b), a.max(b))).or_default() += 1;
+            }
+        }
+        edges
+            .into_iter()
+            .filter_map(|(edge, count)| (count == 1).then_some(edge))
+            .collect()
+    }
+
+    fn boundary_length(tessellation: &Tessellation) -> f32 {
+        boundary_edges(tessellation)
+            .into_iter()
+            .map(|(a, b)| (tessellation.vertices[a] - tessellation.vertices[b]).len())
+            .sum()
+    }
+
+    fn perimeter(contour: &[Float3]) -> f32 {
+        (0..contour.len())
+            .map(|idx| (contour[(idx + 1) % contour.len()] - contour[idx]).len())
+            .sum()
+    }
+
+    #[test]
+    fn strips_cover_the_same_area_as_a_single_sweep() {
+        let contours = [
+            circle((0.0, 0.0), 2.0, 96),
+            reversed(circle((0.0, 0.0), 1.0, 64)),
+        ];
+        let options = TessellationOptions {
+            winding_rule: WindingRule::NonZero,
+            constrained_delaunay: true,
+            ..TessellationOptions::default()
+        };
+
+        let single = triangulate(&contours, options).unwrap();
+        let striped = triangulate_in_strips(
+            &contours,
+            options,
+            StripOptions {
+                strip_count: 4,
+                reflip_seams: true,
+            },
+        )
+        .unwrap();
+
+        assert!((triangle_area(&single) - triangle_area(&striped)).abs() < 1e-3);
+        // any crack along a cut line would show up as extra boundary length
+        let expected = perimeter(&contours[0]) + perimeter(&contours[1]);
+        assert!((boundary_length(&striped) - expected).abs() < 1e-3);
+    }
+
+    #[test]
+    fn strips_keep_global_source_indices() {
+        let contours = [
+            circle((0.0, 0.0), 2.0, 32),
+            reversed(circle((0.0, 0.0), 1.0, 16)),
+        ];
+        let striped = triangulate_in_strips(
+            &contours,
+            TessellationOptions {
+                winding_rule: WindingRule::NonZero,
+                ..TessellationOptions::default()
+            },
+            StripOptions {
+                strip_count: 3,
+                reflip_seams: false,
+            },
+        )
+        .unwrap();
+
+        let mut sources: Vec<_> = striped
+            .source_vertex_indices
+            .iter()
+            .copied()
+            .flatten()
+            .collect();
+        sources.sort_unstable();
+        sources.dedup();
+        assert_eq!(sources, (0..48).collect::<Vec<_>>());
+        for (vertex, source) in striped.vertices.iter().zip(&striped.source_vertex_indices) {
+            if let Some(source) = source {
+                let expected = if *source < 32 {
+                    contours[0][*source]
+                } else {
+                    contours[1][*source - 32]
+                };
+                assert_eq!(*vertex, expected);
+            }
+        }
+    }
+
+    #[test]
+    fn seam_vertices_are_welded_across_strips() {
+        let square = [
+            Float3::new(0.0, 0.0, 0.0),
+            Float3::new(4.0, 0.0, 0.0),
+            Float3::new(4.0, 1.0, 0.0),
+            Float3::new(0.0, 1.0, 0.0),
+        ];
+        let striped = triangulate_in_strips(
+            [square.as_slice()],
+            TessellationOptions::default(),
+            StripOptions {
+                strip_count: 4,
+                reflip_seams: false,
+            },
+        )
+        .unwrap();
+
+        assert_eq!(striped.vertices.len(), 10);
+        assert_eq!(boundary_edges(&striped).len(), 10);
+        assert!((triangle_area(&striped) - 4.0).abs() < 1e-5);
+    }
+}
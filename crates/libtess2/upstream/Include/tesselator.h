@@ -122,14 +122,52 @@ enum TessElementType
 // TESS_REVERSE_CONTOURS
 //   If enabled, tessAddContour() will treat CW contours as CCW and vice versa
 //   Disabled by default.
+//
+// TESS_GRID_RESOLUTION
+//   Only used when the library is compiled with TESS_INTEGER_GRID. The
+//   projected vertices are snapped to a grid with this many cells across the
+//   larger side of their bounds, and the sweep predicates are evaluated exactly
+//   in integer arithmetic. Clamped to [1, TESS_MAX_GRID_RESOLUTION].
+//   Defaults to TESS_DEFAULT_GRID_RESOLUTION.
+//
+// TESS_BOOLEAN_OPERATION
+//   One of TessBooleanOperation. When not TESS_BOOLEAN_NONE, the winding rule
+//   is applied to each operand separately and a region is inside when the
+//   operation holds for the two results, so a boolean of two shapes takes a
+//   single sweep. Defaults to TESS_BOOLEAN_NONE.
+//
+// TESS_CONTOUR_OPERAND
+//   The operand (0 or 1) that contours passed to later tessAddContour() calls
+//   belong to. Defaults to 0.
 
 enum TessOption
 {
 	TESS_CONSTRAINED_DELAUNAY_TRIANGULATION,
-	TESS_REVERSE_CONTOURS
+	TESS_REVERSE_CONTOURS,
+	TESS_GRID_RESOLUTION,
+	TESS_BOOLEAN_OPERATION,
+	TESS_CONTOUR_OPERAND
 };
 
-typedef float TESSreal;
+enum TessBooleanOperation
+{
+	TESS_BOOLEAN_NONE,
+	TESS_BOOLEAN_UNION,
+	TESS_BOOLEAN_INTERSECTION,
+	TESS_BOOLEAN_DIFFERENCE,
+	TESS_BOOLEAN_XOR
+};
+
+#define TESS_DEFAULT_GRID_RESOLUTION 4096
+// Keeps every product formed by the integer predicates within 64 bits.
+#define TESS_MAX_GRID_RESOLUTION (1<<15)
+
+// Coordinate type. Define TESS_REAL when compiling to build a float or double
+// kernel; the default is float.
+#ifndef TESS_REAL
+#define TESS_REAL float
+#endif
+typedef TESS_REAL TESSreal;
 typedef int TESSindex;
 typedef struct TESStesselator TESStesselator;
 typedef struct TESSalloc TESSalloc;
@@ -244,6 +282,11 @@ int tessGetElementCount( TESStesselator *tess );
 // tessGetElements() - Returns pointer to the first element.
 const TESSindex* tessGetElements( TESStesselator *tess );
 
+// tessGetIntersectionCount() - Returns the number of vertices the last
+// tessTesselate() call created where two input edges crossed. Useful for
+// sizing TESSalloc.extraVertices when tesselating similar input again.
+int tessGetIntersectionCount( TESStesselator *tess );
+
 typedef enum TESSstatus {
   TESS_STATUS_OK,
   TESS_STATUS_OUT_OF_MEMORY,
@@ -35,6 +35,24 @@
 #include "geom.h"
 #include <math.h>
 
+#ifdef TESS_INTEGER_GRID
+/* s and t hold whole grid coordinates, see SnapToGrid() in tess.c.  With at
+* most TESS_MAX_GRID_RESOLUTION cells plus the sentinel margin every product
+* below fits comfortably in 64 bits.
+*/
+typedef long long TESSgrid;
+#define GridCoord(x)	((TESSgrid)(x))
+#define GridMin(a,b)	((a) < (b) ? (a) : (b))
+#define GridMax(a,b)	((a) > (b) ? (a) : (b))
+
+/* The in-circle determinant needs about 70 bits. */
+#if defined(__SIZEOF_INT128__)
+typedef __int128 TESSgridwide;
+#else
+typedef double TESSgridwide;	/* not exact, but it only steers the CDT flips */
+#endif
+#endif
+
 int tesvertLeq( TESSvertex *u, TESSvertex *v )
 {
 	/* Returns TRUE if u is lexicographically <= v. */
@@ -82,6 +100,20 @@ TESSreal tesedgeSign( TESSvertex *u, TESSvertex *v, TESSvertex *w )
 
 	assert( VertLeq( u, v ) && VertLeq( v, w ));
 
+#ifdef TESS_INTEGER_GRID
+	{
+		TESSgrid igapL = GridCoord(v->s) - GridCoord(u->s);
+		TESSgrid igapR = GridCoord(w->s) - GridCoord(v->s);
+
+		if( igapL + igapR > 0 ) {
+			return (TESSreal)((GridCoord(v->t) - GridCoord(w->t)) * igapL
+							  + (GridCoord(v->t) - GridCoord(u->t)) * igapR);
+		}
+		/* vertical line */
+		return 0;
+	}
+#endif
+
 	gapL = v->s - u->s;
 	gapR = w->s - v->s;
 
@@ -157,7 +189,49 @@ int tesvertCCW( TESSvertex *u, TESSvertex *v, TESSvertex *w )
 	* on some degenerate inputs, so the client must have some way to
 	* handle this situation.
 	*/
+#ifdef TESS_INTEGER_GRID
+	return (GridCoord(u->s)*(GridCoord(v->t) - GridCoord(w->t))
+			+ GridCoord(v->s)*(GridCoord(w->t) - GridCoord(u->t))
+			+ GridCoord(w->s)*(GridCoord(u->t) - GridCoord(v->t))) >= 0;
+#else
 	return (u->s*(v->t - w->t) + v->s*(w->t - u->t) + w->s*(u->t - v->t)) >= 0;
+#endif
+}
+
+#ifdef TESS_INTEGER_GRID
+/* EdgeEval(u,v,w) as the exact fraction num/den with den > 0. */
+static void GridEdgeEval( TESSvertex *u, TESSvertex *v, TESSvertex *w,
+						 TESSgrid *num, TESSgrid *den )
+{
+	TESSgrid gapL = GridCoord(v->s) - GridCoord(u->s);
+	TESSgrid gapR = GridCoord(w->s) - GridCoord(v->s);
+
+	if( gapL + gapR > 0 ) {
+		*num = (GridCoord(v->t) - GridCoord(w->t)) * gapL
+			+ (GridCoord(v->t) - GridCoord(u->t)) * gapR;
+		*den = gapL + gapR;
+	} else {
+		/* vertical line */
+		*num = 0;
+		*den = 1;
+	}
+}
+#endif
+
+int tesedgeEvalGeq( TESSvertex *u1, TESSvertex *v1, TESSvertex *w1,
+				   TESSvertex *u2, TESSvertex *v2, TESSvertex *w2 )
+{
+#ifdef TESS_INTEGER_GRID
+	TESSgrid num1, den1, num2, den2;
+
+	GridEdgeEval( u1, v1, w1, &num1, &den1 );
+	GridEdgeEval( u2, v2, w2, &num2, &den2 );
+	return num1 * den2 >= num2 * den1;
+#else
+	TESSreal t1 = tesedgeEval( u1, v1, w1 );
+	TESSreal t2 = tesedgeEval( u2, v2, w2 );
+	return (t1 >= t2);
+#endif
 }
 
 /* Given parameters a,x,b,y returns the value (b*x+a*y)/(a+b),
@@ -199,6 +273,54 @@ double Interpolate( double a, double x, double b, double y)
 
 #define Swap(a,b)	do { TESSvertex *t = a; a = b; b = t; } while (0)
 
+#ifdef TESS_INTEGER_GRID
+/* Rounds num/den to the nearest integer, halves away from zero. */
+static TESSgrid GridRoundedQuotient( TESSgrid num, TESSgrid den )
+{
+	if( den < 0 ) { num = -num; den = -den; }
+	if( num >= 0 ) return (num + den / 2) / den;
+	return -((-num + den / 2) / den);
+}
+
+static TESSgrid GridClamp( TESSgrid x, TESSgrid a0, TESSgrid a1, TESSgrid b0, TESSgrid b1 )
+{
+	TESSgrid lo = GridMax( GridMin( a0, a1 ), GridMin( b0, b1 ));
+	TESSgrid hi = GridMin( GridMax( a0, a1 ), GridMax( b0, b1 ));
+
+	if( x > hi ) x = hi;
+	if( x < lo ) x = lo;
+	return x;
+}
+
+/* Intersects the supporting lines exactly and rounds the result to the
+* nearest grid point, clamped into both edges' bounding rectangles.  Returns
+* FALSE for parallel edges, which fall back to the interpolating code.
+*/
+static int GridEdgeIntersect( TESSvertex *o1, TESSvertex *d1,
+							 TESSvertex *o2, TESSvertex *d2,
+							 TESSvertex *v )
+{
+	TESSgrid rs = GridCoord(d1->s) - GridCoord(o1->s);
+	TESSgrid rt = GridCoord(d1->t) - GridCoord(o1->t);
+	TESSgrid qs = GridCoord(d2->s) - GridCoord(o2->s);
+	TESSgrid qt = GridCoord(d2->t) - GridCoord(o2->t);
+	TESSgrid den = rs * qt - rt * qs;
+	TESSgrid num, s, t;
+
+	if( den == 0 ) return 0;
+
+	num = (GridCoord(o2->s) - GridCoord(o1->s)) * qt - (GridCoord(o2->t) - GridCoord(o1->t)) * qs;
+	s = GridCoord(o1->s) + GridRoundedQuotient( rs * num, den );
+	t = GridCoord(o1->t) + GridRoundedQuotient( rt * num, den );
+
+	v->s = (TESSreal)GridClamp( s, GridCoord(o1->s), GridCoord(d1->s),
+							   GridCoord(o2->s), GridCoord(d2->s) );
+	v->t = (TESSreal)GridClamp( t, GridCoord(o1->t), GridCoord(d1->t),
+							   GridCoord(o2->t), GridCoord(d2->t) );
+	return 1;
+}
+#endif
+
 void tesedgeIntersect( TESSvertex *o1, TESSvertex *d1,
 					  TESSvertex *o2, TESSvertex *d2,
 					  TESSvertex *v )
@@ -209,6 +331,10 @@ void tesedgeIntersect( TESSvertex *o1, TESSvertex *d1,
 {
 	TESSreal z1, z2;
 
+#ifdef TESS_INTEGER_GRID
+	if( GridEdgeIntersect( o1, d1, o2, d2, v )) return;
+#endif
+
 	/* This is certainly not the most efficient way to find the intersection
 	* of two line segments, but it is very numerically stable.
 	*
@@ -260,6 +386,13 @@ void tesedgeIntersect( TESSvertex *o1, TESSvertex *d1,
 		if( z1+z2 < 0 ) { z1 = -z1; z2 = -z2; }
 		v->t = Interpolate( z1, o2->t, z2, d2->t );
 	}
+
+#ifdef TESS_INTEGER_GRID
+	/* Keep interpolated points on the grid; the bounds are whole numbers, so
+	* rounding cannot leave the bounding rectangles. */
+	v->s = floor( v->s + (TESSreal)0.5 );
+	v->t = floor( v->t + (TESSreal)0.5 );
+#endif
 }
 
 TESSreal inCircle( TESSvertex *v, TESSvertex *v0, TESSvertex *v1, TESSvertex *v2 ) {
@@ -288,7 +421,52 @@ TESSreal inCircle( TESSvertex *v, TESSvertex *v0, TESSvertex *v1, TESSvertex *v2
 /*
 	Returns 1 is edge is locally delaunay
  */
+#ifdef TESS_INTEGER_GRID
+static TESSgrid GridOrient( TESSvertex *u, TESSvertex *v, TESSvertex *w )
+{
+	return (GridCoord(v->s) - GridCoord(u->s)) * (GridCoord(w->t) - GridCoord(u->t))
+		- (GridCoord(v->t) - GridCoord(u->t)) * (GridCoord(w->s) - GridCoord(u->s));
+}
+
+/* TRUE if flipping e leaves two strictly counter-clockwise triangles. */
+static int GridFlipIsConvex( TESShalfEdge *e )
+{
+	TESSvertex *a = e->Org;
+	TESSvertex *b = e->Dst;
+	TESSvertex *c = e->Lnext->Lnext->Org;
+	TESSvertex *d = e->Sym->Lnext->Lnext->Org;
+
+	return GridOrient( d, b, c ) > 0 && GridOrient( c, a, d ) > 0;
+}
+
+static int GridInCircleSign( TESSvertex *v, TESSvertex *v0, TESSvertex *v1, TESSvertex *v2 )
+{
+	TESSgrid adx = GridCoord(v0->s) - GridCoord(v->s);
+	TESSgrid ady = GridCoord(v0->t) - GridCoord(v->t);
+	TESSgrid bdx = GridCoord(v1->s) - GridCoord(v->s);
+	TESSgrid bdy = GridCoord(v1->t) - GridCoord(v->t);
+	TESSgrid cdx = GridCoord(v2->s) - GridCoord(v->s);
+	TESSgrid cdy = GridCoord(v2->t) - GridCoord(v->t);
+	TESSgridwide det =
+		(TESSgridwide)(adx * adx + ady * ady) * (TESSgridwide)(bdx * cdy - cdx * bdy)
+		+ (TESSgridwide)(bdx * bdx + bdy * bdy) * (TESSgridwide)(cdx * ady - adx * cdy)
+		+ (TESSgridwide)(cdx * cdx + cdy * cdy) * (TESSgridwide)(adx * bdy - bdx * ady);
+
+	return (det > 0) - (det < 0);
+}
+#endif
+
 int tesedgeIsLocallyDelaunay( TESShalfEdge *e )
 {
+#ifdef TESS_INTEGER_GRID
+	/* Snapping can leave collinear triangles, for which the in-circle test is
+	* meaningless; only flip edges whose quad is strictly convex so a flip can
+	* never fold the mesh. */
+	if( !GridFlipIsConvex( e )) return 1;
+	/* Cocircular quads are common on the grid; leave them alone instead of
+	* flipping back and forth. */
+	return GridInCircleSign(e->Sym->Lnext->Lnext->Org, e->Lnext->Org, e->Lnext->Lnext->Org, e->Org) <= 0;
+#else
 	return inCircle(e->Sym->Lnext->Lnext->Org, e->Lnext->Org, e->Lnext->Lnext->Org, e->Org) < 0;
+#endif
 }
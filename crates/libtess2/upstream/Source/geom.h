@@ -53,7 +53,15 @@
 * This does not seem to be the case if the x coordinates are almost 0. Always using tesedgeEval() fixes this discrepancy.
 * See https://github.com/memononen/libtess2/issues/22 for example data that triggers the issue.
 */
+#ifdef TESS_INTEGER_GRID
+/* On the integer grid tesedgeSign() is exact, so it is safe to use again. */
+#define EdgeSign(u,v,w)	tesedgeSign(u,v,w)
+#else
 #define EdgeSign(u,v,w)	tesedgeEval(u,v,w)
+#endif
+
+/* EdgeEval(u1,v1,w1) >= EdgeEval(u2,v2,w2), evaluated exactly on the integer grid. */
+#define EdgeEvalGeq(u1,v1,w1,u2,v2,w2) tesedgeEvalGeq(u1,v1,w1,u2,v2,w2)
 
 /* Versions of VertLeq, EdgeSign, EdgeEval with s and t transposed. */
 
@@ -74,6 +82,8 @@
 int tesvertLeq( TESSvertex *u, TESSvertex *v );
 TESSreal	tesedgeEval( TESSvertex *u, TESSvertex *v, TESSvertex *w );
 TESSreal	tesedgeSign( TESSvertex *u, TESSvertex *v, TESSvertex *w );
+int tesedgeEvalGeq( TESSvertex *u1, TESSvertex *v1, TESSvertex *w1,
+				   TESSvertex *u2, TESSvertex *v2, TESSvertex *w2 );
 TESSreal	testransEval( TESSvertex *u, TESSvertex *v, TESSvertex *w );
 TESSreal	testransSign( TESSvertex *u, TESSvertex *v, TESSvertex *w );
 int tesvertCCW( TESSvertex *u, TESSvertex *v, TESSvertex *w );
@@ -79,6 +79,7 @@ static TESShalfEdge *MakeEdge( TESSmesh* mesh, TESShalfEdge *eNext )
 	e->Org = NULL;
 	e->Lface = NULL;
 	e->winding = 0;
+	e->operandWinding = 0;
 	e->activeRegion = NULL;
 	e->mark = 0;
 
@@ -88,6 +89,7 @@ static TESShalfEdge *MakeEdge( TESSmesh* mesh, TESShalfEdge *eNext )
 	eSym->Org = NULL;
 	eSym->Lface = NULL;
 	eSym->winding = 0;
+	eSym->operandWinding = 0;
 	eSym->activeRegion = NULL;
 	eSym->mark = 0;
 
@@ -469,6 +471,8 @@ TESShalfEdge *tessMeshSplitEdge( TESSmesh *mesh, TESShalfEdge *eOrg )
 	eNew->Rface = eOrg->Rface;
 	eNew->winding = eOrg->winding;	/* copy old winding information */
 	eNew->Sym->winding = eOrg->Sym->winding;
+	eNew->operandWinding = eOrg->operandWinding;
+	eNew->Sym->operandWinding = eOrg->Sym->operandWinding;
 
 	return eNew;
 }
@@ -630,6 +634,7 @@ TESSmesh *tessMeshNewMesh( TESSalloc* alloc )
 	e->Org = NULL;
 	e->Lface = NULL;
 	e->winding = 0;
+	e->operandWinding = 0;
 	e->activeRegion = NULL;
 
 	eSym->next = eSym;
@@ -639,6 +644,7 @@ TESSmesh *tessMeshNewMesh( TESSalloc* alloc )
 	eSym->Org = NULL;
 	eSym->Lface = NULL;
 	eSym->winding = 0;
+	eSym->operandWinding = 0;
 	eSym->activeRegion = NULL;
 
 	return mesh;
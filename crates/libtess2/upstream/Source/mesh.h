@@ -143,6 +143,8 @@ struct TESShalfEdge {
 	ActiveRegion *activeRegion;  /* a region with this upper edge (sweep.c) */
 	int winding;    /* change in winding number when crossing
 						  from the right face to the left face */
+	int operandWinding; /* the part of "winding" contributed by
+						  contours of the second boolean operand */
 	int mark; /* Used by the Edge Flip algorithm */
 };
 
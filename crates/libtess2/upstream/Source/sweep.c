@@ -88,7 +88,9 @@ extern void DebugEvent( TESStesselator *tess );
 * winding of the new edge.
 */
 #define AddWinding(eDst,eSrc)	(eDst->winding += eSrc->winding, \
-	eDst->Sym->winding += eSrc->Sym->winding)
+	eDst->Sym->winding += eSrc->Sym->winding, \
+	eDst->operandWinding += eSrc->operandWinding, \
+	eDst->Sym->operandWinding += eSrc->Sym->operandWinding)
 
 static void SweepEvent( TESStesselator *tess, TESSvertex *vEvent );
 static void WalkDirtyRegions( TESStesselator *tess, ActiveRegion *regUp );
@@ -109,7 +111,6 @@ static int EdgeLeq( TESStesselator *tess, ActiveRegion *reg1, ActiveRegion *reg2
 {
 	TESSvertex *event = tess->event;
 	TESShalfEdge *e1, *e2;
-	TESSreal t1, t2;
 
 	e1 = reg1->eUp;
 	e2 = reg2->eUp;
@@ -130,10 +131,8 @@ static int EdgeLeq( TESStesselator *tess, ActiveRegion *reg1, ActiveRegion *reg2
 		return EdgeSign( e1->Dst, event, e1->Org ) >= 0;
 	}
 
-	/* General case - compute signed distance *from* e1, e2 to event */
-	t1 = EdgeEval( e1->Dst, event, e1->Org );
-	t2 = EdgeEval( e2->Dst, event, e2->Org );
-	return (t1 >= t2);
+	/* General case - compare signed distances *from* e1, e2 to event */
+	return EdgeEvalGeq( e1->Dst, event, e1->Org, e2->Dst, event, e2->Org );
 }
 
 
@@ -244,11 +243,41 @@ static int IsWindingInside( TESStesselator *tess, int n )
 	return( FALSE );
 }
 
+/* With a boolean operation set, each operand is classified by the winding
+* rule on its own and the results are combined by the operation.
+*/
+static int IsRegionInside( TESStesselator *tess, ActiveRegion *reg )
+{
+	int first, second;
+
+	if( tess->booleanOperation == TESS_BOOLEAN_NONE )
+		return IsWindingInside( tess, reg->windingNumber );
+
+	first = IsWindingInside( tess, reg->windingNumber - reg->operandWindingNumber );
+	second = IsWindingInside( tess, reg->operandWindingNumber );
+	switch( tess->booleanOperation ) {
+		case TESS_BOOLEAN_UNION:
+			return first || second;
+		case TESS_BOOLEAN_INTERSECTION:
+			return first && second;
+		case TESS_BOOLEAN_DIFFERENCE:
+			return first && !second;
+		case TESS_BOOLEAN_XOR:
+			return first != second;
+	}
+	/*LINTED*/
+	assert( FALSE );
+	/*NOTREACHED*/
+
+	return( FALSE );
+}
+
 
 static void ComputeWinding( TESStesselator *tess, ActiveRegion *reg )
 {
 	reg->windingNumber = RegionAbove(reg)->windingNumber + reg->eUp->winding;
-	reg->inside = IsWindingInside( tess, reg->windingNumber );
+	reg->operandWindingNumber = RegionAbove(reg)->operandWindingNumber + reg->eUp->operandWinding;
+	reg->inside = IsRegionInside( tess, reg );
 }
 
 
@@ -373,7 +402,8 @@ static void AddRightEdges( TESStesselator *tess, ActiveRegion *regUp,
 		}
 		/* Compute the winding number and "inside" flag for the new regions */
 		reg->windingNumber = regPrev->windingNumber - e->winding;
-		reg->inside = IsWindingInside( tess, reg->windingNumber );
+		reg->operandWindingNumber = regPrev->operandWindingNumber - e->operandWinding;
+		reg->inside = IsRegionInside( tess, reg );
 
 		/* Check for two outgoing edges with same slope -- process these
 		* before any intersection tests (see example in tessComputeInterior).
@@ -708,6 +738,7 @@ static int CheckForIntersect( TESStesselator *tess, ActiveRegion *regUp )
 	if ( !tessMeshSplice( tess->mesh, eLo->Oprev, eUp ) ) longjmp(tess->env,1);
 	eUp->Org->s = isect.s;
 	eUp->Org->t = isect.t;
+	tess->intersectionCount++;
 	eUp->Org->pqHandle = pqInsert( &tess->alloc, tess->pq, eUp->Org );
 	if (eUp->Org->pqHandle == INV_HANDLE) {
 		pqDeletePriorityQ( &tess->alloc, tess->pq );
@@ -1109,6 +1140,7 @@ static void AddSentinel( TESStesselator *tess, TESSreal smin, TESSreal smax, TES
 
 	reg->eUp = e;
 	reg->windingNumber = 0;
+	reg->operandWindingNumber = 0;
 	reg->inside = FALSE;
 	reg->fixUpperEdge = FALSE;
 	reg->sentinel = TRUE;
@@ -1131,8 +1163,14 @@ static void InitEdgeDict( TESStesselator *tess )
 	if (tess->dict == NULL) longjmp(tess->env,1);
 
 	/* If the bbox is empty, ensure that sentinels are not coincident by slightly enlarging it. */
+#ifdef TESS_INTEGER_GRID
+	/* Sentinels must stay on the grid as well. */
+	w = (tess->bmax[0] - tess->bmin[0]) + 1;
+	h = (tess->bmax[1] - tess->bmin[1]) + 1;
+#else
 	w = (tess->bmax[0] - tess->bmin[0]) + (TESSreal)0.01;
 	h = (tess->bmax[1] - tess->bmin[1]) + (TESSreal)0.01;
+#endif
 
 	smin = tess->bmin[0] - w;
     smax = tess->bmax[0] + w;
@@ -1296,6 +1334,7 @@ int tessComputeInterior( TESStesselator *tess )
 	*
 	*	e1 < e2  iff  e1.x < e2.x || (e1.x == e2.x && e1.y < e2.y)
 	*/
+	tess->intersectionCount = 0;
 	RemoveDegenerateEdges( tess );
 	if ( !InitPriorityQ( tess ) ) return 0; /* if error */
 	InitEdgeDict( tess );
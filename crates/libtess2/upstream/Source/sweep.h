@@ -58,6 +58,8 @@ struct ActiveRegion {
 	DictNode *nodeUp;	/* dictionary node corresponding to eUp */
 	int windingNumber;	/* used to determine which regions are
 							* inside the polygon */
+	int operandWindingNumber;	/* the part of windingNumber due to
+							* the second boolean operand */
 	int inside;		/* is this region inside the polygon? */
 	int sentinel;	/* marks fake edges at t = +/-infinity */
 	int dirty;		/* marks regions where the upper or lower
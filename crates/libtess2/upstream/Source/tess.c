@@ -213,6 +213,33 @@ extern int RandomSweep;
 /* Determine the polygon normal and project vertices onto the plane
 * of the polygon.
 */
+#ifdef TESS_INTEGER_GRID
+/* Snaps s,t onto a grid of tess->gridResolution cells across the larger side
+* of the ST bounds.  The vertices keep whole grid coordinates (exactly
+* representable in TESSreal), which lets geom.c evaluate the sweep predicates
+* in 64-bit integers.  Vertices that land on the same cell are merged by the
+* sweep like any other coincident vertices.
+*/
+static void SnapToGrid( TESStesselator *tess )
+{
+	TESSvertex *v, *vHead = &tess->mesh->vHead;
+	TESSreal w = tess->bmax[0] - tess->bmin[0];
+	TESSreal h = tess->bmax[1] - tess->bmin[1];
+	TESSreal extent = (w > h) ? w : h;
+	TESSreal cell = (extent > 0) ? extent / tess->gridResolution : 1;
+
+	for( v = vHead->next; v != vHead; v = v->next )
+	{
+		v->s = floor( (v->s - tess->bmin[0]) / cell + (TESSreal)0.5 );
+		v->t = floor( (v->t - tess->bmin[1]) / cell + (TESSreal)0.5 );
+	}
+	tess->bmax[0] = floor( w / cell + (TESSreal)0.5 );
+	tess->bmax[1] = floor( h / cell + (TESSreal)0.5 );
+	tess->bmin[0] = 0;
+	tess->bmin[1] = 0;
+}
+#endif
+
 void tessProjectPolygon( TESStesselator *tess )
 {
 	TESSvertex *v, *vHead = &tess->mesh->vHead;
@@ -292,6 +319,10 @@ void tessProjectPolygon( TESStesselator *tess )
 			if (v->t > tess->bmax[1]) tess->bmax[1] = v->t;
 		}
 	}
+
+#ifdef TESS_INTEGER_GRID
+	SnapToGrid( tess );
+#endif
 }
 
 #define AddWinding(eDst,eSrc)	(eDst->winding += eSrc->winding, \
@@ -636,6 +667,10 @@ TESStesselator* tessNewTess( TESSalloc* alloc )
 	tess->bmax[1] = 0;
 
 	tess->reverseContours = 0;
+	tess->gridResolution = TESS_DEFAULT_GRID_RESOLUTION;
+	tess->booleanOperation = TESS_BOOLEAN_NONE;
+	tess->contourOperand = 0;
+	tess->intersectionCount = 0;
     
 	tess->windingRule = TESS_WINDING_ODD;
 	tess->processCDT = 0;
@@ -993,6 +1028,8 @@ void tessAddContour( TESStesselator *tess, int size, const void* vertices,
 		*/
         e->winding = tess->reverseContours ? -1 : 1;
         e->Sym->winding = tess->reverseContours ? 1 : -1;
+		e->operandWinding = tess->contourOperand ? e->winding : 0;
+		e->Sym->operandWinding = tess->contourOperand ? e->Sym->winding : 0;
 	}
 }
 
@@ -1006,6 +1043,18 @@ void tessSetOption( TESStesselator *tess, int option, int value )
 	case TESS_REVERSE_CONTOURS:
 		tess->reverseContours = value > 0 ? 1 : 0;
 		break;
+	case TESS_GRID_RESOLUTION:
+		if (value < 1) value = 1;
+		if (value > TESS_MAX_GRID_RESOLUTION) value = TESS_MAX_GRID_RESOLUTION;
+		tess->gridResolution = value;
+		break;
+	case TESS_BOOLEAN_OPERATION:
+		if (value < TESS_BOOLEAN_NONE || value > TESS_BOOLEAN_XOR) value = TESS_BOOLEAN_NONE;
+		tess->booleanOperation = value;
+		break;
+	case TESS_CONTOUR_OPERAND:
+		tess->contourOperand = value > 0 ? 1 : 0;
+		break;
 	}
 }
 
@@ -1131,3 +1180,8 @@ TESSstatus tessGetStatus( TESStesselator *tess )
 	return tess->status;
 }
 
+int tessGetIntersectionCount( TESStesselator *tess )
+{
+	return tess->intersectionCount;
+}
+
@@ -61,6 +61,10 @@ struct TESStesselator {
 
 	int processCDT;	/* option to run Constrained Delayney pass. */
 	int reverseContours; /* tessAddContour() will treat CCW contours as CW and vice versa */
+	int gridResolution; /* cells across the ST bounds when built with TESS_INTEGER_GRID */
+	int booleanOperation; /* TessBooleanOperation combining the two operands */
+	int contourOperand; /* operand of contours added by tessAddContour() */
+	int intersectionCount; /* vertices created at edge crossings by the sweep */
     
 	/*** state needed for the line sweep ***/
 	int	windingRule;	/* rule for determining polygon interior */
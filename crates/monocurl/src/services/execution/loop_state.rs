@@ -1,5 +1,6 @@
 use std::{
     cell::{Cell, RefCell},
+    collections::HashMap,
     f64,
     rc::Rc,
     time::{Duration, Instant},
@@ -16,7 +17,7 @@ use futures::{
     future::{self, LocalBoxFuture},
 };
 use smol::Timer;
-use stdlib::registry::registry;
+use stdlib::{live_tessellation, registry::registry};
 use structs::{
     futures::yield_now,
     rope::{Rope, TextAggregate},
@@ -29,6 +30,9 @@ use super::{
     default_bytecode,
 };
 
+// how often a paused drag checks whether background tessellations finished
+const LIVE_SETTLE_POLL_INTERVAL: Duration = Duration::from_millis(4);
+
 struct SharedRuntimeState {
     target: Cell<Timestamp>,
     current_timestamp: Cell<Timestamp>,
@@ -40,6 +44,13 @@ struct SharedRuntimeState {
     pending_param_updates: RefCell<Vec<(PresentationUpdateTarget, ParameterValue)>>,
     last_update_at: Cell<Instant>,
     snapshot_requested: Cell<bool>,
+    // the requested snapshot follows parameter updates, so tessellation may
+    // show outdated shapes rather than stall the frame
+    live_snapshot: Cell<bool>,
+    // parameter values applied since the last snapshot without outdated
+    // tessellations, and when a live snapshot last showed one
+    unsettled_updates: RefCell<HashMap<PresentationUpdateTarget, ParameterValue>>,
+    unsettled_since: Cell<Option<Instant>>,
 }
 
 impl SharedRuntimeState {
@@ -59,6 +70,9 @@ impl SharedRuntimeState {
             pending_param_updates: RefCell::new(Vec::new()),
             last_update_at: Cell::new(Instant::now()),
             snapshot_requested: Cell::new(false),
+            live_snapshot: Cell::new(false),
+            unsettled_updates: RefCell::new(HashMap::new()),
+            unsettled_since: Cell::new(None),
         }
     }
 
@@ -72,6 +86,7 @@ impl SharedRuntimeState {
     fn needs_work(&self) -> bool {
         self.snapshot_requested.get()
             || !self.pending_param_updates.borrow().is_empty()
+            || self.unsettled_since.get().is_some()
             || self.is_playing.get()
             || self.target.get() != self.current_timestamp.get()
     }
@@ -89,6 +104,8 @@ impl SharedRuntimeState {
 
     fn clear_pending_parameter_updates(&self) {
         self.pending_param_updates.borrow_mut().clear();
+        self.unsettled_updates.borrow_mut().clear();
+        self.unsettled_since.set(None);
     }
 }
 
@@ -269,8 +286,17 @@ async fn run_play_session_iteration(
     root_text_rope: &Rope<TextAggregate>,
     version: usize,
 ) {
+    let settling = match settle_live_tessellation(shared) {
+        LiveSettle::Idle => false,
+        LiveSettle::Wait => {
+            Timer::after(LIVE_SETTLE_POLL_INTERVAL).await;
+            return;
+        }
+        LiveSettle::Reapply => true,
+    };
     if apply_pending_parameter_updates(executor, shared) {
         shared.snapshot_requested.set(true);
+        shared.live_snapshot.set(!settling);
     }
 
     if shared.has_compiler_error.get() {
@@ -331,10 +357,19 @@ async fn run_play_session_iteration(
     }
 
     if shared.snapshot_requested.get() {
+        let live = shared
+            .live_snapshot
+            .replace(false)
+            .then(live_tessellation::LiveScope::enter);
         let scene_snapshot = capture_scene_snapshot(executor, shared)
             .await
             .ok()
             .flatten();
+        if live.is_some_and(live_tessellation::LiveScope::finish) {
+            shared.unsettled_since.set(Some(Instant::now()));
+        } else if shared.unsettled_since.get().is_none() {
+            shared.unsettled_updates.borrow_mut().clear();
+        }
         emit_runtime_snapshot(
             executor,
             shared,
@@ -354,11 +389,47 @@ async fn run_play_session_iteration(
     }
 }
 
+enum LiveSettle {
+    Idle,
+    Wait,
+    Reapply,
+}
+
+// once a drag pauses after a snapshot that showed outdated tessellations, wait
+// for the background sweeps (up to their staleness bound) and then apply the
+// same parameter values again outside a live scope, so the resting frame is
+// exact and mostly served from the finished sweeps
+fn settle_live_tessellation(shared: &SharedRuntimeState) -> LiveSettle {
+    let Some(since) = shared.unsettled_since.get() else {
+        return LiveSettle::Idle;
+    };
+    if !shared.pending_param_updates.borrow().is_empty() {
+        return LiveSettle::Idle;
+    }
+    // seeking and playback should not sit behind the pool
+    let idle = !shared.is_playing.get() && shared.target.get() == shared.current_timestamp.get();
+    if idle
+        && live_tessellation::jobs_in_flight() > 0
+        && since.elapsed() < live_tessellation::MAX_STALENESS
+    {
+        return LiveSettle::Wait;
+    }
+
+    shared.unsettled_since.set(None);
+    let updates = shared.unsettled_updates.take();
+    shared.pending_param_updates.borrow_mut().extend(updates);
+    LiveSettle::Reapply
+}
+
 fn apply_pending_parameter_updates(executor: &mut Executor, shared: &SharedRuntimeState) -> bool {
     let updates = shared.pending_param_updates.take();
     let applied_parameters = !updates.is_empty();
 
     for (target, value) in updates {
+        shared
+            .unsettled_updates
+            .borrow_mut()
+            .insert(target.clone(), value.clone());
         let Some(value) = ExecutionService::runtime_value_from_parameter(&value) else {
             log::warn!(
                 "parameter update failed for {:?}: unsupported value",
@@ -671,9 +742,10 @@ fn compact_message_batch(messages: Vec<ExecutionMessage>) -> Vec<ExecutionMessag
 
 #[cfg(test)]
 mod tests {
-    use std::collections::HashMap;
+    use std::{collections::HashMap, time::Instant};
 
     use executor::{state::ExecutionState, time::Timestamp, value::Value};
+    use stdlib::live_tessellation;
     use structs::rope::{Rope, TextAggregate};
 
     use super::{RuntimeState, compact_message_batch, default_bytecode};
@@ -779,6 +851,36 @@ mod tests {
         }));
     }
 
+    #[test]
+    fn paused_drag_reapplies_unsettled_parameters() {
+        let runtime = RuntimeState::new();
+        let update = (
+            PresentationUpdateTarget::Scene { leader_index: 0 },
+            ParameterValue::Float(2.0),
+        );
+        runtime
+            .shared
+            .unsettled_updates
+            .borrow_mut()
+            .insert(update.0.clone(), update.1.clone());
+        runtime
+            .shared
+            .unsettled_since
+            .set(Some(Instant::now() - live_tessellation::MAX_STALENESS));
+        assert!(runtime.shared.needs_work());
+
+        assert!(matches!(
+            super::settle_live_tessellation(&runtime.shared),
+            super::LiveSettle::Reapply
+        ));
+        assert_eq!(*runtime.shared.pending_param_updates.borrow(), vec![update]);
+        assert!(runtime.shared.unsettled_since.get().is_none());
+        assert!(matches!(
+            super::settle_live_tessellation(&runtime.shared),
+            super::LiveSettle::Idle
+        ));
+    }
+
     #[test]
     fn compact_message_batch_keeps_latest_consecutive_seek() {
         let compacted = compact_message_batch(vec![
@@ -10,6 +10,8 @@ pub mod registry;
 mod scene;
 mod util;
 
+pub use mesh::live_tessellation;
+
 pub(crate) const STRING_COMPATIBLE_DESC: &str = "string-compatible value";
 
 pub(crate) fn stringify_value<'a>(
@@ -19,6 +19,12 @@ const MAX_CURVE_SAMPLES: usize = 1 << 14;
 const MAX_GRID_CELLS: usize = 1 << 16;
 const MAX_SURFACE_TRIANGLES: usize = 1 << 17;
 const DEFAULT_ARROW_PATH_SAMPLES: usize = 64;
+// how far a sampled circle or arc may stray from the true curve, in world
+// units. the default camera shows about 74 pixels per unit at the reference
+// width, so this is a tenth of a pixel there; a unit circle gets 63 segments,
+// close to the 64 it always had, small dots get a handful and large rings more
+const CURVE_CHORD_TOLERANCE: f32 = 1.25e-3;
+const MIN_CIRCLE_SAMPLES: usize = 12;
 const MAX_ARROW_HEAD_RADIUS: f32 = 0.065;
 const ARROW_HEAD_RADIUS_OVER_LENGTH: f32 = 0.4;
 const ARROW_STEM_RADIUS_OVER_HEAD_RADIUS: f32 = 0.33;
@@ -63,6 +69,30 @@ fn ensure_limit(kind: &str, actual: usize, limit: usize) -> Result<(), ExecutorE
     }
 }
 
+// segments a circular arc of this radius and sweep needs to keep within
+// CURVE_CHORD_TOLERANCE, capped at `limit`; a chord of a circle of radius r
+// subtending angle a strays r * (1 - cos(a / 2)) from it. Worked in f64 since
+// in f32 the step rounds to zero for radii in the tens of thousands
+fn arc_segments(radius: f32, sweep: f32, limit: usize) -> usize {
+    let radius = f64::from(radius.abs());
+    let tolerance = f64::from(CURVE_CHORD_TOLERANCE);
+    let step = if radius > tolerance {
+        2.0 * (1.0 - tolerance / radius).acos()
+    } else {
+        std::f64::consts::PI
+    };
+    let segments = (f64::from(sweep.abs()) / step).ceil();
+    if segments >= limit as f64 {
+        limit
+    } else {
+        (segments as usize).max(1)
+    }
+}
+
+fn circle_samples(radius: f32) -> usize {
+    arc_segments(radius, std::f32::consts::TAU, MAX_POLYGON_POINTS).max(MIN_CIRCLE_SAMPLES)
+}
+
 fn checked_product(kind: &str, a: usize, b: usize, limit: usize) -> Result<usize, ExecutorError> {
     let total = a
         .checked_mul(b)
@@ -372,7 +402,8 @@ mod tests {
     use geo::simd::Float3;
 
     use super::{
-        ARROW_MAX_HEAD_HALF_WIDTH_OVER_LENGTH, closed_polyline, fan_tris, mesh_ref, open_polyline,
+        ARROW_MAX_HEAD_HALF_WIDTH_OVER_LENGTH, CURVE_CHORD_TOLERANCE, MIN_CIRCLE_SAMPLES,
+        arc_segments, circle_samples, closed_polyline, fan_tris, mesh_ref, open_polyline,
         triangle_mesh, vector_like_mesh,
     };
 
@@ -388,6 +419,30 @@ mod tests {
             .fold(0.0, f32::max)
     }
 
+    #[test]
+    fn curve_samples_follow_the_chord_tolerance() {
+        let radii = [0.02f32, 0.05, 0.3, 1.0, 4.0, 25.0];
+        for radius in radii {
+            let segments = arc_segments(radius, std::f32::consts::TAU, usize::MAX);
+            let step = std::f32::consts::TAU / segments as f32;
+            assert!(radius * (1.0 - (step / 2.0).cos()) <= CURVE_CHORD_TOLERANCE * 1.001);
+        }
+        assert_eq!(circle_samples(1.0), 63);
+        assert_eq!(circle_samples(0.02), MIN_CIRCLE_SAMPLES);
+        assert!(circle_samples(25.0) > 4 * circle_samples(1.0));
+        assert_eq!(arc_segments(1.0, 0.0, usize::MAX), 1);
+        assert!(arc_segments(1.0, -std::f32::consts::PI, usize::MAX) * 2 >= circle_samples(1.0));
+        // huge radii and multi-turn sweeps clamp to the limit instead of
+        // overflowing or erroring
+        assert_eq!(circle_samples(4e4), MAX_POLYGON_POINTS);
+        assert_eq!(circle_samples(f32::INFINITY), MAX_POLYGON_POINTS);
+        assert_eq!(
+            arc_segments(1000.0, 10.0 * std::f32::consts::TAU, MAX_CURVE_SAMPLES - 1),
+            MAX_CURVE_SAMPLES - 1
+        );
+        assert_eq!(arc_segments(f32::NAN, 1.0, 16), 1);
+    }
+
     #[test]
     fn closed_polyline_sets_reciprocal_links() {
         let lines = closed_polyline(&[Float3::X, Float3::Y, Float3::Z, Float3::ZERO], Float3::Z);
@@ -497,7 +552,10 @@ pub async fn mk_dot(executor: &mut Executor, stack_idx: usize) -> Result<Value,
 pub async fn mk_circle(executor: &mut Executor, stack_idx: usize) -> Result<Value, ExecutorError> {
     let center = Float3::ZERO;
     let radius = crate::read_float(executor, stack_idx, -2, "radius")? as f32;
-    let samples = read_int(executor, stack_idx, -1, "samples")?.max(3) as usize;
+    let samples = match read_int(executor, stack_idx, -1, "samples")? {
+        ..=0 => circle_samples(radius),
+        samples => samples.max(3) as usize,
+    };
     ensure_limit("circle samples", samples, MAX_POLYGON_POINTS)?;
     let (x, y, normal) = polygon_basis(Float3::Z);
     let points: Vec<_> = (0..samples)
@@ -515,17 +573,18 @@ pub async fn mk_annulus(executor: &mut Executor, stack_idx: usize) -> Result<Val
     let center = Float3::ZERO;
     let inner = crate::read_float(executor, stack_idx, -2, "inner")? as f32;
     let outer = crate::read_float(executor, stack_idx, -1, "outer")? as f32;
-    let samples = 64usize;
+    let inner_samples = circle_samples(inner);
+    let outer_samples = circle_samples(outer);
     let (x, y, normal) = polygon_basis(Float3::Z);
-    let inner_pts: Vec<_> = (0..samples)
+    let inner_pts: Vec<_> = (0..inner_samples)
         .map(|i| {
-            let theta = std::f32::consts::TAU * i as f32 / samples as f32;
+            let theta = std::f32::consts::TAU * i as f32 / inner_samples as f32;
             center + x * (inner * theta.cos()) + y * (inner * theta.sin())
         })
         .collect();
-    let outer_pts: Vec<_> = (0..samples)
+    let outer_pts: Vec<_> = (0..outer_samples)
         .map(|i| {
-            let theta = std::f32::consts::TAU * i as f32 / samples as f32;
+            let theta = std::f32::consts::TAU * i as f32 / outer_samples as f32;
             center + x * (outer * theta.cos()) + y * (outer * theta.sin())
         })
         .collect();
@@ -641,8 +700,7 @@ pub async fn mk_arc(executor: &mut Executor, stack_idx: usize) -> Result<Value,
     let theta0 = crate::read_float(executor, stack_idx, -2, "theta0")? as f32;
     let theta1 = crate::read_float(executor, stack_idx, -1, "theta1")? as f32;
     let (x, y, normal) = polygon_basis(Float3::Z);
-    let steps = (((theta1 - theta0).abs() / std::f32::consts::TAU) * 64.0).ceil() as usize + 2;
-    ensure_limit("arc samples", steps, MAX_CURVE_SAMPLES)?;
+    let steps = arc_segments(radius, theta1 - theta0, MAX_CURVE_SAMPLES - 1) + 1;
     let points: Vec<_> = (0..steps)
         .map(|i| {
             let t = i as f32 / (steps - 1) as f32;
@@ -1,11 +1,13 @@
 use std::{
     collections::{HashMap, HashSet},
     future::Future,
+    num::NonZeroUsize,
     ops::Range,
     path::{Path, PathBuf},
     pin::Pin,
     rc::Rc,
     sync::Arc,
+    thread,
 };
 
 use executor::{
@@ -19,9 +21,20 @@ use geo::{
     mesh_build::{self, BoundaryEdge, IndexedLineMesh, IndexedSurface, SurfaceVertex},
     simd::{Float2, Float3, Float4},
 };
-use libtess2::{TessellationOptions, WindingRule};
+use libtess2::{
+    PlaneGroup, PlaneTolerance, Precision, STRIP_MIN_VERTICES, StripOptions, TessellationOptions,
+    WindingRule,
+};
+
+use super::live_tessellation;
 
 const NORMAL_EPSILON: f32 = 1e-6;
+// complements the point-count limits in constructors with a ceiling on what a
+// single libtess2 sweep may allocate
+const MAX_TESSELLATION_BYTES: usize = 1 << 30;
+// below this many vertices across a batch of upranks, spawning workers costs
+// more than the sweeps they would share
+const PARALLEL_UPRANK_MIN_VERTICES: usize = 2048;
 
 fn default_ink() -> Float4 {
     Float4::new(0.0, 0.0, 0.0, 1.0)
@@ -87,6 +100,35 @@ impl MeshTree {
         })
     }
 
+    // which leaves, in iteration order, pass the filter
+    pub(super) async fn filtered_leaves(
+        &self,
+        executor: &mut Executor,
+        filter: Option<&TagFilter>,
+    ) -> Result<Vec<bool>, ExecutorError> {
+        let mut selected = Vec::new();
+        for mesh in self.iter() {
+            selected.push(match filter {
+                Some(filter) => mesh_matches_tag_filter(executor, filter, mesh).await?,
+                None => true,
+            });
+        }
+        Ok(selected)
+    }
+
+    // visits leaves in iteration order without making them unique, so callers
+    // can leave the ones they skip shared
+    pub(super) fn for_each_leaf(&mut self, f: &mut impl FnMut(&mut Arc<Mesh>)) {
+        match self {
+            MeshTree::Mesh(arc) => f(arc),
+            MeshTree::List(children) => {
+                for child in children {
+                    child.for_each_leaf(f);
+                }
+            }
+        }
+    }
+
     pub(super) fn into_value(self) -> Value {
         match self {
             MeshTree::Mesh(arc) => Value::Mesh(arc),
@@ -990,10 +1032,101 @@ fn tessellate_planar_loops_with_options(
         return Ok((Vec::new(), Vec::new()));
     }
     let normal = resolve_planar_normal(&contours, normal);
+    live_tessellation::tessellate(contours, normal, normalize_input)
+}
+
+// expects contours already filtered and a resolved normal
+pub(super) fn sweep_planar_loops(
+    contours: &[Vec<Float3>],
+    normal: Float3,
+    normalize_input: bool,
+) -> Result<(Vec<Lin>, Vec<Tri>), ExecutorError> {
+    let options = planar_tessellation_options(Some(normal), normalize_input);
+    let vertex_count: usize = contours.iter().map(Vec::len).sum();
+    let tess = if vertex_count >= STRIP_MIN_VERTICES {
+        libtess2::triangulate_in_strips(
+            contours.iter().map(Vec::as_slice),
+            options,
+            StripOptions::default(),
+        )
+    } else {
+        libtess2::triangulate(contours.iter().map(Vec::as_slice), options)
+    }
+    .map_err(tessellation_error)?;
+
+    Ok(surface_from_tessellation(
+        contours,
+        &tess,
+        |_| normal,
+        |_| normal,
+    ))
+}
+
+// loops spread over several planes (the faces of a solid, say) are grouped by
+// plane and each group is swept in its own projection; every boundary edge
+// takes the normal of the plane it was swept in
+fn tessellate_multi_planar_loops(
+    contours: &[Vec<Float3>],
+    groups: &[PlaneGroup],
+) -> Result<(Vec<Lin>, Vec<Tri>), ExecutorError> {
+    let mut contour_normals = vec![Float3::Z; contours.len()];
+    for group in groups {
+        for &contour in &group.contours {
+            contour_normals[contour] = group.plane.normal;
+        }
+    }
+
+    let planar = libtess2::triangulate_planes(
+        contours.iter().map(Vec::as_slice),
+        PlaneTolerance::default(),
+        planar_tessellation_options(None, true),
+    )
+    .map_err(tessellation_error)?;
+
+    Ok(surface_from_tessellation(
+        contours,
+        &planar.tessellation,
+        |contour| contour_normals[contour],
+        |face| planar.planes[planar.triangle_planes[face]].normal,
+    ))
+}
 
+fn planar_tessellation_options(
+    normal: Option<Float3>,
+    normalize_input: bool,
+) -> TessellationOptions {
+    TessellationOptions {
+        winding_rule: WindingRule::NonZero,
+        normal,
+        constrained_delaunay: true,
+        reverse_contours: false,
+        normalize_input,
+        split_components: true,
+        parallel_components: true,
+        memory_limit: Some(MAX_TESSELLATION_BYTES),
+        precision: Precision::Auto,
+        reorder_output: true,
+        intersection_heavy: false,
+        simple_input: true,
+    }
+}
+
+fn tessellation_error(error: libtess2::TessError) -> ExecutorError {
+    ExecutorError::invalid_operation(format!("failed to tessellate polygon: {error}"))
+}
+
+// edges of the tessellation that run along an input contour keep that
+// contour's boundary attributes; any other edge gets the face normal
+fn surface_from_tessellation(
+    contours: &[Vec<Float3>],
+    tess: &libtess2::Tessellation,
+    contour_normal: impl Fn(usize) -> Float3,
+    face_normal: impl Fn(usize) -> Float3,
+) -> (Vec<Lin>, Vec<Tri>) {
     let mut source_boundary_edges = HashMap::<(usize, usize), BoundaryEdge>::new();
     let mut source_offset = 0usize;
-    for contour in &contours {
+    for (contour_idx, contour) in contours.iter().enumerate() {
+        let normal = contour_normal(contour_idx);
         for i in 0..contour.len() {
             let a = source_offset + i;
             let b = source_offset + (i + 1) % contour.len();
@@ -1015,20 +1148,6 @@ fn tessellate_planar_loops_with_options(
         source_offset += contour.len();
     }
 
-    let tess = libtess2::triangulate(
-        contours.iter().map(Vec::as_slice),
-        TessellationOptions {
-            winding_rule: WindingRule::NonZero,
-            normal: Some(normal),
-            constrained_delaunay: true,
-            reverse_contours: false,
-            normalize_input,
-        },
-    )
-    .map_err(|error| {
-        ExecutorError::invalid_operation(format!("failed to tessellate polygon: {error}"))
-    })?;
-
     let surface_vertices: Vec<_> = tess
         .vertices
         .iter()
@@ -1041,32 +1160,25 @@ fn tessellate_planar_loops_with_options(
         .collect();
 
     let mut boundary_edges = HashMap::<(usize, usize), BoundaryEdge>::new();
-    for face in &tess.triangles {
+    for (face_idx, face) in tess.triangles.iter().enumerate() {
+        let interior = BoundaryEdge {
+            a_col: default_ink(),
+            b_col: default_ink(),
+            norm: face_normal(face_idx),
+        };
         for (a, b) in [(face[0], face[1]), (face[1], face[2]), (face[2], face[0])].into_iter() {
             let edge = match (tess.source_vertex_indices[a], tess.source_vertex_indices[b]) {
                 (Some(source_a), Some(source_b)) => source_boundary_edges
                     .get(&(source_a, source_b))
                     .copied()
-                    .unwrap_or(BoundaryEdge {
-                        a_col: default_ink(),
-                        b_col: default_ink(),
-                        norm: normal,
-                    }),
-                _ => BoundaryEdge {
-                    a_col: default_ink(),
-                    b_col: default_ink(),
-                    norm: normal,
-                },
+                    .unwrap_or(interior),
+                _ => interior,
             };
             boundary_edges.insert((a, b), edge);
         }
     }
 
-    Ok(build_indexed_surface(
-        &surface_vertices,
-        &tess.triangles,
-        &boundary_edges,
-    ))
+    build_indexed_surface(&surface_vertices, &tess.triangles, &boundary_edges)
 }
 
 fn resolve_planar_normal(contours: &[Vec<Float3>], requested: Float3) -> Float3 {
@@ -1150,31 +1262,169 @@ fn closed_line_contours(mesh: &Mesh) -> Option<Vec<Vec<Float3>>> {
 }
 
 pub(crate) fn uprank_mesh(mesh: &Mesh) -> Result<Option<Mesh>, ExecutorError> {
-    let mut out = mesh.clone();
-    if !out.tris.is_empty() {
-        return Ok(Some(out));
+    UprankWork::new(mesh).finish()
+}
+
+// upranks many meshes at once: every mesh's contours are gathered first, then
+// the sweeps that may leave this thread are dealt out largest-first to scoped
+// workers and the rest run here. reports the first failure in input order
+pub(crate) fn uprank_meshes(meshes: &[&Mesh]) -> Result<Vec<Option<Mesh>>, ExecutorError> {
+    let mut works: Vec<_> = meshes
+        .iter()
+        .map(|mesh| Some(UprankWork::new(mesh)))
+        .collect();
+    let mut results: Vec<Option<Result<Option<Mesh>, ExecutorError>>> =
+        (0..works.len()).map(|_| None).collect();
+
+    let mut pooled: Vec<_> = (0..works.len())
+        .filter(|&idx| works[idx].as_ref().is_some_and(UprankWork::sweeps_anywhere))
+        .collect();
+    let size = |work: &Option<UprankWork>| work.as_ref().map_or(0, UprankWork::vertex_count);
+    let pooled_vertices: usize = pooled.iter().map(|&idx| size(&works[idx])).sum();
+    let workers = thread::available_parallelism()
+        .map_or(1, NonZeroUsize::get)
+        .min(pooled.len());
+    if workers > 1 && pooled_vertices >= PARALLEL_UPRANK_MIN_VERTICES {
+        pooled.sort_by_key(|&idx| std::cmp::Reverse(size(&works[idx])));
+        let mut assignments: Vec<Vec<_>> = (0..workers).map(|_| Vec::new()).collect();
+        let mut loads = vec![0usize; workers];
+        for idx in pooled {
+            let worker = (0..workers)
+                .min_by_key(|&worker| loads[worker])
+                .unwrap_or(0);
+            loads[worker] += size(&works[idx]);
+            let work = works[idx].take().expect("each mesh is assigned once");
+            assignments[worker].push((idx, work));
+        }
+
+        thread::scope(|scope| {
+            let handles: Vec<_> = assignments
+                .into_iter()
+                .map(|assigned| {
+                    scope.spawn(move || {
+                        assigned
+                            .into_iter()
+                            .map(|(idx, work)| (idx, work.finish()))
+                            .collect::<Vec<_>>()
+                    })
+                })
+                .collect();
+            for handle in handles {
+                for (idx, result) in handle.join().expect("uprank worker panicked") {
+                    results[idx] = Some(result);
+                }
+            }
+        });
     }
 
-    if out.lins.is_empty() && out.dots.len() >= 2 {
-        out.lins = out
-            .dots
-            .windows(2)
-            .map(|pair| default_lin(pair[0].pos, pair[1].pos, pair[0].norm))
-            .collect();
+    for (idx, work) in works.into_iter().enumerate() {
+        if let Some(work) = work {
+            results[idx] = Some(work.finish());
+        }
     }
+    results
+        .into_iter()
+        .map(|result| result.expect("every mesh is upranked"))
+        .collect()
+}
 
-    let Some(contours) = closed_line_contours(&out) else {
-        return Ok(None);
-    };
+// what upranking one mesh leaves to sweep, gathered before any sweep runs
+enum UprankWork {
+    Done(Option<Mesh>),
+    Planar {
+        out: Mesh,
+        contours: Vec<Vec<Float3>>,
+        normal: Float3,
+    },
+    MultiPlanar {
+        out: Mesh,
+        contours: Vec<Vec<Float3>>,
+        groups: Vec<PlaneGroup>,
+    },
+}
+
+impl UprankWork {
+    fn new(mesh: &Mesh) -> Self {
+        let mut out = mesh.clone();
+        if !out.tris.is_empty() {
+            return Self::Done(Some(out));
+        }
+
+        if out.lins.is_empty() && out.dots.len() >= 2 {
+            out.lins = out
+                .dots
+                .windows(2)
+                .map(|pair| default_lin(pair[0].pos, pair[1].pos, pair[0].norm))
+                .collect();
+        }
 
-    let normal = first_nonzero_line_normal(&out.lins)
-        .or_else(|| contour_area_normal(&contours))
-        .unwrap_or(Float3::Z);
-    let (lins, tris) = tessellate_planar_loops_with_options(&contours, normal, true)?;
-    out.lins = lins;
-    out.tris = tris;
-    out.debug_assert_consistent_topology();
-    Ok(Some(out))
+        let Some(contours) = closed_line_contours(&out) else {
+            return Self::Done(None);
+        };
+
+        let groups = libtess2::group_by_plane(&contours, None, PlaneTolerance::default());
+        if groups.len() > 1 {
+            Self::MultiPlanar {
+                out,
+                contours,
+                groups,
+            }
+        } else {
+            let normal = first_nonzero_line_normal(&out.lins)
+                .or_else(|| contour_area_normal(&contours))
+                .unwrap_or(Float3::Z);
+            Self::Planar {
+                out,
+                contours,
+                normal,
+            }
+        }
+    }
+
+    fn vertex_count(&self) -> usize {
+        match self {
+            Self::Done(_) => 0,
+            Self::Planar { contours, .. } | Self::MultiPlanar { contours, .. } => {
+                contours.iter().map(Vec::len).sum()
+            }
+        }
+    }
+
+    // large planar sweeps go through live tessellation, whose scope and
+    // staleness belong to the runtime thread; everything else is a plain sweep
+    fn sweeps_anywhere(&self) -> bool {
+        match self {
+            Self::Done(_) => false,
+            Self::Planar { .. } => self.vertex_count() < live_tessellation::LIVE_MIN_VERTICES,
+            Self::MultiPlanar { .. } => true,
+        }
+    }
+
+    fn finish(self) -> Result<Option<Mesh>, ExecutorError> {
+        let (mut out, (lins, tris)) = match self {
+            Self::Done(mesh) => return Ok(mesh),
+            Self::Planar {
+                out,
+                contours,
+                normal,
+            } => {
+                let surface = tessellate_planar_loops_with_options(&contours, normal, true)?;
+                (out, surface)
+            }
+            Self::MultiPlanar {
+                out,
+                contours,
+                groups,
+            } => {
+                let surface = tessellate_multi_planar_loops(&contours, &groups)?;
+                (out, surface)
+            }
+        };
+        out.lins = lins;
+        out.tris = tris;
+        out.debug_assert_consistent_topology();
+        Ok(Some(out))
+    }
 }
 
 pub(super) fn mesh_from_parts(dots: Vec<Dot>, lins: Vec<Lin>, tris: Vec<Tri>) -> Value {
@@ -1728,7 +1978,7 @@ mod tests {
 
     use super::{
         mesh_from_parts, mesh_position_groups, mesh_ref, mesh_to_indexed_lines, polygon_basis,
-        push_closed_polyline, tessellate_planar_loops, uprank_mesh,
+        push_closed_polyline, tessellate_planar_loops, uprank_mesh, uprank_meshes,
     };
 
     fn mesh_from_contours(contours: &[Vec<Float3>]) -> Mesh {
@@ -1899,6 +2149,28 @@ mod tests {
         );
     }
 
+    #[test]
+    fn uprank_sweeps_loops_from_different_planes_separately() {
+        // a floor square and a wall square standing on its far edge
+        let wall: Vec<_> = square(0.0, 0.0, 1.0)
+            .into_iter()
+            .map(|point| Float3::new(point.x, 1.0, point.y + 1.0))
+            .collect();
+        let mesh = mesh_from_contours(&[square(0.0, 0.0, 1.0), wall]);
+
+        let upranked = uprank_mesh(&mesh).expect("uprank should succeed");
+        let upranked = upranked.expect("closed contours should uprank");
+
+        assert_eq!(upranked.tris.len(), 4);
+        assert!(upranked.has_consistent_topology());
+        for tri in &upranked.tris {
+            let [a, b, c] = [tri.a.pos, tri.b.pos, tri.c.pos];
+            let on_floor = [a, b, c].iter().all(|point| point.z.abs() < 1e-6);
+            let on_wall = [a, b, c].iter().all(|point| (point.y - 1.0).abs() < 1e-6);
+            assert!(on_floor || on_wall, "{a:?} {b:?} {c:?}");
+        }
+    }
+
     #[test]
     fn uprank_handles_many_duplicate_contours() {
         let mesh = mesh_from_contours(&vec![square(0.0, 0.0, 1.0); 8]);
@@ -1941,4 +2213,47 @@ mod tests {
         assert!(!upranked.tris.is_empty());
         assert!(upranked.has_consistent_topology());
     }
+
+    #[test]
+    fn batched_uprank_matches_one_mesh_at_a_time() {
+        // enough small outlines to go to workers, one spread over two planes,
+        // one already filled and one that is not closed
+        let mut meshes: Vec<_> = (0..96)
+            .map(|idx| {
+                let center = idx as f32 * 5.0;
+                let outline: Vec<_> = (0..32)
+                    .map(|step| {
+                        let theta = std::f32::consts::TAU * step as f32 / 32.0;
+                        Float3::new(center + 2.0 * theta.cos(), 2.0 * theta.sin(), 0.0)
+                    })
+                    .collect();
+                let mut hole = square(center, 0.0, 0.5 + idx as f32 * 0.01);
+                hole.reverse();
+                mesh_from_contours(&[outline, hole])
+            })
+            .collect();
+        let wall: Vec<_> = square(0.0, 0.0, 1.0)
+            .into_iter()
+            .map(|point| Float3::new(point.x, 1.0, point.y + 1.0))
+            .collect();
+        meshes.push(mesh_from_contours(&[square(0.0, 0.0, 1.0), wall]));
+        meshes.push(uprank_mesh(&meshes[0]).unwrap().unwrap());
+        let mut open = mesh_from_contours(&[square(0.0, 0.0, 1.0)]);
+        open.lins[0].prev = -1;
+        open.lins[3].next = -1;
+        meshes.push(open);
+
+        let refs: Vec<_> = meshes.iter().collect();
+        let batched = uprank_meshes(&refs).expect("batched uprank should succeed");
+        assert_eq!(batched.len(), meshes.len());
+        assert!(batched.last().unwrap().is_none());
+        for (mesh, batched) in meshes.iter().zip(&batched) {
+            let single = uprank_mesh(mesh).expect("uprank should succeed");
+            assert_eq!(single.is_some(), batched.is_some());
+            if let (Some(single), Some(batched)) = (single, batched) {
+                assert_eq!(format!("{:?}", single.tris), format!("{:?}", batched.tris));
+                assert_eq!(format!("{:?}", single.lins), format!("{:?}", batched.lins));
+            }
+        }
+    }
 }
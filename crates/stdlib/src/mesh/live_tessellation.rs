@@ -0,0 +1,537 @@
+use std::{
+    cell::Cell,
+    collections::{HashMap, VecDeque, hash_map::DefaultHasher},
+    hash::{Hash, Hasher},
+    num::NonZeroUsize,
+    sync::{
+        Arc, Condvar, Mutex, OnceLock,
+        atomic::{AtomicU64, Ordering},
+    },
+    thread,
+    time::{Duration, Instant},
+};
+
+use executor::error::ExecutorError;
+use geo::{
+    mesh::{Lin, Tri},
+    simd::Float3,
+};
+
+use super::helpers::sweep_planar_loops;
+
+// smaller sweeps finish well inside a frame, so they never go to the pool
+pub(super) const LIVE_MIN_VERTICES: usize = 1024;
+// how long a shape may keep showing an outdated tessellation before the
+// runtime thread computes it in place
+pub const MAX_STALENESS: Duration = Duration::from_millis(250);
+const MAX_POOL_WORKERS: usize = 4;
+const EXACT_CACHE_CAPACITY: usize = 64;
+const LAYOUT_CACHE_CAPACITY: usize = 256;
+// shapes sharing a contour layout that are remembered side by side
+const ENTRIES_PER_LAYOUT: usize = 4;
+// how far, as a fraction of the shape's radius, a layout entry's centroid and
+// radius may drift before it counts as a different shape rather than this one
+// one frame earlier
+const MAX_STALE_DRIFT: f32 = 0.5;
+
+type Surface = Arc<(Vec<Lin>, Vec<Tri>)>;
+
+thread_local! {
+    static LIVE: Cell<bool> = const { Cell::new(false) };
+    static SERVED_STALE: Cell<bool> = const { Cell::new(false) };
+}
+
+static PASS: AtomicU64 = AtomicU64::new(0);
+static CACHE: OnceLock<Mutex<SurfaceCache>> = OnceLock::new();
+static POOL: OnceLock<Arc<Pool>> = OnceLock::new();
+
+// while a scope is open on the runtime thread, a large tessellation whose exact
+// input has not been swept yet goes to a background pool, and the caller gets
+// the newest tessellation of a shape with the same contour layout instead.
+// entering a scope supersedes jobs queued by earlier scopes
+pub struct LiveScope {
+    previous: bool,
+}
+
+impl LiveScope {
+    pub fn enter() -> Self {
+        PASS.fetch_add(1, Ordering::Relaxed);
+        SERVED_STALE.with(|stale| stale.set(false));
+        Self {
+            previous: LIVE.with(|live| live.replace(true)),
+        }
+    }
+
+    // whether anything swept inside the scope was answered with an outdated
+    // tessellation, in which case the caller should evaluate again once
+    // jobs_in_flight() drains (or MAX_STALENESS passes) outside a scope
+    pub fn finish(self) -> bool {
+        SERVED_STALE.with(|stale| stale.replace(false))
+    }
+}
+
+impl Drop for LiveScope {
+    fn drop(&mut self) {
+        LIVE.with(|live| live.set(self.previous));
+    }
+}
+
+pub fn jobs_in_flight() -> usize {
+    POOL.get().map_or(0, |pool| {
+        let state = pool.state.lock().unwrap();
+        state.queue.len() + state.running
+    })
+}
+
+pub(super) fn tessellate(
+    contours: Vec<Vec<Float3>>,
+    normal: Float3,
+    normalize_input: bool,
+) -> Result<(Vec<Lin>, Vec<Tri>), ExecutorError> {
+    let vertex_count: usize = contours.iter().map(Vec::len).sum();
+    if vertex_count < LIVE_MIN_VERTICES {
+        return sweep_planar_loops(&contours, normal, normalize_input);
+    }
+
+    let input = Input {
+        contours,
+        normal,
+        normalize_input,
+    };
+    let key = exact_key(&input);
+    let layout = layout_key(&input);
+    let (centroid, radius) = bounds(&input.contours);
+    let cache = CACHE.get_or_init(|| Mutex::new(SurfaceCache::default()));
+    if let Some(surface) = cache.lock().unwrap().exact(key, &input) {
+        return Ok(clone_surface(&surface));
+    }
+
+    if LIVE.with(Cell::get) {
+        let stale = cache
+            .lock()
+            .unwrap()
+            .nearest(layout, centroid, radius)
+            .filter(|entry| entry.fresh_at.elapsed() < MAX_STALENESS)
+            .map(|entry| Arc::clone(&entry.surface));
+        if let Some(surface) = stale {
+            pool().submit(Job {
+                key,
+                layout,
+                centroid,
+                radius,
+                pass: PASS.load(Ordering::Relaxed),
+                input,
+            });
+            SERVED_STALE.with(|served| served.set(true));
+            return Ok(clone_surface(&surface));
+        }
+    }
+
+    let surface = sweep_planar_loops(&input.contours, normal, normalize_input)?;
+    cache.lock().unwrap().insert(
+        key,
+        input,
+        layout,
+        centroid,
+        radius,
+        Arc::new(surface.clone()),
+    );
+    Ok(surface)
+}
+
+fn clone_surface(surface: &Surface) -> (Vec<Lin>, Vec<Tri>) {
+    (surface.0.clone(), surface.1.clone())
+}
+
+// everything a sweep's result depends on
+struct Input {
+    contours: Vec<Vec<Float3>>,
+    normal: Float3,
+    normalize_input: bool,
+}
+
+impl Input {
+    // bitwise, like the key, so a hit is the same sweep and not just a hash
+    // collision
+    fn matches(&self, other: &Input) -> bool {
+        let bits = |point: &Float3| point.to_array().map(f32::to_bits);
+        self.normalize_input == other.normalize_input
+            && bits(&self.normal) == bits(&other.normal)
+            && self.contours.len() == other.contours.len()
+            && self.contours.iter().zip(&other.contours).all(|(lhs, rhs)| {
+                lhs.len() == rhs.len() && lhs.iter().zip(rhs).all(|(l, r)| bits(l) == bits(r))
+            })
+    }
+}
+
+fn exact_key(input: &Input) -> u64 {
+    let mut hasher = DefaultHasher::new();
+    input.normalize_input.hash(&mut hasher);
+    input.normal.to_array().map(f32::to_bits).hash(&mut hasher);
+    for contour in &input.contours {
+        contour.len().hash(&mut hasher);
+        for point in contour {
+            point.to_array().map(f32::to_bits).hash(&mut hasher);
+        }
+    }
+    hasher.finish()
+}
+
+// what stays fixed while a slider moves a shape around
+fn layout_key(input: &Input) -> u64 {
+    let mut hasher = DefaultHasher::new();
+    input.normalize_input.hash(&mut hasher);
+    input.normal.to_array().map(f32::to_bits).hash(&mut hasher);
+    for contour in &input.contours {
+        contour.len().hash(&mut hasher);
+    }
+    hasher.finish()
+}
+
+// centroid and the largest distance of any point from it
+fn bounds(contours: &[Vec<Float3>]) -> (Float3, f32) {
+    let count: usize = contours.iter().map(Vec::len).sum();
+    let centroid = contours
+        .iter()
+        .flatten()
+        .fold(Float3::ZERO, |sum, &point| sum + point)
+        / count.max(1) as f32;
+    let radius = contours
+        .iter()
+        .flatten()
+        .map(|&point| (point - centroid).len())
+        .fold(0.0, f32::max);
+    (centroid, radius)
+}
+
+struct LayoutEntry {
+    centroid: Float3,
+    radius: f32,
+    surface: Surface,
+    fresh_at: Instant,
+}
+
+struct ExactEntry {
+    input: Input,
+    surface: Surface,
+    used: u64,
+}
+
+struct LayoutSlot {
+    entries: VecDeque<LayoutEntry>,
+    used: u64,
+}
+
+// both maps evict their least recently used entry when full, so a scene with
+// more large shapes than fit keeps its busiest ones instead of starting over
+#[derive(Default)]
+struct SurfaceCache {
+    exact: HashMap<u64, ExactEntry>,
+    by_layout: HashMap<u64, LayoutSlot>,
+    clock: u64,
+}
+
+impl SurfaceCache {
+    fn tick(&mut self) -> u64 {
+        self.clock += 1;
+        self.clock
+    }
+
+    fn exact(&mut self, key: u64, input: &Input) -> Option<Surface> {
+        let used = self.tick();
+        let entry = self
+            .exact
+            .get_mut(&key)
+            .filter(|entry| entry.input.matches(input))?;
+        entry.used = used;
+        Some(Arc::clone(&entry.surface))
+    }
+
+    // the entry most likely to be this same shape a moment ago; another shape
+    // that merely shares the layout is too far off to stand in for it
+    fn nearest(&mut self, layout: u64, centroid: Float3, radius: f32) -> Option<&LayoutEntry> {
+        let used = self.tick();
+        let drift =
+            |entry: &LayoutEntry| (entry.centroid - centroid).len() + (entry.radius - radius).abs();
+        let slot = self.by_layout.get_mut(&layout)?;
+        let entry = slot
+            .entries
+            .iter()
+            .min_by(|lhs, rhs| drift(lhs).total_cmp(&drift(rhs)))
+            .filter(|entry| drift(entry) <= MAX_STALE_DRIFT * radius)?;
+        slot.used = used;
+        Some(entry)
+    }
+
+    fn insert(
+        &mut self,
+        key: u64,
+        input: Input,
+        layout: u64,
+        centroid: Float3,
+        radius: f32,
+        surface: Surface,
+    ) {
+        let used = self.tick();
+        if self.exact.len() >= EXACT_CACHE_CAPACITY && !self.exact.contains_key(&key) {
+            evict_least_recent(&mut self.exact, |entry| entry.used);
+        }
+        if self.by_layout.len() >= LAYOUT_CACHE_CAPACITY && !self.by_layout.contains_key(&layout) {
+            evict_least_recent(&mut self.by_layout, |slot| slot.used);
+        }
+        self.exact.insert(
+            key,
+            ExactEntry {
+                input,
+                surface: Arc::clone(&surface),
+                used,
+            },
+        );
+
+        let slot = self.by_layout.entry(layout).or_insert_with(|| LayoutSlot {
+            entries: VecDeque::new(),
+            used,
+        });
+        slot.used = used;
+        let entries = &mut slot.entries;
+        // a shape that moved replaces its own previous entry rather than
+        // crowding out other shapes with the same layout
+        let previous = entries
+            .iter()
+            .enumerate()
+            .min_by(|(_, lhs), (_, rhs)| {
+                (lhs.centroid - centroid)
+                    .len_sq()
+                    .total_cmp(&(rhs.centroid - centroid).len_sq())
+            })
+            .map(|(idx, _)| idx);
+        if entries.len() >= ENTRIES_PER_LAYOUT
+            && let Some(idx) = previous
+        {
+            entries.remove(idx);
+        }
+        entries.push_back(LayoutEntry {
+            centroid,
+            radius,
+            surface,
+            fresh_at: Instant::now(),
+        });
+    }
+}
+
+// a linear scan, which at these capacities costs less than keeping an order
+fn evict_least_recent<V>(map: &mut HashMap<u64, V>, used: impl Fn(&V) -> u64) {
+    if let Some(key) = map
+        .iter()
+        .min_by_key(|(_, value)| used(value))
+        .map(|(&key, _)| key)
+    {
+        map.remove(&key);
+    }
+}
+
+struct Job {
+    key: u64,
+    layout: u64,
+    centroid: Float3,
+    radius: f32,
+    pass: u64,
+    input: Input,
+}
+
+#[derive(Default)]
+struct PoolState {
+    queue: Vec<Job>,
+    running: usize,
+}
+
+struct Pool {
+    state: Mutex<PoolState>,
+    ready: Condvar,
+}
+
+fn pool() -> &'static Arc<Pool> {
+    POOL.get_or_init(|| {
+        let pool = Arc::new(Pool {
+            state: Mutex::new(PoolState::default()),
+            ready: Condvar::new(),
+        });
+        let workers = thread::available_parallelism()
+            .map_or(1, NonZeroUsize::get)
+            .saturating_sub(1)
+            .clamp(1, MAX_POOL_WORKERS);
+        for idx in 0..workers {
+            let pool = Arc::clone(&pool);
+            thread::Builder::new()
+                .name(format!("live-tessellation-{idx}"))
+                .spawn(move || pool.work())
+                .expect("failed to spawn tessellation worker");
+        }
+        pool
+    })
+}
+
+impl Pool {
+    fn submit(&self, job: Job) {
+        let mut state = self.state.lock().unwrap();
+        if state
+            .queue
+            .iter()
+            .any(|queued| queued.key == job.key && queued.input.matches(&job.input))
+        {
+            return;
+        }
+        state.queue.push(job);
+        self.ready.notify_one();
+    }
+
+    fn work(&self) {
+        loop {
+            let job = {
+                let mut state = self.state.lock().unwrap();
+                loop {
+                    // newest first; anything queued before the latest scope
+                    // was entered has been superseded
+                    let latest = PASS.load(Ordering::Relaxed);
+                    state.queue.retain(|job| job.pass >= latest);
+                    if let Some(job) = state.queue.pop() {
+                        state.running += 1;
+                        break job;
+                    }
+                    state = self.ready.wait(state).unwrap();
+                }
+            };
+
+            let Job {
+                key,
+                layout,
+                centroid,
+                radius,
+                input,
+                ..
+            } = job;
+            // failures are left for the runtime thread to hit and report
+            if let Ok(surface) =
+                sweep_planar_loops(&input.contours, input.normal, input.normalize_input)
+            {
+                CACHE
+                    .get_or_init(|| Mutex::new(SurfaceCache::default()))
+                    .lock()
+                    .unwrap()
+                    .insert(key, input, layout, centroid, radius, Arc::new(surface));
+            }
+            self.state.lock().unwrap().running -= 1;
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn polygon(center_x: f32, points: usize) -> Vec<Float3> {
+        (0..points)
+            .map(|idx| {
+                let theta = idx as f32 * std::f32::consts::TAU / points as f32;
+                Float3::new(center_x + theta.cos(), theta.sin(), 0.0)
+            })
+            .collect()
+    }
+
+    // scopes supersede each other's jobs across threads, so tests that open
+    // them run one at a time
+    static SERIAL: Mutex<()> = Mutex::new(());
+
+    fn settle() {
+        let deadline = Instant::now() + Duration::from_secs(10);
+        while jobs_in_flight() > 0 && Instant::now() < deadline {
+            thread::sleep(Duration::from_millis(1));
+        }
+    }
+
+    #[test]
+    fn live_scope_serves_the_previous_shape_until_the_pool_catches_up() {
+        let _serial = SERIAL.lock().unwrap_or_else(|err| err.into_inner());
+        let scope = LiveScope::enter();
+        tessellate(vec![polygon(-50.0, 8)], Float3::Z, false).unwrap();
+        assert!(!scope.finish());
+
+        let first = polygon(100.0, LIVE_MIN_VERTICES);
+        let (_, settled) = tessellate(vec![first], Float3::Z, false).unwrap();
+
+        let moved = polygon(100.25, LIVE_MIN_VERTICES);
+        let scope = LiveScope::enter();
+        let (_, live) = tessellate(vec![moved.clone()], Float3::Z, false).unwrap();
+        assert!(scope.finish());
+        assert_eq!(live.len(), settled.len());
+        assert_eq!(live[0].a.pos, settled[0].a.pos);
+
+        settle();
+        let scope = LiveScope::enter();
+        let (_, fresh) = tessellate(vec![moved], Float3::Z, false).unwrap();
+        assert!(!scope.finish());
+        assert!(fresh.iter().all(|tri| tri.a.pos.x > 99.2));
+
+        // outside a scope nothing is served stale
+        let (_, in_place) =
+            tessellate(vec![polygon(101.0, LIVE_MIN_VERTICES)], Float3::Z, false).unwrap();
+        assert!(in_place.iter().all(|tri| tri.a.pos.x > 99.9));
+    }
+
+    #[test]
+    fn shapes_sharing_a_layout_never_stand_in_for_each_other() {
+        let _serial = SERIAL.lock().unwrap_or_else(|err| err.into_inner());
+        let points = LIVE_MIN_VERTICES + 1;
+        tessellate(vec![polygon(-300.0, points)], Float3::Z, false).unwrap();
+        tessellate(vec![polygon(300.0, points)], Float3::Z, false).unwrap();
+
+        // each shape is drawn where it is, not where the other one was
+        for center_x in [-300.0, 300.0] {
+            let scope = LiveScope::enter();
+            let (_, live) =
+                tessellate(vec![polygon(center_x + 0.25, points)], Float3::Z, false).unwrap();
+            assert!(scope.finish());
+            assert!(live.iter().all(|tri| (tri.a.pos.x - center_x).abs() <= 1.0));
+            settle();
+        }
+
+        // a third shape with the same layout, far from both, is swept in place
+        let scope = LiveScope::enter();
+        let (_, third) = tessellate(vec![polygon(0.0, points)], Float3::Z, false).unwrap();
+        assert!(!scope.finish());
+        assert!(third.iter().all(|tri| tri.a.pos.x.abs() <= 1.0));
+
+        // and so is the same outline facing the other way
+        let scope = LiveScope::enter();
+        tessellate(vec![polygon(300.5, points)], -Float3::Z, false).unwrap();
+        assert!(!scope.finish());
+    }
+
+    #[test]
+    fn full_cache_evicts_its_least_recent_shape_and_checks_keys_on_a_hit() {
+        let input = |center_x: f32| Input {
+            contours: vec![polygon(center_x, 8)],
+            normal: Float3::Z,
+            normalize_input: false,
+        };
+        let surface = || Arc::new((Vec::new(), Vec::new()));
+        let mut cache = SurfaceCache::default();
+        for idx in 0..EXACT_CACHE_CAPACITY as u64 {
+            let shape = input(idx as f32);
+            let (centroid, radius) = bounds(&shape.contours);
+            cache.insert(idx, shape, idx, centroid, radius, surface());
+        }
+        // touching the oldest shape makes the second one the next to go
+        assert!(cache.exact(0, &input(0.0)).is_some());
+        let shape = input(-1.0);
+        let (centroid, radius) = bounds(&shape.contours);
+        cache.insert(u64::MAX, shape, u64::MAX, centroid, radius, surface());
+        assert_eq!(cache.exact.len(), EXACT_CACHE_CAPACITY);
+        assert!(cache.exact(0, &input(0.0)).is_some());
+        assert!(cache.exact(1, &input(1.0)).is_none());
+        assert!((2..EXACT_CACHE_CAPACITY as u64).all(|idx| cache.exact.contains_key(&idx)));
+
+        // a different shape whose key collides is a miss, not a stand-in
+        assert!(cache.exact(2, &input(3.0)).is_none());
+    }
+}
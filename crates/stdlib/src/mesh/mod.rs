@@ -1,5 +1,6 @@
 mod constructors;
 mod graphs;
 pub(crate) mod helpers;
+pub mod live_tessellation;
 mod ops;
 mod queries;
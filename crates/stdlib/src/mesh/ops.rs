@@ -1326,19 +1326,22 @@ pub async fn op_subset_map(
 pub async fn op_uprank(executor: &mut Executor, stack_idx: usize) -> Result<Value, ExecutorError> {
     let mut tree = read_mesh_tree_arg(executor, stack_idx, -2, "target").await?;
     let filter = read_optional_tag_filter(executor, stack_idx, -1, "filter")?;
-    let mut tessellation_error = None;
-    tree.for_each_filtered(executor, filter.as_ref(), &mut |mesh| {
-        match uprank_mesh(mesh) {
-            Ok(Some(upranked)) => *mesh = upranked,
-            Ok(None) => {}
-            Err(err) => tessellation_error = Some(err),
+    let selected = tree.filtered_leaves(executor, filter.as_ref()).await?;
+    let leaves: Vec<_> = tree
+        .iter()
+        .zip(&selected)
+        .filter_map(|(mesh, &keep)| keep.then_some(mesh))
+        .collect();
+    let mut upranked = uprank_meshes(&leaves)?.into_iter();
+    let mut selected = selected.into_iter();
+    tree.for_each_leaf(&mut |arc| {
+        if selected.next() == Some(true)
+            && let Some(Some(mut upranked)) = upranked.next()
+        {
+            upranked.bump_version();
+            *arc = Arc::new(upranked);
         }
-        mesh.debug_assert_consistent_topology();
-    })
-    .await?;
-    if let Some(err) = tessellation_error {
-        return Err(err);
-    }
+    });
     Ok(tree.into_value())
 }
 
@@ -1,10 +1,14 @@
-use std::{collections::HashSet, sync::Arc};
+use std::{
+    collections::{HashMap, HashSet},
+    sync::{Arc, Mutex, OnceLock},
+};
 
 use executor::{error::ExecutorError, executor::Executor, value::Value};
 use geo::{
     mesh::{Dot, Lin, Mesh, Tri},
     simd::Float3,
 };
+use libtess2::PointLocator;
 use stdlib_macros::stdlib_func;
 
 use super::helpers::*;
@@ -365,30 +369,108 @@ pub async fn mesh_contains(
     let tree = read_mesh_tree_arg(executor, stack_idx, -2, "mesh").await?;
     let point = read_float3(executor, stack_idx, -1, "point")?;
     let contains = tree.iter().any(|mesh| {
-        mesh.tris.iter().any(|tri| {
-            let normal = triangle_normal(tri.a.pos, tri.b.pos, tri.c.pos);
-            let area = normal
-                .dot((tri.b.pos - tri.a.pos).cross(tri.c.pos - tri.a.pos))
-                .abs();
-            let a = normal
-                .dot((tri.c.pos - tri.b.pos).cross(point - tri.b.pos))
-                .abs();
-            let b = normal
-                .dot((tri.a.pos - tri.c.pos).cross(point - tri.c.pos))
-                .abs();
-            let c = normal
-                .dot((tri.b.pos - tri.a.pos).cross(point - tri.a.pos))
-                .abs();
-            (a + b + c - area).abs() < 1e-3
-        }) || mesh
-            .lins
-            .iter()
-            .any(|lin| segment_distance(lin.a.pos, lin.b.pos, point) < 1e-4)
+        let tri_hit = match cached_point_locator(mesh) {
+            Some(locator) => locator
+                .candidates(point)
+                .any(|tri_idx| tri_contains_point(&mesh.tris[tri_idx], point)),
+            None => mesh.tris.iter().any(|tri| tri_contains_point(tri, point)),
+        };
+        tri_hit
+            || mesh
+                .lins
+                .iter()
+                .any(|lin| segment_distance(lin.a.pos, lin.b.pos, point) < 1e-4)
             || mesh.dots.iter().any(|dot| (dot.pos - point).len() < 1e-4)
     });
     Ok(Value::Integer(contains as i64))
 }
 
+const TRI_CONTAINS_EPSILON: f32 = 1e-3;
+const POINT_LOCATOR_MIN_TRIS: usize = 64;
+const POINT_LOCATOR_CACHE_CAPACITY: usize = 256;
+
+// keyed by mesh version, which changes on every mutation, so entries never go
+// stale; None records meshes that are not planar enough to index
+static POINT_LOCATORS: OnceLock<Mutex<HashMap<u64, Option<Arc<PointLocator>>>>> = OnceLock::new();
+
+fn tri_contains_point(tri: &Tri, point: Float3) -> bool {
+    let normal = triangle_normal(tri.a.pos, tri.b.pos, tri.c.pos);
+    let area = normal
+        .dot((tri.b.pos - tri.a.pos).cross(tri.c.pos - tri.a.pos))
+        .abs();
+    let a = normal
+        .dot((tri.c.pos - tri.b.pos).cross(point - tri.b.pos))
+        .abs();
+    let b = normal
+        .dot((tri.a.pos - tri.c.pos).cross(point - tri.c.pos))
+        .abs();
+    let c = normal
+        .dot((tri.b.pos - tri.a.pos).cross(point - tri.a.pos))
+        .abs();
+    (a + b + c - area).abs() < TRI_CONTAINS_EPSILON
+}
+
+fn cached_point_locator(mesh: &Mesh) -> Option<Arc<PointLocator>> {
+    if mesh.tris.len() < POINT_LOCATOR_MIN_TRIS {
+        return None;
+    }
+    let cache = POINT_LOCATORS.get_or_init(|| Mutex::new(HashMap::new()));
+    if let Some(entry) = cache.lock().unwrap().get(&mesh.version()) {
+        return entry.clone();
+    }
+
+    let locator = planar_point_locator(mesh).map(Arc::new);
+    let mut cache = cache.lock().unwrap();
+    if cache.len() >= POINT_LOCATOR_CACHE_CAPACITY {
+        cache.clear();
+    }
+    cache.insert(mesh.version(), locator.clone());
+    locator
+}
+
+// tri_contains_point projects along each triangle's own normal, so the
+// locator's shared projection only agrees with it when every normal is
+// parallel; degenerate triangles keep the linear scan
+fn planar_point_locator(mesh: &Mesh) -> Option<PointLocator> {
+    let first = &mesh.tris[0];
+    let normal = triangle_normal(first.a.pos, first.b.pos, first.c.pos);
+    // tri_contains_point accepts a point whose negative barycentric weights
+    // sum to s when 2 * s * |cross| < TRI_CONTAINS_EPSILON, and such a point
+    // is at most s times the longest edge from the triangle. so this pad
+    // covers everything it accepts, obtuse slivers included
+    let mut tolerances = Vec::with_capacity(mesh.tris.len());
+    for tri in &mesh.tris {
+        let cross = (tri.b.pos - tri.a.pos).cross(tri.c.pos - tri.a.pos);
+        if cross.len_sq() <= 1e-12 || cross.normalize().cross(normal).len_sq() > 1e-8 {
+            return None;
+        }
+        let longest_edge = [
+            (tri.a.pos, tri.b.pos),
+            (tri.b.pos, tri.c.pos),
+            (tri.c.pos, tri.a.pos),
+        ]
+        .into_iter()
+        .map(|(from, to)| (to - from).len())
+        .fold(0.0, f32::max);
+        tolerances.push(TRI_CONTAINS_EPSILON * longest_edge / cross.len());
+    }
+
+    let vertices: Vec<_> = mesh
+        .tris
+        .iter()
+        .flat_map(|tri| [tri.a.pos, tri.b.pos, tri.c.pos])
+        .collect();
+    let triangles: Vec<_> = (0..mesh.tris.len())
+        .map(|idx| [3 * idx, 3 * idx + 1, 3 * idx + 2])
+        .collect();
+    Some(PointLocator::with_tolerances(
+        &vertices,
+        &triangles,
+        normal,
+        &tolerances,
+    ))
+}
+
 #[stdlib_func]
 pub async fn mesh_dist(executor: &mut Executor, stack_idx: usize) -> Result<Value, ExecutorError> {
     fn triangle_distance(a: Float3, b: Float3, c: Float3, point: Float3) -> f32 {
@@ -541,11 +623,79 @@ pub async fn mesh_contour_separate(
 #[cfg(test)]
 mod tests {
     use geo::{
-        mesh::{Dot, Lin, LinVertex, Mesh, Uniforms},
-        simd::{Float3, Float4},
+        mesh::{Dot, Lin, LinVertex, Mesh, Tri, TriVertex, Uniforms},
+        simd::{Float2, Float3, Float4},
     };
 
-    use super::{append_mesh_into, mesh_ref};
+    use super::{
+        POINT_LOCATOR_MIN_TRIS, append_mesh_into, mesh_ref, planar_point_locator,
+        tri_contains_point,
+    };
+
+    fn tri(a: Float3, b: Float3, c: Float3) -> Tri {
+        let vertex = |pos| TriVertex {
+            pos,
+            col: Float4::ONE,
+            uv: Float2::ZERO,
+        };
+        Tri {
+            a: vertex(a),
+            b: vertex(b),
+            c: vertex(c),
+            ab: -1,
+            bc: -1,
+            ca: -1,
+            is_dom_sib: true,
+        }
+    }
+
+    #[test]
+    fn locator_pads_obtuse_slivers_as_far_as_the_linear_scan_reaches() {
+        let mut tris = vec![tri(
+            Float3::new(0.0, 0.0, 0.0),
+            Float3::new(1.0, 0.0, 0.0),
+            Float3::new(-10.0, 0.01, 0.0),
+        )];
+        // small triangles off to the right, so the grid's cells are narrower
+        // than the sliver's reach past its corner
+        tris.extend((0..POINT_LOCATOR_MIN_TRIS).map(|idx| {
+            let x = idx as f32 * 0.28 + 2.0;
+            tri(
+                Float3::new(x, -0.5, 0.0),
+                Float3::new(x + 0.2, -0.5, 0.0),
+                Float3::new(x, -0.4, 0.0),
+            )
+        }));
+        let mesh = Mesh {
+            dots: vec![],
+            lins: vec![],
+            tris,
+            uniform: Uniforms::default(),
+            tag: vec![],
+            version: Mesh::fresh_version(),
+        };
+        let locator = planar_point_locator(&mesh).unwrap();
+
+        // past the sliver's far corner, within the area test's slack
+        let beyond = Float3::new(1.44, -0.0004, 0.0);
+        let points = (0..400)
+            .map(|idx| {
+                Float3::new(
+                    (idx % 40) as f32 * 0.05 - 0.5,
+                    (idx / 40) as f32 * 0.0002 - 0.001,
+                    0.0,
+                )
+            })
+            .chain([beyond]);
+        for point in points {
+            let scanned = mesh.tris.iter().any(|tri| tri_contains_point(tri, point));
+            let located = locator
+                .candidates(point)
+                .any(|tri_idx| tri_contains_point(&mesh.tris[tri_idx], point));
+            assert_eq!(located, scanned, "{point:?}");
+        }
+        assert!(mesh.tris.iter().any(|tri| tri_contains_point(tri, beyond)));
+    }
 
     #[test]
     fn append_mesh_remaps_negative_dot_inverse_refs() {